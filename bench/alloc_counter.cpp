@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "alloc_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+unsigned long long wsrep_bench::allocations;
+unsigned long long wsrep_bench::allocated_bytes;
+
+void* operator new(std::size_t size)
+{
+    ++wsrep_bench::allocations;
+    wsrep_bench::allocated_bytes += size;
+    void* ret(std::malloc(size ? size : 1));
+    if (ret == 0) throw std::bad_alloc();
+    return ret;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) throw()
+{
+    ++wsrep_bench::allocations;
+    wsrep_bench::allocated_bytes += size;
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) throw()
+{
+    std::free(ptr);
+}
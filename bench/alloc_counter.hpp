@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file alloc_counter.hpp
+ *
+ * Counters maintained by the global operator new replacement in
+ * alloc_counter.cpp. The replacement is kept in a separate translation
+ * unit so that it is not inlined into the callers, where the compiler
+ * would see memory from operator new released with free().
+ *
+ * The benchmarks are single threaded, so plain counters are enough.
+ */
+
+#ifndef WSREP_BENCH_ALLOC_COUNTER_HPP
+#define WSREP_BENCH_ALLOC_COUNTER_HPP
+
+namespace wsrep_bench
+{
+    /** Number of allocations done via global operator new. */
+    extern unsigned long long allocations;
+    /** Number of bytes allocated via global operator new. */
+    extern unsigned long long allocated_bytes;
+}
+
+#endif // WSREP_BENCH_ALLOC_COUNTER_HPP
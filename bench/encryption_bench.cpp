@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file encryption_bench.cpp
+ *
+ * Benchmarks for the dbsim reference encryption service. The calls
+ * are made as the provider makes them through encrypt_cb.
+ *
+ * Each benchmark prints one JSON object per line into stdout:
+ *
+ * {"name": "...", "iterations": N, "ns_per_op": X, "mb_per_sec": Y}
+ *
+ * Benchmarks:
+ *
+ * pooled_<size>  One operation is a stream of a single buffer, cipher
+ *                contexts are reused from the pool
+ * fresh_<size>   As pooled, but a cipher context is created for each
+ *                stream, as a naive implementation would do
+ * stream_<size>  One operation is a buffer of a 64MiB stream
+ * rotate_<size>  As pooled, with a key change every 1000 streams
+ *
+ * Commandline arguments:
+ *
+ * --bytes=<int>      Number of bytes to encrypt per benchmark
+ * --filter=<string>  Run only benchmarks whose name contains <string>
+ */
+
+#include "db_encryption.hpp"
+
+#include "wsrep/exception.hpp"
+#include "wsrep/logger.hpp"
+
+#include <openssl/evp.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    size_t bytes(size_t(1) << 26);
+    std::string filter;
+
+    // Encryption service which creates cipher context for each stream.
+    class fresh_encryption : public wsrep::encryption_service
+    {
+    public:
+        int do_crypt(void** ctx,
+                     wsrep::const_buffer& key,
+                     const char (*iv)[32],
+                     wsrep::const_buffer& input,
+                     void* output,
+                     bool,
+                     bool last) override
+        {
+            EVP_CIPHER_CTX* evp(static_cast<EVP_CIPHER_CTX*>(*ctx));
+            if (evp == nullptr)
+            {
+                evp = EVP_CIPHER_CTX_new();
+                EVP_EncryptInit_ex(
+                    evp, EVP_aes_256_ctr(), nullptr,
+                    reinterpret_cast<const unsigned char*>(key.data()),
+                    reinterpret_cast<const unsigned char*>(*iv));
+                *ctx = evp;
+            }
+            int ret(0);
+            EVP_EncryptUpdate(evp, static_cast<unsigned char*>(output), &ret,
+                              reinterpret_cast<const unsigned char*>(
+                                  input.data()),
+                              int(input.size()));
+            if (last)
+            {
+                EVP_CIPHER_CTX_free(evp);
+                *ctx = nullptr;
+            }
+            return ret;
+        }
+        bool encryption_enabled() override { return true; }
+    };
+
+    struct crypt_args
+    {
+        crypt_args()
+            : ctx()
+            , key_data(db::encryption::generate_key())
+            , key(key_data.data(), key_data.size())
+            , iv()
+        {
+            std::memset(iv, 0x5a, sizeof(iv));
+        }
+        void* ctx;
+        std::vector<unsigned char> key_data;
+        wsrep::const_buffer key;
+        char iv[32];
+    };
+
+    int crypt(wsrep::encryption_service& service, crypt_args& args,
+              const std::vector<char>& in, std::vector<char>& out,
+              size_t offset, size_t size, bool last)
+    {
+        wsrep::const_buffer input(in.data() + offset, size);
+        return service.do_crypt(&args.ctx, args.key, &args.iv, input,
+                                out.data() + offset, true, last);
+    }
+
+    void report(const std::string& name, size_t ops, size_t size,
+                std::chrono::steady_clock::duration duration)
+    {
+        const double secs(std::chrono::duration<double>(duration).count());
+        std::cout << "{\"name\": \"" << name << "\""
+                  << ", \"iterations\": " << ops
+                  << ", \"ns_per_op\": "
+                  << secs * 1e9 / static_cast<double>(ops)
+                  << ", \"mb_per_sec\": "
+                  << static_cast<double>(ops * size) / (1 << 20) / secs
+                  << "}" << std::endl;
+    }
+
+    // Encrypt each buffer as a separate stream. If rotate is
+    // non-zero, the key is changed after every rotate streams.
+    void streams(const std::string& name, wsrep::encryption_service& service,
+                 size_t size, size_t rotate)
+    {
+        const size_t ops(std::max(bytes / size, size_t(1)));
+        std::vector<char> in(size, 'x');
+        std::vector<char> out(size);
+        crypt_args args;
+        const auto start(std::chrono::steady_clock::now());
+        for (size_t i(0); i < ops; ++i)
+        {
+            if (rotate && i % rotate == rotate - 1)
+            {
+                args.key_data[0]++;
+            }
+            if (crypt(service, args, in, out, 0, size, true) != int(size))
+            {
+                throw wsrep::runtime_error("Encryption failed");
+            }
+        }
+        report(name, ops, size, std::chrono::steady_clock::now() - start);
+    }
+
+    // Encrypt 64MiB stream in buffers of size.
+    void stream(const std::string& name, size_t size)
+    {
+        db::encryption service;
+        const size_t stream_size(size_t(1) << 26);
+        const size_t buffers(stream_size / size);
+        std::vector<char> in(stream_size, 'x');
+        std::vector<char> out(stream_size);
+        const size_t ops(std::max(bytes / size, buffers));
+        crypt_args args;
+        const auto start(std::chrono::steady_clock::now());
+        for (size_t i(0); i < ops; ++i)
+        {
+            const size_t n(i % buffers);
+            if (crypt(service, args, in, out, n * size, size,
+                      n == buffers - 1) != int(size))
+            {
+                throw wsrep::runtime_error("Encryption failed");
+            }
+        }
+        report(name, ops, size, std::chrono::steady_clock::now() - start);
+    }
+
+    // Check that the pooled contexts produce the same output as
+    // fresh contexts, also when the stream is split into buffers.
+    void verify()
+    {
+        db::encryption pooled;
+        fresh_encryption fresh;
+        std::vector<char> in(100000);
+        for (size_t i(0); i < in.size(); ++i) in[i] = char(i * 7);
+        std::vector<char> expected(in.size());
+        std::vector<char> out(in.size());
+        crypt_args args;
+        crypt(fresh, args, in, expected, 0, in.size(), true);
+        for (int round(0); round < 2; ++round)
+        {
+            size_t offset(0);
+            for (size_t size(1); offset < in.size(); size = size * 3 + 1)
+            {
+                size = std::min(size, in.size() - offset);
+                crypt(pooled, args, in, out, offset, size,
+                      offset + size == in.size());
+                offset += size;
+            }
+            if (out != expected)
+            {
+                throw wsrep::runtime_error("Encryption verification failed");
+            }
+        }
+        // Decryption with the same key and IV restores the input.
+        crypt(pooled, args, expected, out, 0, in.size(), true);
+        if (out != in || pooled.contexts_created() != 1)
+        {
+            throw wsrep::runtime_error("Decryption verification failed");
+        }
+    }
+
+    void run(const std::string& name, size_t size)
+    {
+        if (name.find(filter) == std::string::npos) return;
+        if (name.compare(0, 6, "pooled") == 0)
+        {
+            db::encryption service;
+            streams(name, service, size, 0);
+        }
+        else if (name.compare(0, 5, "fresh") == 0)
+        {
+            fresh_encryption service;
+            streams(name, service, size, 0);
+        }
+        else if (name.compare(0, 6, "rotate") == 0)
+        {
+            db::encryption service;
+            streams(name, service, size, 1000);
+        }
+        else
+        {
+            stream(name, size);
+        }
+    }
+
+    void discard_log(wsrep::log::level, const char*, const char*) { }
+
+    bool parse_arg(const std::string& arg)
+    {
+        const std::string::size_type delim(arg.find('='));
+        const std::string parm(arg.substr(0, delim));
+        const std::string val(delim == std::string::npos ?
+                              "" : arg.substr(delim + 1));
+        if (parm == "--bytes")
+        {
+            bytes = std::strtoul(val.c_str(), 0, 10);
+            return (bytes > 0);
+        }
+        else if (parm == "--filter")
+        {
+            filter = val;
+            return true;
+        }
+        std::cerr << "Error: Unknown argument " << arg << std::endl;
+        return false;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    for (int i(1); i < argc; ++i)
+    {
+        if (parse_arg(argv[i]) == false)
+        {
+            return 1;
+        }
+    }
+    wsrep::log::logger_fn(discard_log);
+    try
+    {
+        verify();
+        const char* benchmarks[] = { "pooled", "fresh", "stream", "rotate" };
+        const struct { const char* suffix; size_t size; } sizes[] =
+        {
+            { "64", 64 },
+            { "1k", 1 << 10 },
+            { "16k", 1 << 14 },
+            { "256k", 1 << 18 },
+            { "4m", 1 << 22 }
+        };
+        for (auto b : benchmarks)
+        {
+            for (const auto& s : sizes)
+            {
+                run(std::string(b) + "_" + s.suffix, s.size);
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
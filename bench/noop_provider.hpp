@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file noop_provider.hpp
+ *
+ * Provider which does no work besides assigning sequence numbers,
+ * so that benchmarks measure only the wsrep-lib side of the calls.
+ *
+ * Appended keys and data are copied into a write set buffer like
+ * a real provider does, except when appended with append_key_nocopy()
+ * or append_data_nocopy(). The number of copied bytes is available
+ * from bytes_copied().
+ */
+
+#ifndef WSREP_NOOP_PROVIDER_HPP
+#define WSREP_NOOP_PROVIDER_HPP
+
+#include "wsrep/provider.hpp"
+
+#include <vector>
+
+namespace wsrep
+{
+    class noop_provider : public wsrep::provider
+    {
+    public:
+        noop_provider(wsrep::server_state& server_state)
+            : provider(server_state)
+            , group_id_("1")
+            , server_id_("1")
+            , group_seqno_(0)
+            , write_set_()
+            , bytes_copied_(0)
+        { }
+
+        enum wsrep::provider::status
+        connect(const std::string&, const std::string&, const std::string&,
+                bool) WSREP_OVERRIDE
+        { return wsrep::provider::success; }
+        int disconnect() WSREP_OVERRIDE { return 0; }
+        int capabilities() const WSREP_OVERRIDE { return 0; }
+        int desync() WSREP_OVERRIDE { return 0; }
+        int resync() WSREP_OVERRIDE { return 0; }
+        wsrep::seqno pause() WSREP_OVERRIDE { return wsrep::seqno(0); }
+        int resume() WSREP_OVERRIDE { return 0; }
+        enum wsrep::provider::status run_applier(wsrep::high_priority_service*)
+            WSREP_OVERRIDE
+        { return wsrep::provider::success; }
+
+        int start_transaction(wsrep::ws_handle&) WSREP_OVERRIDE { return 0; }
+        enum wsrep::provider::status
+        assign_read_view(wsrep::ws_handle&, const wsrep::gtid*) WSREP_OVERRIDE
+        { return wsrep::provider::success; }
+        int append_key(wsrep::ws_handle&, const wsrep::key& key)
+            WSREP_OVERRIDE
+        {
+            for (size_t i(0); i < key.size(); ++i)
+            {
+                copy(key.key_parts()[i]);
+            }
+            return 0;
+        }
+        enum wsrep::provider::status
+        append_data(wsrep::ws_handle&, const wsrep::const_buffer& data)
+            WSREP_OVERRIDE
+        {
+            copy(data);
+            return wsrep::provider::success;
+        }
+        int append_key_nocopy(wsrep::ws_handle&, const wsrep::key&)
+            WSREP_OVERRIDE
+        { return 0; }
+        enum wsrep::provider::status
+        append_data_nocopy(wsrep::ws_handle&, const wsrep::const_buffer&)
+            WSREP_OVERRIDE
+        { return wsrep::provider::success; }
+
+        enum wsrep::provider::status
+        certify(wsrep::client_id client_id,
+                wsrep::ws_handle& ws_handle,
+                int flags,
+                wsrep::ws_meta& ws_meta,
+                const seq_cb_t* seq_cb) WSREP_OVERRIDE
+        {
+            ws_handle = wsrep::ws_handle(ws_handle.transaction_id(), this);
+            ws_meta = next_meta(ws_handle.transaction_id(), client_id, flags);
+            write_set_.clear();
+            if (seq_cb)
+            {
+                seq_cb->fn(seq_cb->ctx);
+            }
+            return wsrep::provider::success;
+        }
+
+        enum wsrep::provider::status bf_abort(wsrep::seqno,
+                                              wsrep::transaction_id,
+                                              wsrep::client_service&,
+                                              wsrep::seqno& victim_seqno)
+            WSREP_OVERRIDE
+        {
+            victim_seqno = wsrep::seqno::undefined();
+            return wsrep::provider::success;
+        }
+        enum wsrep::provider::status rollback(wsrep::transaction_id)
+            WSREP_OVERRIDE
+        {
+            write_set_.clear();
+            return wsrep::provider::success;
+        }
+        enum wsrep::provider::status
+        commit_order_enter(const wsrep::ws_handle&, const wsrep::ws_meta&)
+            WSREP_OVERRIDE
+        { return wsrep::provider::success; }
+        int commit_order_leave(const wsrep::ws_handle&, const wsrep::ws_meta&,
+                               const wsrep::mutable_buffer&) WSREP_OVERRIDE
+        { return 0; }
+        int release(wsrep::ws_handle&) WSREP_OVERRIDE { return 0; }
+        enum wsrep::provider::status replay(const wsrep::ws_handle&,
+                                            wsrep::high_priority_service*)
+            WSREP_OVERRIDE
+        { return wsrep::provider::error_not_implemented; }
+
+        enum wsrep::provider::status enter_toi(wsrep::client_id client_id,
+                                               const wsrep::key_array&,
+                                               const wsrep::const_buffer&,
+                                               wsrep::ws_meta& toi_meta,
+                                               int flags) WSREP_OVERRIDE
+        {
+            toi_meta = next_meta(wsrep::transaction_id::undefined(),
+                                 client_id, flags);
+            return wsrep::provider::success;
+        }
+        enum wsrep::provider::status leave_toi(wsrep::client_id,
+                                               const wsrep::ws_meta&,
+                                               const wsrep::mutable_buffer&)
+            WSREP_OVERRIDE
+        { return wsrep::provider::success; }
+
+        std::pair<wsrep::gtid, enum wsrep::provider::status>
+        causal_read(int) const WSREP_OVERRIDE
+        {
+            return std::make_pair(last_committed_gtid(),
+                                  wsrep::provider::success);
+        }
+        enum wsrep::provider::status wait_for_gtid(const wsrep::gtid&,
+                                                   int) const WSREP_OVERRIDE
+        { return wsrep::provider::success; }
+        wsrep::gtid last_committed_gtid() const WSREP_OVERRIDE
+        { return wsrep::gtid(group_id_, wsrep::seqno(group_seqno_)); }
+        enum wsrep::provider::status sst_sent(const wsrep::gtid&, int)
+            WSREP_OVERRIDE
+        { return wsrep::provider::success; }
+        enum wsrep::provider::status sst_received(const wsrep::gtid&, int)
+            WSREP_OVERRIDE
+        { return wsrep::provider::success; }
+        enum wsrep::provider::status enc_set_key(const wsrep::const_buffer&)
+            WSREP_OVERRIDE
+        { return wsrep::provider::success; }
+
+        std::vector<status_variable> status() const WSREP_OVERRIDE
+        { return std::vector<status_variable>(); }
+        void reset_status() WSREP_OVERRIDE { }
+        std::string options() const WSREP_OVERRIDE { return ""; }
+        enum wsrep::provider::status options(const std::string&)
+            WSREP_OVERRIDE
+        { return wsrep::provider::success; }
+        enum wsrep::provider::status set_node_isolation(enum node_isolation)
+            WSREP_OVERRIDE
+        { return wsrep::provider::error_not_implemented; }
+        std::string name() const WSREP_OVERRIDE { return "noop"; }
+        std::string version() const WSREP_OVERRIDE { return "0.0"; }
+        std::string vendor() const WSREP_OVERRIDE { return "noop"; }
+        void* native() const WSREP_OVERRIDE { return 0; }
+
+        /** Return ws_meta for the next sequence number. */
+        wsrep::ws_meta next_meta(wsrep::transaction_id transaction_id,
+                                 wsrep::client_id client_id,
+                                 int flags)
+        {
+            ++group_seqno_;
+            return wsrep::ws_meta(
+                wsrep::gtid(group_id_, wsrep::seqno(group_seqno_)),
+                wsrep::stid(server_id_, transaction_id, client_id),
+                wsrep::seqno(group_seqno_ - 1), flags);
+        }
+
+        const wsrep::id& server_id() const { return server_id_; }
+
+        /** Return the number of bytes copied into write sets. */
+        unsigned long long bytes_copied() const { return bytes_copied_; }
+    private:
+        void copy(const wsrep::const_buffer& buf)
+        {
+            write_set_.insert(write_set_.end(), buf.data(),
+                              buf.data() + buf.size());
+            bytes_copied_ += buf.size();
+        }
+
+        wsrep::id group_id_;
+        wsrep::id server_id_;
+        long long group_seqno_;
+        std::vector<char> write_set_;
+        unsigned long long bytes_copied_;
+    };
+}
+
+#endif // WSREP_NOOP_PROVIDER_HPP
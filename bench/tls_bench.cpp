@@ -0,0 +1,574 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tls_bench.hpp"
+
+#include "wsrep/exception.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    size_t iterations(10000);
+    size_t bytes(size_t(1) << 28);
+    bool tcp(false);
+    std::string filter;
+
+    wsrep::tls_service* service;
+
+    // Number of want_read and want_write results seen, updated from
+    // both ends of the connection.
+    std::atomic<unsigned long long> wants;
+
+    std::string errno_message(const std::string& what)
+    {
+        return what + ": " + ::strerror(errno);
+    }
+
+    void connect_tcp(int fds[2])
+    {
+        const int listener(::socket(AF_INET, SOCK_STREAM, 0));
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addr_len(sizeof(addr));
+        if (listener < 0 ||
+            ::bind(listener, reinterpret_cast<struct sockaddr*>(&addr),
+                   addr_len) ||
+            ::listen(listener, 1) ||
+            ::getsockname(listener, reinterpret_cast<struct sockaddr*>(&addr),
+                          &addr_len) ||
+            (fds[0] = ::socket(AF_INET, SOCK_STREAM, 0)) < 0 ||
+            ::connect(fds[0], reinterpret_cast<struct sockaddr*>(&addr),
+                      addr_len) ||
+            (fds[1] = ::accept(listener, 0, 0)) < 0)
+        {
+            const std::string msg(errno_message("Failed to connect"));
+            if (listener >= 0) ::close(listener);
+            throw wsrep::runtime_error(msg);
+        }
+        ::close(listener);
+        const int one(1);
+        ::setsockopt(fds[0], IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        ::setsockopt(fds[1], IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    // Create connected pair of sockets, fds[0] is the client end.
+    void connect_pair(int fds[2], bool blocking)
+    {
+        if (tcp)
+        {
+            connect_tcp(fds);
+        }
+        else if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds))
+        {
+            throw wsrep::runtime_error(errno_message("Failed to connect"));
+        }
+        if (not blocking)
+        {
+            for (int i(0); i < 2; ++i)
+            {
+                ::fcntl(fds[i], F_SETFL, ::fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+            }
+        }
+    }
+
+    // Wait until the socket becomes ready for the operation which
+    // returned status. The wait times out so that a stream which
+    // reports want_read or want_write without being blocked on the
+    // socket does not stall the benchmark.
+    void wait_for(int fd, ssize_t status)
+    {
+        ++wants;
+        struct pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = (status == wsrep::tls_service::want_read ?
+                      POLLIN : POLLOUT);
+        pfd.revents = 0;
+        (void)::poll(&pfd, 1, 10);
+    }
+
+    bool is_want(ssize_t status)
+    {
+        return (status == wsrep::tls_service::want_read ||
+                status == wsrep::tls_service::want_write);
+    }
+
+    // TLS stream over a socket. The stream takes ownership of the
+    // socket.
+    class stream
+    {
+    public:
+        stream(int fd)
+            : fd_(fd)
+            , stream_(service->create_tls_stream(fd))
+        {
+            if (not stream_)
+            {
+                ::close(fd_);
+                throw wsrep::runtime_error("Failed to create TLS stream");
+            }
+        }
+
+        ~stream()
+        {
+            service->destroy(stream_);
+            ::close(fd_);
+        }
+
+        // Perform one handshake step.
+        ssize_t handshake_step(bool client)
+        {
+            const ssize_t ret(client ?
+                              service->client_handshake(stream_) :
+                              service->server_handshake(stream_));
+            if (ret != wsrep::tls_service::success && not is_want(ret))
+            {
+                fail("Handshake", ret);
+            }
+            return ret;
+        }
+
+        void handshake(bool client)
+        {
+            ssize_t status;
+            while ((status = handshake_step(client)) !=
+                   wsrep::tls_service::success)
+            {
+                wait_for(fd_, status);
+            }
+        }
+
+        void write_all(const char* buf, size_t count)
+        {
+            while (count > 0)
+            {
+                const wsrep::tls_service::op_result result(
+                    service->write(stream_, buf, count));
+                if (result.status != wsrep::tls_service::success &&
+                    not is_want(result.status))
+                {
+                    fail("Write", result.status);
+                }
+                buf += result.bytes_transferred;
+                count -= result.bytes_transferred;
+                if (is_want(result.status)) wait_for(fd_, result.status);
+            }
+        }
+
+        // Read at least one byte, return the number of bytes read.
+        size_t read_some(char* buf, size_t max_count)
+        {
+            for (;;)
+            {
+                const wsrep::tls_service::op_result result(
+                    service->read(stream_, buf, max_count));
+                if (result.status != wsrep::tls_service::success &&
+                    not is_want(result.status))
+                {
+                    fail("Read", result.status);
+                }
+                if (is_want(result.status)) wait_for(fd_, result.status);
+                if (result.bytes_transferred > 0)
+                {
+                    return result.bytes_transferred;
+                }
+            }
+        }
+
+        void read_all(char* buf, size_t count)
+        {
+            while (count > 0)
+            {
+                const size_t read(read_some(buf, count));
+                buf += read;
+                count -= read;
+            }
+        }
+
+        int fd() const { return fd_; }
+    private:
+        stream(const stream&);
+        stream& operator=(const stream&);
+
+        void fail(const char* what, ssize_t status)
+        {
+            std::string msg(what);
+            if (status == wsrep::tls_service::eof)
+            {
+                msg += ": end of file";
+            }
+            else
+            {
+                msg += std::string(": ") + service->get_error_message(
+                    stream_, service->get_error_number(stream_),
+                    service->get_error_category(stream_));
+            }
+            throw wsrep::runtime_error(msg);
+        }
+
+        int fd_;
+        wsrep::tls_stream* stream_;
+    };
+
+    // Run fn on a separate thread. An exception thrown from fn is
+    // rethrown from join().
+    class peer
+    {
+    public:
+        template <class Fn>
+        explicit peer(Fn fn)
+            : error_()
+            , thread_([this, fn]()
+                      {
+                          try { fn(); }
+                          catch (const std::exception& e)
+                          {
+                              error_ = e.what();
+                          }
+                      })
+        { }
+
+        void join()
+        {
+            thread_.join();
+            if (not error_.empty()) throw wsrep::runtime_error(error_);
+        }
+    private:
+        std::string error_;
+        std::thread thread_;
+    };
+
+    void report(const std::string& name, size_t ops,
+                std::chrono::steady_clock::duration duration,
+                size_t transferred, unsigned long long wants_start)
+    {
+        const double secs(std::chrono::duration<double>(duration).count());
+        const double dops(static_cast<double>(ops));
+        std::cout << "{\"name\": \"" << name << "\""
+                  << ", \"iterations\": " << ops
+                  << ", \"ns_per_op\": " << secs * 1e9 / dops
+                  << ", \"mb_per_sec\": "
+                  << static_cast<double>(transferred) / (1 << 20) / secs
+                  << ", \"wants_per_op\": "
+                  << static_cast<double>(wants - wants_start) / dops
+                  << "}" << std::endl;
+    }
+
+    //
+    // Benchmarks
+    //
+
+    // One operation is connection setup, handshake and stream
+    // teardown. In blocking mode the server end runs on a separate
+    // thread, in non-blocking mode both ends are driven from a single
+    // thread as an event loop would.
+    void handshake(const std::string& name, bool blocking)
+    {
+        const unsigned long long wants_start(wants);
+        const auto start(std::chrono::steady_clock::now());
+        for (size_t i(0); i < iterations; ++i)
+        {
+            int fds[2];
+            connect_pair(fds, blocking);
+            stream client(fds[0]);
+            stream server(fds[1]);
+            if (blocking)
+            {
+                peer server_peer([&server]() { server.handshake(false); });
+                try
+                {
+                    client.handshake(true);
+                }
+                catch (...)
+                {
+                    ::shutdown(client.fd(), SHUT_RDWR);
+                    server_peer.join();
+                    throw;
+                }
+                server_peer.join();
+                continue;
+            }
+            bool client_done(false);
+            bool server_done(false);
+            while (not (client_done && server_done))
+            {
+                struct pollfd pfds[2];
+                nfds_t nfds(0);
+                stream* ends[2] = { &client, &server };
+                bool* done[2] = { &client_done, &server_done };
+                for (int e(0); e < 2; ++e)
+                {
+                    if (*done[e]) continue;
+                    const ssize_t status(ends[e]->handshake_step(e == 0));
+                    if (status == wsrep::tls_service::success)
+                    {
+                        *done[e] = true;
+                        continue;
+                    }
+                    ++wants;
+                    pfds[nfds].fd = ends[e]->fd();
+                    pfds[nfds].events = (status == wsrep::tls_service::want_read ?
+                                         POLLIN : POLLOUT);
+                    pfds[nfds].revents = 0;
+                    ++nfds;
+                }
+                if (nfds) (void)::poll(pfds, nfds, 10);
+            }
+        }
+        report(name, iterations, std::chrono::steady_clock::now() - start,
+               0, wants_start);
+    }
+
+    // One operation is a write of chunk_size bytes. The receiving end
+    // reads on a separate thread into a 64KiB buffer.
+    void throughput(const std::string& name, bool blocking, size_t chunk_size)
+    {
+        const size_t chunks(std::max(bytes / chunk_size, size_t(1)));
+        const size_t total(chunks * chunk_size);
+        int fds[2];
+        connect_pair(fds, blocking);
+        stream client(fds[0]);
+        stream server(fds[1]);
+        peer server_peer([&server]() { server.handshake(false); });
+        client.handshake(true);
+        server_peer.join();
+
+        std::vector<char> chunk(chunk_size, 'x');
+        const unsigned long long wants_start(wants);
+        const auto start(std::chrono::steady_clock::now());
+        peer reader([&server, total]()
+                    {
+                        std::vector<char> buf(1 << 16);
+                        size_t received(0);
+                        while (received < total)
+                        {
+                            received += server.read_some(
+                                buf.data(),
+                                std::min(buf.size(), total - received));
+                        }
+                    });
+        try
+        {
+            for (size_t i(0); i < chunks; ++i)
+            {
+                client.write_all(chunk.data(), chunk.size());
+            }
+        }
+        catch (...)
+        {
+            ::shutdown(client.fd(), SHUT_RDWR);
+            reader.join();
+            throw;
+        }
+        reader.join();
+        report(name, chunks, std::chrono::steady_clock::now() - start,
+               total, wants_start);
+    }
+
+    // One operation is a round trip of message_size bytes, the server
+    // end echoes the message back on a separate thread.
+    void latency(const std::string& name, bool blocking, size_t message_size)
+    {
+        int fds[2];
+        connect_pair(fds, blocking);
+        stream client(fds[0]);
+        stream server(fds[1]);
+        peer server_peer([&server]() { server.handshake(false); });
+        client.handshake(true);
+        server_peer.join();
+
+        std::vector<char> message(message_size, 'x');
+        const unsigned long long wants_start(wants);
+        const auto start(std::chrono::steady_clock::now());
+        peer echo([&server, message_size]()
+                  {
+                      std::vector<char> buf(message_size);
+                      for (size_t i(0); i < iterations; ++i)
+                      {
+                          server.read_all(buf.data(), buf.size());
+                          server.write_all(buf.data(), buf.size());
+                      }
+                  });
+        try
+        {
+            for (size_t i(0); i < iterations; ++i)
+            {
+                client.write_all(message.data(), message.size());
+                client.read_all(message.data(), message.size());
+            }
+        }
+        catch (...)
+        {
+            ::shutdown(client.fd(), SHUT_RDWR);
+            echo.join();
+            throw;
+        }
+        echo.join();
+        report(name, iterations, std::chrono::steady_clock::now() - start,
+               2 * iterations * message_size, wants_start);
+    }
+
+    void handshake_blocking(const char* name)
+    {
+        handshake(name, true);
+    }
+
+    void handshake_nonblocking(const char* name)
+    {
+        handshake(name, false);
+    }
+
+    void throughput_1k_blocking(const char* name)
+    {
+        throughput(name, true, 1 << 10);
+    }
+
+    void throughput_1k_nonblocking(const char* name)
+    {
+        throughput(name, false, 1 << 10);
+    }
+
+    void throughput_64k_blocking(const char* name)
+    {
+        throughput(name, true, 1 << 16);
+    }
+
+    void throughput_64k_nonblocking(const char* name)
+    {
+        throughput(name, false, 1 << 16);
+    }
+
+    void latency_64_blocking(const char* name)
+    {
+        latency(name, true, 64);
+    }
+
+    void latency_64_nonblocking(const char* name)
+    {
+        latency(name, false, 64);
+    }
+
+    void latency_4k_blocking(const char* name)
+    {
+        latency(name, true, 1 << 12);
+    }
+
+    void latency_4k_nonblocking(const char* name)
+    {
+        latency(name, false, 1 << 12);
+    }
+
+    struct benchmark
+    {
+        const char* name;
+        void (*fn)(const char*);
+    };
+
+    const benchmark benchmarks[] =
+    {
+        { "handshake_blocking", handshake_blocking },
+        { "handshake_nonblocking", handshake_nonblocking },
+        { "throughput_1k_blocking", throughput_1k_blocking },
+        { "throughput_1k_nonblocking", throughput_1k_nonblocking },
+        { "throughput_64k_blocking", throughput_64k_blocking },
+        { "throughput_64k_nonblocking", throughput_64k_nonblocking },
+        { "latency_64_blocking", latency_64_blocking },
+        { "latency_64_nonblocking", latency_64_nonblocking },
+        { "latency_4k_blocking", latency_4k_blocking },
+        { "latency_4k_nonblocking", latency_4k_nonblocking }
+    };
+
+    bool parse_arg(const std::string& arg)
+    {
+        const std::string::size_type delim(arg.find('='));
+        const std::string parm(arg.substr(0, delim));
+        const std::string val(delim == std::string::npos ?
+                              "" : arg.substr(delim + 1));
+        if (parm == "--iterations")
+        {
+            iterations = std::strtoul(val.c_str(), 0, 10);
+            return (iterations > 0);
+        }
+        else if (parm == "--bytes")
+        {
+            bytes = std::strtoul(val.c_str(), 0, 10);
+            return (bytes > 0);
+        }
+        else if (parm == "--transport")
+        {
+            tcp = (val == "tcp");
+            return (tcp || val == "socketpair");
+        }
+        else if (parm == "--filter")
+        {
+            filter = val;
+            return true;
+        }
+        std::cerr << "Error: Unknown argument " << arg << std::endl;
+        return false;
+    }
+}
+
+int wsrep::tls_bench_main(wsrep::tls_service& tls_service,
+                          int argc, char* argv[])
+{
+    for (int i(1); i < argc; ++i)
+    {
+        if (parse_arg(argv[i]) == false)
+        {
+            return 1;
+        }
+    }
+    service = &tls_service;
+    for (const auto& b : benchmarks)
+    {
+        if (std::string(b.name).find(filter) != std::string::npos)
+        {
+            try
+            {
+                b.fn(b.name);
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "Error: " << b.name << ": " << e.what()
+                          << std::endl;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
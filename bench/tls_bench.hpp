@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file tls_bench.hpp
+ *
+ * Benchmark driver for wsrep::tls_service implementations. The
+ * driver uses the service the way a provider does: streams are
+ * created over connected sockets, handshaked, and data is transferred
+ * with read() and write(), waiting for the socket when an operation
+ * returns want_read or want_write.
+ *
+ * To benchmark an application TLS service, link tls_bench.cpp with
+ * a main() which passes the service to tls_bench_main(). See
+ * tls_bench_db.cpp for an example which uses the dbsim TLS stream.
+ */
+
+#ifndef WSREP_TLS_BENCH_HPP
+#define WSREP_TLS_BENCH_HPP
+
+#include "wsrep/tls_service.hpp"
+
+namespace wsrep
+{
+    /**
+     * Run TLS service benchmarks. Each benchmark prints one JSON
+     * object per line into stdout:
+     *
+     * {"name": "...", "iterations": N, "ns_per_op": X,
+     *  "mb_per_sec": Y, "wants_per_op": Z}
+     *
+     * where wants_per_op is the number of want_read and want_write
+     * results per operation.
+     *
+     * Commandline arguments:
+     *
+     * --iterations=<int>  Number of handshakes and round trips
+     * --bytes=<int>       Number of bytes to transfer in throughput
+     *                     benchmarks
+     * --transport=<str>   socketpair (default) or tcp for loopback TCP
+     * --filter=<string>   Run only benchmarks whose name contains <string>
+     *
+     * @return Zero on success, non-zero on error.
+     */
+    int tls_bench_main(wsrep::tls_service& service, int argc, char* argv[]);
+}
+
+#endif // WSREP_TLS_BENCH_HPP
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file tls_bench_db.cpp
+ *
+ * TLS service benchmark baseline using the dbsim TLS stream, which
+ * transfers data unencrypted.
+ *
+ * In addition to the arguments of wsrep::tls_bench_main() this
+ * accepts:
+ *
+ * --db-tls-mode=<int>  dbsim TLS service mode, 2 simulates short
+ *                      transfers and want_read/want_write results
+ *                      in non-blocking mode
+ */
+
+#include "tls_bench.hpp"
+#include "db_tls.hpp"
+
+#include "wsrep/logger.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    void discard_log(wsrep::log::level, const char*, const char*) { }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string mode_arg("--db-tls-mode=");
+    int mode(0);
+    std::vector<char*> args;
+    for (int i(0); i < argc; ++i)
+    {
+        if (std::string(argv[i]).compare(0, mode_arg.size(), mode_arg) == 0)
+        {
+            mode = std::atoi(argv[i] + mode_arg.size());
+            // Mode 3 error simulation is not recoverable by the
+            // benchmark driver.
+            if (mode < 0 || mode > 2)
+            {
+                std::cerr << "Error: Invalid argument " << argv[i]
+                          << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            args.push_back(argv[i]);
+        }
+    }
+    wsrep::log::logger_fn(discard_log);
+    db::tls::init(mode);
+    db::tls service;
+    return wsrep::tls_bench_main(service, int(args.size()), args.data());
+}
@@ -0,0 +1,622 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file wsrep-lib_bench.cpp
+ *
+ * Microbenchmarks for transaction lifecycle hot paths. The benchmarks
+ * are driven by wsrep::noop_provider and the mock services from unit
+ * tests, so the results reflect the cost of wsrep-lib itself.
+ *
+ * The *_ostream, *_istream and *_c_str benchmarks compare formatting
+ * and parsing of identifiers through streams and into caller buffers.
+ *
+ * The append_* benchmarks compare appending with and without copying.
+ * The noop provider copies appended data like a real provider does,
+ * the copied bytes are reported in copied_bytes_per_op. Debug builds
+ * keep a verification copy of the buffers appended without copying,
+ * so the comparison is meaningful only in release builds.
+ *
+ * Each benchmark prints one JSON object per line into stdout:
+ *
+ * {"name": "...", "iterations": N, "ns_per_op": X,
+ *  "allocs_per_op": Y, "bytes_per_op": Z}
+ *
+ * Benchmarks which append into write sets add
+ * "copied_bytes_per_op" into the object.
+ *
+ * Commandline arguments:
+ *
+ * --iterations=<int>  Number of timed operations per benchmark
+ * --filter=<string>   Run only benchmarks whose name contains <string>
+ */
+
+// The mock services use Boost.Test assertions. Compile the test
+// framework in, but without its main().
+#define BOOST_TEST_NO_MAIN
+#include <boost/test/included/unit_test.hpp>
+
+#include "alloc_counter.hpp"
+#include "noop_provider.hpp"
+#include "mock_server_state.hpp"
+#include "mock_client_state.hpp"
+#include "mock_high_priority_service.hpp"
+
+#include "wsrep/logger.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    size_t iterations(100000);
+    std::string filter;
+    // Results of formatting benchmarks are accumulated here to keep
+    // the compiler from optimizing the operations away.
+    volatile size_t sink;
+
+    class bench_server_state : public wsrep::server_state
+    {
+    public:
+        bench_server_state(wsrep::server_service& server_service)
+            : wsrep::server_state(mutex_, cond_, server_service, NULL,
+                                  "s1", "", "", "./",
+                                  wsrep::gtid::undefined(),
+                                  1,
+                                  wsrep::server_state::rm_sync)
+            , mutex_()
+            , cond_()
+            , provider_()
+        {
+            set_provider_factory([&](wsrep::server_state&,
+                                     const std::string&,
+                                     const std::string&,
+                                     const wsrep::provider::services&)
+            {
+                provider_ = new wsrep::noop_provider(*this);
+                return std::unique_ptr<wsrep::provider>(provider_);
+            });
+            load_provider("noop", "");
+            connect("cluster", "local", "", false);
+            std::vector<wsrep::view::member> members;
+            members.push_back(wsrep::view::member(provider_->server_id(),
+                                                  "s1", ""));
+            on_connect(wsrep::view(wsrep::gtid(wsrep::id("1"),
+                                               wsrep::seqno(0)),
+                                   wsrep::seqno(1),
+                                   wsrep::view::primary,
+                                   0, 0, 1, members));
+        }
+
+        wsrep::noop_provider& provider() const { return *provider_; }
+    private:
+        wsrep::default_mutex mutex_;
+        wsrep::default_condition_variable cond_;
+        wsrep::noop_provider* provider_;
+    };
+
+    struct fixture
+    {
+        fixture(enum wsrep::client_state::mode mode =
+                wsrep::client_state::m_local)
+            : server_service(&server_state)
+            , server_state(server_service)
+            , client(server_state, wsrep::client_id(1), mode)
+            , row()
+            , key(wsrep::key::exclusive)
+        {
+            client.open(client.id());
+            key.append_key_part("bench", 5);
+            key.append_key_part("t1", 2);
+            key.append_key_part(&row, sizeof(row));
+            std::fill(data, data + sizeof(data), 'x');
+        }
+
+        ~fixture()
+        {
+            client.close();
+            client.cleanup();
+        }
+
+        void begin()
+        {
+            client.before_command();
+            client.before_statement();
+            client.start_transaction(server_service.next_transaction_id());
+        }
+
+        void append()
+        {
+            ++row;
+            client.append_key(key);
+            client.append_data(wsrep::const_buffer(data, sizeof(data)));
+        }
+
+        void commit()
+        {
+            client.before_commit();
+            client.ordered_commit();
+            client.after_commit();
+            end();
+        }
+
+        void end()
+        {
+            client.after_statement();
+            client.after_command_before_result();
+            client.after_command_after_result();
+            client.reset_error();
+        }
+
+        wsrep::mock_server_service server_service;
+        bench_server_state server_state;
+        wsrep::mock_client client;
+        // Key refers to row, changing row changes the key.
+        unsigned long long row;
+        wsrep::key key;
+        char data[64];
+    };
+
+    template <class Op>
+    void measure(const char* name, Op op,
+                 const wsrep::noop_provider* provider = 0)
+    {
+        for (size_t i(0); i < iterations / 10 + 1; ++i)
+        {
+            op();
+        }
+        const unsigned long long allocations_start(wsrep_bench::allocations);
+        const unsigned long long bytes_start(wsrep_bench::allocated_bytes);
+        const unsigned long long copied_start(
+            provider ? provider->bytes_copied() : 0);
+        const auto start(std::chrono::steady_clock::now());
+        for (size_t i(0); i < iterations; ++i)
+        {
+            op();
+        }
+        const auto stop(std::chrono::steady_clock::now());
+        const double ops(static_cast<double>(iterations));
+        std::cout << "{\"name\": \"" << name << "\""
+                  << ", \"iterations\": " << iterations
+                  << ", \"ns_per_op\": "
+                  << std::chrono::duration<double, std::nano>(
+                      stop - start).count() / ops
+                  << ", \"allocs_per_op\": "
+                  << double(wsrep_bench::allocations - allocations_start) / ops
+                  << ", \"bytes_per_op\": "
+                  << double(wsrep_bench::allocated_bytes - bytes_start) / ops;
+        if (provider)
+        {
+            std::cout << ", \"copied_bytes_per_op\": "
+                      << double(provider->bytes_copied() - copied_start) / ops;
+        }
+        std::cout << "}" << std::endl;
+    }
+
+    //
+    // Benchmarks. Unless stated otherwise, one operation is a complete
+    // command/statement/transaction cycle with one key and 64 bytes of
+    // data.
+    //
+
+    void trx_1pc(const char* name)
+    {
+        fixture f;
+        measure(name, [&f]()
+        {
+            f.begin();
+            f.append();
+            f.commit();
+        });
+    }
+
+    void trx_2pc(const char* name)
+    {
+        fixture f;
+        f.client.do_2pc_ = true;
+        measure(name, [&f]()
+        {
+            f.begin();
+            f.append();
+            f.client.before_prepare();
+            f.client.after_prepare();
+            f.commit();
+        });
+    }
+
+    // One operation is a single append, transaction is committed after
+    // every 64 appends. Each appended key refers to its own row slot,
+    // so that keys appended without copying stay unchanged until
+    // the transaction is certified.
+    void append_keys(const char* name, bool nocopy)
+    {
+        fixture f;
+        unsigned long long rows[64];
+        f.begin();
+        size_t appended(0);
+        measure(name, [&f, &rows, &appended, nocopy]()
+        {
+            if (++appended % 64 == 0)
+            {
+                f.commit();
+                f.begin();
+            }
+            unsigned long long& row(rows[appended % 64]);
+            row = ++f.row;
+            wsrep::key key(wsrep::key::exclusive);
+            key.append_key_part("bench", 5);
+            key.append_key_part("t1", 2);
+            key.append_key_part(&row, sizeof(row));
+            if (nocopy)
+            {
+                f.client.append_key_nocopy(key);
+            }
+            else
+            {
+                f.client.append_key(key);
+            }
+        }, &f.server_state.provider());
+        f.commit();
+    }
+
+    void append_key(const char* name)
+    {
+        append_keys(name, false);
+    }
+
+    void append_key_nocopy(const char* name)
+    {
+        append_keys(name, true);
+    }
+
+    void append_buffers(const char* name, const wsrep::const_buffer& data,
+                        bool nocopy)
+    {
+        fixture f;
+        f.begin();
+        size_t appended(0);
+        measure(name, [&f, &data, &appended, nocopy]()
+        {
+            if (++appended % 64 == 0)
+            {
+                f.commit();
+                f.begin();
+            }
+            if (nocopy)
+            {
+                f.client.append_data_nocopy(data);
+            }
+            else
+            {
+                f.client.append_data(data);
+            }
+        }, &f.server_state.provider());
+        f.commit();
+    }
+
+    char data_4k[4096];
+
+    void append_data(const char* name)
+    {
+        const char data[64] = { 'x' };
+        append_buffers(name, wsrep::const_buffer(data, sizeof(data)), false);
+    }
+
+    void append_data_nocopy(const char* name)
+    {
+        const char data[64] = { 'x' };
+        append_buffers(name, wsrep::const_buffer(data, sizeof(data)), true);
+    }
+
+    void append_data_4k(const char* name)
+    {
+        append_buffers(name, wsrep::const_buffer(data_4k, sizeof(data_4k)),
+                       false);
+    }
+
+    void append_data_4k_nocopy(const char* name)
+    {
+        append_buffers(name, wsrep::const_buffer(data_4k, sizeof(data_4k)),
+                       true);
+    }
+
+    void xa_prepare_commit(const char* name)
+    {
+        fixture f;
+        const wsrep::xid xid(1, 9, 0, "bench xid");
+        measure(name, [&f, &xid]()
+        {
+            f.begin();
+            f.client.assign_xid(xid);
+            f.append();
+            f.client.before_prepare();
+            f.client.after_prepare();
+            f.commit();
+        });
+    }
+
+    void bf_abort_rollback(const char* name)
+    {
+        fixture f;
+        measure(name, [&f]()
+        {
+            f.begin();
+            f.append();
+            f.client.bf_abort(wsrep::seqno(1));
+            f.client.before_commit();
+            f.client.before_rollback();
+            f.client.after_rollback();
+            f.end();
+        });
+    }
+
+    // One operation is a single row fragment, transaction is committed
+    // after every 16 fragments.
+    void sr_fragment(const char* name)
+    {
+        fixture f;
+        f.client.before_command();
+        f.client.before_statement();
+        f.client.enable_streaming(wsrep::streaming_context::row, 1);
+        f.end();
+        f.begin();
+        size_t fragments(0);
+        measure(name, [&f, &fragments]()
+        {
+            if (++fragments % 16 == 0)
+            {
+                f.commit();
+                f.begin();
+            }
+            f.append();
+            f.client.after_row();
+        });
+        f.commit();
+    }
+
+    void toi(const char* name)
+    {
+        fixture f;
+        const wsrep::mutable_buffer err;
+        measure(name, [&f, &err]()
+        {
+            ++f.row;
+            f.client.before_command();
+            f.client.enter_toi_local(wsrep::key_array({f.key}),
+                                     wsrep::const_buffer(f.data,
+                                                         sizeof(f.data)));
+            f.client.leave_toi_local(err);
+            f.client.after_command_before_result();
+            f.client.after_command_after_result();
+        });
+    }
+
+    // One operation is a write set applied via server_state::on_apply().
+    void on_apply(const char* name)
+    {
+        fixture f(wsrep::client_state::m_high_priority);
+        f.client.before_command();
+        wsrep::mock_high_priority_service hps(f.server_state, &f.client,
+                                              false);
+        const wsrep::id source("2");
+        long long seqno(0);
+        measure(name, [&]()
+        {
+            ++seqno;
+            const wsrep::transaction_id id(seqno);
+            const wsrep::ws_meta ws_meta(
+                wsrep::gtid(wsrep::id("1"), wsrep::seqno(seqno)),
+                wsrep::stid(source, id, wsrep::client_id(1)),
+                wsrep::seqno(seqno - 1),
+                wsrep::provider::flag::start_transaction |
+                wsrep::provider::flag::commit);
+            f.server_state.on_apply(hps, wsrep::ws_handle(id, &hps), ws_meta,
+                                    wsrep::const_buffer(f.data,
+                                                        sizeof(f.data)));
+        });
+        f.client.after_command_before_result();
+        f.client.after_command_after_result();
+    }
+
+    const wsrep::gtid bench_gtid(
+        wsrep::id("6a20d44a-6e17-11e8-b1e2-9061aec0cdad"),
+        wsrep::seqno(1234567890));
+
+    void id_ostream(const char* name)
+    {
+        measure(name, []()
+        {
+            std::ostringstream os;
+            os << bench_gtid.id();
+            sink = sink + os.str().size();
+        });
+    }
+
+    void id_to_string(const char* name)
+    {
+        measure(name, []()
+        {
+            sink = sink + bench_gtid.id().to_string().size();
+        });
+    }
+
+    void id_print_c_str(const char* name)
+    {
+        measure(name, []()
+        {
+            char buf[WSREP_LIB_ID_C_STR_LEN];
+            sink = sink + size_t(wsrep::print_to_c_str(bench_gtid.id(), buf,
+                                                       sizeof(buf)));
+        });
+    }
+
+    void gtid_ostream(const char* name)
+    {
+        measure(name, []()
+        {
+            std::ostringstream os;
+            os << bench_gtid;
+            sink = sink + os.str().size();
+        });
+    }
+
+    void gtid_print_c_str(const char* name)
+    {
+        measure(name, []()
+        {
+            char buf[WSREP_LIB_GTID_C_STR_LEN];
+            sink = sink + size_t(wsrep::print_to_c_str(bench_gtid, buf,
+                                                       sizeof(buf)));
+        });
+    }
+
+    void gtid_istream(const char* name)
+    {
+        const std::string str("6a20d44a-6e17-11e8-b1e2-9061aec0cdad:1234567890");
+        measure(name, [&str]()
+        {
+            std::istringstream is(str);
+            wsrep::gtid gtid;
+            is >> gtid;
+            sink = sink + size_t(gtid.seqno().get());
+        });
+    }
+
+    void gtid_scan_c_str(const char* name)
+    {
+        const std::string str("6a20d44a-6e17-11e8-b1e2-9061aec0cdad:1234567890");
+        measure(name, [&str]()
+        {
+            wsrep::gtid gtid;
+            wsrep::scan_from_c_str(str.data(), str.size(), gtid);
+            sink = sink + size_t(gtid.seqno().get());
+        });
+    }
+
+    // One operation is a copy, comparison and hash of an xid with
+    // 64 byte gtrid and 16 byte bqual.
+    void xid_copy(const char* name)
+    {
+        const std::string data(80, 'x');
+        const wsrep::xid xid(1, 64, 16, data.c_str());
+        measure(name, [&xid]()
+        {
+            const wsrep::xid copy(xid);
+            sink = sink + (copy == xid) + copy.hash();
+        });
+    }
+
+    void xid_ostream(const char* name)
+    {
+        const wsrep::xid xid(1, 9, 0, "bench xid");
+        measure(name, [&xid]()
+        {
+            std::ostringstream os;
+            os << xid;
+            sink = sink + os.str().size();
+        });
+    }
+
+    void xid_print_c_str(const char* name)
+    {
+        const wsrep::xid xid(1, 9, 0, "bench xid");
+        measure(name, [&xid]()
+        {
+            char buf[WSREP_LIB_XID_C_STR_LEN];
+            sink = sink + size_t(wsrep::print_to_c_str(xid, buf, sizeof(buf)));
+        });
+    }
+
+    struct benchmark
+    {
+        const char* name;
+        void (*fn)(const char*);
+    };
+
+    const benchmark benchmarks[] =
+    {
+        { "trx_1pc", trx_1pc },
+        { "trx_2pc", trx_2pc },
+        { "append_key", append_key },
+        { "append_key_nocopy", append_key_nocopy },
+        { "append_data", append_data },
+        { "append_data_nocopy", append_data_nocopy },
+        { "append_data_4k", append_data_4k },
+        { "append_data_4k_nocopy", append_data_4k_nocopy },
+        { "xa_prepare_commit", xa_prepare_commit },
+        { "bf_abort_rollback", bf_abort_rollback },
+        { "sr_fragment", sr_fragment },
+        { "toi", toi },
+        { "on_apply", on_apply },
+        { "id_ostream", id_ostream },
+        { "id_to_string", id_to_string },
+        { "id_print_c_str", id_print_c_str },
+        { "gtid_ostream", gtid_ostream },
+        { "gtid_print_c_str", gtid_print_c_str },
+        { "gtid_istream", gtid_istream },
+        { "gtid_scan_c_str", gtid_scan_c_str },
+        { "xid_copy", xid_copy },
+        { "xid_ostream", xid_ostream },
+        { "xid_print_c_str", xid_print_c_str }
+    };
+
+    void discard_log(wsrep::log::level, const char*, const char*) { }
+
+    bool parse_arg(const std::string& arg)
+    {
+        const std::string::size_type delim(arg.find('='));
+        const std::string parm(arg.substr(0, delim));
+        const std::string val(delim == std::string::npos ?
+                              "" : arg.substr(delim + 1));
+        if (parm == "--iterations")
+        {
+            iterations = std::strtoul(val.c_str(), 0, 10);
+            return (iterations > 0);
+        }
+        else if (parm == "--filter")
+        {
+            filter = val;
+            return true;
+        }
+        std::cerr << "Error: Unknown argument " << arg << std::endl;
+        return false;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    for (int i(1); i < argc; ++i)
+    {
+        if (parse_arg(argv[i]) == false)
+        {
+            return 1;
+        }
+    }
+    wsrep::log::logger_fn(discard_log);
+    for (const auto& b : benchmarks)
+    {
+        if (std::string(b.name).find(filter) != std::string::npos)
+        {
+            b.fn(b.name);
+        }
+    }
+    return 0;
+}
@@ -22,6 +22,8 @@
 
 #include "wsrep/logger.hpp"
 
+#include <thread>
+
 db::client::client(db::server& server,
                    wsrep::client_id client_id,
                    enum wsrep::client_state::mode mode,
@@ -35,9 +37,14 @@ db::client::client(db::server& server,
     , client_service_(*this)
     , se_trx_(server.storage_engine())
     , data_()
+    , log_()
+    , read_buf_()
     , random_device_()
     , random_engine_(random_device_())
+    , workload_(params, server.key_distribution(), client_id.get())
     , stats_()
+    , latency_stats_()
+    , commit_order_enter_()
 {
     data_.resize(params.max_data_size);
 }
@@ -45,10 +52,34 @@ db::client::client(db::server& server,
 void db::client::start()
 {
     client_state_.open(client_state_.id());
-    for (size_t i(0); i < params_.n_transactions; ++i)
+    db::arrival_schedule& schedule(server_.arrival_schedule());
+    if (schedule.enabled())
     {
-        run_one_transaction();
-        report_progress(i + 1);
+        std::chrono::steady_clock::time_point intended;
+        size_t step;
+        for (size_t i(0); schedule.next(intended, step); ++i)
+        {
+            std::this_thread::sleep_until(intended);
+            run_one_transaction();
+            const auto now(std::chrono::steady_clock::now());
+            latency_stats_.record(db::latency_stats::p_response,
+                                  now - intended);
+            latency_stats_.record_step(step, schedule.step_at(now),
+                                       now - intended);
+            report_progress(i + 1);
+        }
+    }
+    else
+    {
+        for (size_t i(0); i < params_.n_transactions; ++i)
+        {
+            timed(db::latency_stats::p_response, [this]()
+            {
+                run_one_transaction();
+                return 0;
+            });
+            report_progress(i + 1);
+        }
     }
     client_state_.close();
     client_state_.cleanup();
@@ -91,6 +122,15 @@ int db::client::client_command(F f)
     return err;
 }
 
+template <class F>
+int db::client::timed(enum db::latency_stats::phase phase, F f)
+{
+    const auto start(std::chrono::steady_clock::now());
+    int err(f());
+    latency_stats_.record(phase, std::chrono::steady_clock::now() - start);
+    return err;
+}
+
 static void release_commit_critical_section(void* ptr)
 {
     auto* crit = static_cast<db::server::commit_critical_section*>(ptr);
@@ -110,88 +150,41 @@ void db::client::run_one_transaction()
         }
     }
     client_state_.reset_error();
+    const enum db::workload::kind kind(workload_.next_kind(random_engine_));
+    if (kind == db::workload::k_toi)
+    {
+        run_toi();
+        return;
+    }
+
     int err = client_command(
         [&]()
         {
             // wsrep::log_debug() << "Start transaction";
-            err = client_state_.start_transaction(
-                wsrep::transaction_id(server_.next_transaction_id()));
-            assert(err == 0);
-            se_trx_.start(this);
-            return err;
+            return timed(db::latency_stats::p_start,
+                         [&]() { return start_transaction(kind); });
         });
 
     const wsrep::transaction& transaction(
         client_state_.transaction());
 
-    err = err || client_command(
-        [&]()
-        {
-            // wsrep::log_debug() << "Generate write set";
-            assert(transaction.active());
-            assert(err == 0);
-            std::uniform_int_distribution<size_t> uniform_dist(0, params_.n_rows);
-            const size_t randkey(uniform_dist(random_engine_));
-            ::memcpy(data_.data(), &randkey,
-                     std::min(sizeof(randkey), data_.size()));
-            wsrep::key key(wsrep::key::exclusive);
-            key.append_key_part("dbms", 4);
-            unsigned long long client_key(client_state_.id().get());
-            key.append_key_part(&client_key, sizeof(client_key));
-            key.append_key_part(&randkey, sizeof(randkey));
-            err = client_state_.append_key(key);
-            size_t bytes_to_append(data_.size());
-            if (params_.random_data_size)
+    const bool log_rows(kind != db::workload::k_regular);
+    for (size_t i(0); i < params_.statements; ++i)
+    {
+        err = err || client_command(
+            [&]()
             {
-                bytes_to_append = std::uniform_int_distribution<size_t>(
-                    1, data_.size())(random_engine_);
-            }
-            err = err || client_state_.append_data(
-                wsrep::const_buffer(data_.data(), bytes_to_append));
-            return err;
-        });
+                // wsrep::log_debug() << "Generate write set";
+                assert(transaction.active());
+                return timed(db::latency_stats::p_append,
+                             [&]() { return execute_statement(log_rows); });
+            });
+    }
 
     err = err || client_command(
         [&]()
         {
-            auto commit_crit = server_.get_commit_critical_section();
-            if (not params_.check_sequential_consistency) {
-                commit_crit.lock.unlock();
-            }
-
-            client_state_.append_data({&commit_crit.commit_seqno,
-                    sizeof(commit_crit.commit_seqno)});
-
-            wsrep::provider::seq_cb seq_cb {
-                &commit_crit,
-                release_commit_critical_section
-            };
-
-            assert(err == 0);
-            if (params_.do_2pc)
-            {
-                err = err || client_state_.before_prepare(&seq_cb);
-                err = err || client_state_.after_prepare();
-            }
-            err = err || client_state_.before_commit(&seq_cb);
-            if (err == 0)
-            {
-                se_trx_.commit(transaction.ws_meta().gtid());
-                if (params_.check_sequential_consistency)
-                {
-                    server_.check_sequential_consistency(
-                        client_state_.id(), commit_crit.commit_seqno);
-                }
-            }
-            err = err || client_state_.ordered_commit();
-            err = err || client_state_.after_commit();
-            if (err)
-            {
-                client_state_.before_rollback();
-                se_trx_.rollback();
-                client_state_.after_rollback();
-            }
-            return err;
+            return commit(kind == db::workload::k_xa);
         });
 
     assert(err ||
@@ -213,6 +206,216 @@ void db::client::run_one_transaction()
     }
 }
 
+int db::client::start_transaction(enum db::workload::kind kind)
+{
+    int err(client_state_.start_transaction(
+                wsrep::transaction_id(server_.next_transaction_id())));
+    assert(err == 0);
+    se_trx_.start(this);
+    log_.clear();
+    if (kind == db::workload::k_streaming)
+    {
+        err = client_state_.enable_streaming(wsrep::streaming_context::row,
+                                             params_.sr_fragment_rows);
+    }
+    else if (client_state_.transaction().streaming_context().fragment_size())
+    {
+        client_state_.disable_streaming();
+    }
+    // The payload is not modified before the next transaction
+    // starts, so it can be appended without copying.
+    const uint64_t id(client_state_.transaction().id().get());
+    ::memcpy(data_.data(), &id, std::min(sizeof(id), data_.size()));
+    return err;
+}
+
+int db::client::execute_statement(bool log_rows)
+{
+    int err(0);
+    for (size_t i(0); err == 0 && i < params_.rows_per_statement; ++i)
+    {
+        const db::workload::row_op op(workload_.next_row_op(random_engine_));
+        wsrep::key key(op.write ? wsrep::key::exclusive : wsrep::key::shared);
+        key.append_key_part("dbms", 4);
+        key.append_key_part(&op.key.space, sizeof(op.key.space));
+        key.append_key_part(&op.key.row, sizeof(op.key.row));
+        if (op.write == false)
+        {
+            se_trx_.read(op.key, read_buf_);
+            err = client_state_.append_key(key);
+            continue;
+        }
+
+        size_t bytes_to_append(data_.size());
+        if (params_.random_data_size)
+        {
+            bytes_to_append = std::uniform_int_distribution<size_t>(
+                1, data_.size())(random_engine_);
+        }
+        const wsrep::const_buffer data(data_.data(), bytes_to_append);
+        db::storage_engine::row_write row_write;
+        row_write.key = op.key;
+        row_write.size = bytes_to_append;
+        // Lock the row before appending the key, failure means
+        // that the transaction was BF aborted or deadlocked while
+        // waiting for the lock.
+        if (se_trx_.write(row_write.key, data))
+        {
+            rollback();
+            return 1;
+        }
+        err = client_state_.append_key(key);
+        if (err)
+        {
+            break;
+        }
+        if (log_rows)
+        {
+            const char* header(reinterpret_cast<const char*>(&row_write));
+            log_.insert(log_.end(), header, header + sizeof(row_write));
+            log_.insert(log_.end(), data.data(), data.data() + data.size());
+            err = client_state_.after_row();
+        }
+        else
+        {
+            err = client_state_.append_data({&row_write, sizeof(row_write)});
+            err = err || (params_.append_nocopy ?
+                          client_state_.append_data_nocopy(data) :
+                          client_state_.append_data(data));
+        }
+    }
+    return err;
+}
+
+int db::client::commit(bool xa)
+{
+    const wsrep::transaction& transaction(client_state_.transaction());
+    // Rows which have not been replicated in fragments yet
+    // go with the commit.
+    const size_t log_position(transaction.streaming_context().log_position());
+    // Certify phase lasts until before_commit() starts waiting for
+    // commit order, XA prepare is included.
+    const auto certify_start(std::chrono::steady_clock::now());
+    commit_order_enter_ = std::chrono::steady_clock::time_point();
+    int err(0);
+    if (xa && log_position < log_.size())
+    {
+        // XA prepare replicates the logged rows as a prepare fragment.
+        client_state_.assign_xid(
+            db::workload::xid(server_state_.id(), transaction.id()));
+        err = client_state_.before_prepare();
+        err = err || client_state_.after_prepare();
+    }
+    else if (log_position < log_.size())
+    {
+        err = client_state_.append_data(
+            {log_.data() + log_position, log_.size() - log_position});
+    }
+
+    // The commit of prepared XA transaction is certified without
+    // seq_cb, so the critical section would be held over commit order
+    // wait. XA transactions are left out of sequential consistency check.
+    const bool check_seq(params_.check_sequential_consistency &&
+                         transaction.is_xa() == false);
+    auto commit_crit = server_.get_commit_critical_section();
+    if (not check_seq) {
+        commit_crit.lock.unlock();
+    }
+
+    err = err || client_state_.append_data({&commit_crit.commit_seqno,
+                                            sizeof(commit_crit.commit_seqno)});
+
+    wsrep::provider::seq_cb seq_cb {
+        &commit_crit,
+        release_commit_critical_section
+    };
+
+    if (params_.do_2pc && transaction.is_xa() == false)
+    {
+        err = err || client_state_.before_prepare(&seq_cb);
+        err = err || client_state_.after_prepare();
+    }
+    err = err || client_state_.before_commit(&seq_cb);
+    if (err == 0)
+    {
+        const auto now(std::chrono::steady_clock::now());
+        if (commit_order_enter_ > certify_start)
+        {
+            latency_stats_.record(db::latency_stats::p_certify,
+                                  commit_order_enter_ - certify_start);
+            latency_stats_.record(db::latency_stats::p_commit_order,
+                                  now - commit_order_enter_);
+        }
+        else
+        {
+            latency_stats_.record(db::latency_stats::p_certify,
+                                  now - certify_start);
+        }
+        err = timed(db::latency_stats::p_ordered_commit, [&]()
+        {
+            se_trx_.commit(transaction.ws_meta().gtid());
+            if (check_seq)
+            {
+                server_.check_sequential_consistency(
+                    client_state_.id(), commit_crit.commit_seqno);
+            }
+            return client_state_.ordered_commit();
+        });
+    }
+    err = err || timed(db::latency_stats::p_after_commit, [&]()
+    {
+        return client_state_.after_commit();
+    });
+    if (err)
+    {
+        release_commit_critical_section(&commit_crit);
+        rollback();
+    }
+    return err;
+}
+
+void db::client::run_toi()
+{
+    // TOI statement is replicated and applied in total order,
+    // it does not touch the rows.
+    const db::workload::row_op op(workload_.next_row_op(random_engine_));
+    wsrep::key key(wsrep::key::exclusive);
+    key.append_key_part("dbms", 4);
+    key.append_key_part(&op.key.space, sizeof(op.key.space));
+    static const char ddl[] = "ALTER TABLE";
+    const wsrep::mutable_buffer err;
+    if (client_state_.before_command() == 0)
+    {
+        if (client_state_.enter_toi_local(wsrep::key_array{key},
+                                          wsrep::const_buffer(
+                                              ddl, sizeof(ddl))) == 0)
+        {
+            client_state_.leave_toi_local(err);
+            ++stats_.tois;
+        }
+    }
+    client_state_.after_command_before_result();
+    client_state_.after_command_after_result();
+}
+
+void db::client::rollback()
+{
+    client_state_.before_rollback();
+    se_trx_.rollback();
+    client_state_.after_rollback();
+}
+
+int db::client::prepare_fragment(wsrep::mutable_buffer& buffer,
+                                 size_t& position)
+{
+    const size_t start(
+        client_state_.transaction().streaming_context().log_position());
+    assert(start <= log_.size());
+    buffer.push_back(log_.data() + start, log_.data() + log_.size());
+    position = log_.size();
+    return 0;
+}
+
 void db::client::report_progress(size_t i) const
 {
     if ((i % 1000) == 0)
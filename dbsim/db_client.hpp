@@ -27,6 +27,8 @@
 #include "db_client_state.hpp"
 #include "db_client_service.hpp"
 #include "db_high_priority_service.hpp"
+#include "db_workload.hpp"
+#include "db_histogram.hpp"
 
 #include <random>
 
@@ -41,10 +43,12 @@ namespace db
             long long commits;
             long long rollbacks;
             long long replays;
+            long long tois;
             stats()
                 : commits(0)
                 , rollbacks(0)
                 , replays(0)
+                , tois(0)
             { }
         };
         client(db::server&,
@@ -53,6 +57,8 @@ namespace db
                const db::params&);
         bool bf_abort(wsrep::seqno);
         const struct stats stats() const { return stats_; }
+        const db::latency_stats& latency_stats() const
+        { return latency_stats_; }
         void store_globals()
         {
             client_state_.store_globals();
@@ -67,7 +73,17 @@ namespace db
         friend class db::client_service;
         friend class db::high_priority_service;
         template <class F> int client_command(F f);
+        template <class F> int timed(enum db::latency_stats::phase, F f);
         void run_one_transaction();
+        int start_transaction(enum db::workload::kind);
+        int execute_statement(bool log_rows);
+        int commit(bool xa);
+        void run_toi();
+        void rollback();
+        // Streaming and XA transactions log the rows into log_ and
+        // the log is replicated in fragments.
+        int prepare_fragment(wsrep::mutable_buffer&, size_t& position);
+        size_t bytes_generated() const { return log_.size(); }
         void reset_error();
         void report_progress(size_t) const;
         wsrep::default_mutex mutex_;
@@ -79,9 +95,16 @@ namespace db
         db::client_service client_service_;
         db::storage_engine::transaction se_trx_;
         wsrep::mutable_buffer data_;
+        std::vector<char> log_;
+        std::vector<char> read_buf_;
         std::random_device random_device_;
         std::default_random_engine random_engine_;
+        db::workload workload_;
         struct stats stats_;
+        db::latency_stats latency_stats_;
+        // Set by client_service::debug_sync() when before_commit()
+        // starts waiting for commit order.
+        std::chrono::steady_clock::time_point commit_order_enter_;
     };
 }
 
@@ -20,8 +20,10 @@
 #include "db_client_service.hpp"
 #include "db_high_priority_service.hpp"
 #include "db_client.hpp"
+#include "db_server.hpp"
 
 #include <cassert>
+#include <cstring>
 
 db::client_service::client_service(db::client& client)
     : wsrep::client_service()
@@ -29,6 +31,24 @@ db::client_service::client_service(db::client& client)
     , client_state_(client_.client_state())
 { }
 
+size_t db::client_service::bytes_generated() const
+{
+    return client_.bytes_generated();
+}
+
+int db::client_service::prepare_fragment_for_replication(
+    wsrep::mutable_buffer& buffer, size_t& position)
+{
+    return client_.prepare_fragment(buffer, position);
+}
+
+int db::client_service::remove_fragments()
+{
+    return client_.server_.fragment_store().remove(
+        client_.server_.server_state().id(),
+        client_state_.transaction().id());
+}
+
 int db::client_service::bf_rollback()
 {
     int ret(client_state_.before_rollback());
@@ -54,3 +74,13 @@ db::client_service::replay()
     }
     return ret;
 }
+
+void db::client_service::debug_sync(const char* sync_point)
+{
+    // Certification is over, the rest of before_commit() is
+    // commit order wait.
+    if (::strcmp(sync_point, "wsrep_before_commit_order_enter") == 0)
+    {
+        client_.commit_order_enter_ = std::chrono::steady_clock::now();
+    }
+}
@@ -43,21 +43,14 @@ namespace db
             return 0;
         }
         void cleanup_transaction() override { }
-        size_t bytes_generated() const override
-        {
-            return 0;
-        }
+        size_t bytes_generated() const override;
         bool statement_allowed_for_streaming() const override
         {
             return true;
         }
         int prepare_fragment_for_replication(wsrep::mutable_buffer&,
-                                             size_t& position) override
-        {
-            position = 0;
-            return 0;
-        }
-        int remove_fragments() override { return 0; }
+                                             size_t& position) override;
+        int remove_fragments() override;
         int bf_rollback() override;
         void will_replay() override { }
         void signal_replayed() override { }
@@ -92,7 +85,7 @@ namespace db
             return false;
         }
 
-        void debug_sync(const char*) override { }
+        void debug_sync(const char*) override;
         void debug_crash(const char*) override { }
         void notify_state_change() override { }
 
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "db_encryption.hpp"
+
+#include "wsrep/exception.hpp"
+#include "wsrep/logger.hpp"
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+    // Upper limit for pooled contexts, roughly the number of
+    // concurrent streams expected from the provider.
+    const size_t max_pooled = 64;
+
+    const EVP_CIPHER* cipher_for(size_t key_size)
+    {
+        switch (key_size)
+        {
+        case 16: return EVP_aes_128_ctr();
+        case 24: return EVP_aes_192_ctr();
+        case 32: return EVP_aes_256_ctr();
+        default: return nullptr;
+        }
+    }
+}
+
+struct db::encryption::context
+{
+    EVP_CIPHER_CTX* evp;
+    size_t generation;
+};
+
+db::encryption::encryption()
+    : mutex_()
+    , key_()
+    , generation_()
+    , pool_()
+    , contexts_created_()
+    , contexts_reused_()
+    , key_changes_()
+{ }
+
+db::encryption::~encryption()
+{
+    for (auto c : pool_)
+    {
+        EVP_CIPHER_CTX_free(c->evp);
+        delete c;
+    }
+}
+
+int db::encryption::do_crypt(void** ctx,
+                             wsrep::const_buffer& key,
+                             const char (*iv)[32],
+                             wsrep::const_buffer& input,
+                             void* output,
+                             bool,
+                             bool last)
+{
+    context* c(static_cast<context*>(*ctx));
+    if (c == nullptr)
+    {
+        if ((c = acquire(key)) == nullptr)
+        {
+            return -EINVAL;
+        }
+        // Setting only the IV keeps the expanded key and resets the
+        // counter.
+        if (EVP_EncryptInit_ex(c->evp, nullptr, nullptr, nullptr,
+                               reinterpret_cast<const unsigned char*>(*iv))
+            != 1)
+        {
+            release(c);
+            return -EINVAL;
+        }
+        *ctx = c;
+    }
+
+    int ret(0);
+    if (input.size() > size_t(INT_MAX))
+    {
+        ret = -EMSGSIZE;
+    }
+    else if (EVP_EncryptUpdate(c->evp, static_cast<unsigned char*>(output),
+                               &ret,
+                               reinterpret_cast<const unsigned char*>(
+                                   input.data()),
+                               int(input.size())) != 1)
+    {
+        ret = -EINVAL;
+    }
+
+    if (last || ret < 0)
+    {
+        // CTR mode does not buffer, there is nothing to finalize.
+        release(c);
+        *ctx = nullptr;
+    }
+    return ret;
+}
+
+std::vector<unsigned char> db::encryption::generate_key()
+{
+    std::vector<unsigned char> ret(32);
+    if (RAND_bytes(ret.data(), int(ret.size())) != 1)
+    {
+        throw wsrep::runtime_error("Failed to generate encryption key");
+    }
+    return ret;
+}
+
+size_t db::encryption::contexts_created() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return contexts_created_;
+}
+
+size_t db::encryption::contexts_reused() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return contexts_reused_;
+}
+
+size_t db::encryption::key_changes() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return key_changes_;
+}
+
+std::string db::encryption::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream oss;
+    oss << "Encryption stats:\n"
+        << "  contexts_created: " << contexts_created_ << "\n"
+        << "  contexts_reused: " << contexts_reused_ << "\n"
+        << "  key_changes: " << key_changes_ << "\n";
+    return oss.str();
+}
+
+db::encryption::context* db::encryption::acquire(
+    const wsrep::const_buffer& key)
+{
+    const EVP_CIPHER* cipher(cipher_for(key.size()));
+    if (cipher == nullptr)
+    {
+        wsrep::log_error() << "Invalid encryption key length " << key.size();
+        return nullptr;
+    }
+    const unsigned char* key_data(
+        reinterpret_cast<const unsigned char*>(key.data()));
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (key_.size() != key.size() ||
+        std::memcmp(key_.data(), key_data, key.size()))
+    {
+        if (key_.size()) ++key_changes_;
+        key_.assign(key_data, key_data + key.size());
+        ++generation_;
+        for (auto c : pool_)
+        {
+            EVP_CIPHER_CTX_free(c->evp);
+            delete c;
+        }
+        pool_.clear();
+    }
+    if (pool_.size())
+    {
+        context* ret(pool_.back());
+        pool_.pop_back();
+        ++contexts_reused_;
+        return ret;
+    }
+    const size_t generation(generation_);
+    ++contexts_created_;
+    lock.unlock();
+
+    context* ret(new context{EVP_CIPHER_CTX_new(), generation});
+    if (ret->evp == nullptr ||
+        EVP_EncryptInit_ex(ret->evp, cipher, nullptr, key_data, nullptr) != 1)
+    {
+        wsrep::log_error() << "Failed to initialize cipher context";
+        EVP_CIPHER_CTX_free(ret->evp);
+        delete ret;
+        return nullptr;
+    }
+    return ret;
+}
+
+void db::encryption::release(context* c)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (c->generation == generation_ && pool_.size() < max_pooled)
+        {
+            pool_.push_back(c);
+            return;
+        }
+    }
+    EVP_CIPHER_CTX_free(c->evp);
+    delete c;
+}
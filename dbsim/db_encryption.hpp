@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file db_encryption.hpp
+ *
+ * Reference encryption service using OpenSSL EVP AES-CTR.
+ *
+ * The provider calls do_crypt() for each buffer of an encrypted
+ * stream, passing the same ctx until the last buffer. The cipher
+ * context is stored in ctx for the duration of the stream, and
+ * returned into a pool after the last buffer. Pooled contexts keep
+ * the expanded key, so starting a new stream only sets the IV.
+ *
+ * The key is passed by the provider on each call. When it changes
+ * after server_state::set_encryption_key(), the pool is discarded
+ * and new contexts are created with the new key. Streams which were
+ * started with the old key complete with it.
+ *
+ * AES-128, AES-192 or AES-256 is selected by the key length. In CTR
+ * mode encryption and decryption are the same operation, so the
+ * contexts are shared between both directions.
+ */
+
+#ifndef WSREP_DB_ENCRYPTION_HPP
+#define WSREP_DB_ENCRYPTION_HPP
+
+#include "wsrep/encryption_service.hpp"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace db
+{
+    class encryption : public wsrep::encryption_service
+    {
+    public:
+        encryption();
+        ~encryption();
+
+        int do_crypt(void** ctx,
+                     wsrep::const_buffer& key,
+                     const char (*iv)[32],
+                     wsrep::const_buffer& input,
+                     void* output,
+                     bool encrypt,
+                     bool last) override;
+
+        bool encryption_enabled() override { return true; }
+
+        /**
+         * Generate random 256 bit key.
+         *
+         * @throw wsrep::runtime_error if random bytes are not available.
+         */
+        static std::vector<unsigned char> generate_key();
+
+        /** Number of cipher contexts created. */
+        size_t contexts_created() const;
+        /** Number of streams which reused a pooled context. */
+        size_t contexts_reused() const;
+        /** Number of key changes seen. */
+        size_t key_changes() const;
+        std::string stats() const;
+    private:
+        encryption(const encryption&) = delete;
+        encryption& operator=(const encryption&) = delete;
+
+        struct context;
+        // Return context for a new stream with key, nullptr on error.
+        context* acquire(const wsrep::const_buffer& key);
+        void release(context*);
+
+        mutable std::mutex mutex_;
+        std::vector<unsigned char> key_;
+        // Incremented on key change, contexts of older generations
+        // are not returned into the pool.
+        size_t generation_;
+        std::vector<context*> pool_;
+        size_t contexts_created_;
+        size_t contexts_reused_;
+        size_t key_changes_;
+    };
+}
+
+#endif // WSREP_DB_ENCRYPTION_HPP
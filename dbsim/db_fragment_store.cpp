@@ -0,0 +1,378 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "db_fragment_store.hpp"
+
+#include "wsrep/exception.hpp"
+#include "wsrep/logger.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const char magic[8] = { 'D', 'B', 'S', 'I', 'M', 'F', 'R', 'G' };
+    const size_t initial_capacity = 1 << 20;
+
+    enum record_type
+    {
+        // Zero filled space after the last record
+        r_none,
+        r_fragment,
+        r_remove
+    };
+
+    size_t align(size_t size) { return (size + 7) & ~size_t(7); }
+
+    std::string error_message(const std::string& what,
+                              const std::string& path)
+    {
+        return what + " '" + path + "': " + ::strerror(errno);
+    }
+}
+
+struct db::fragment_store::record_header
+{
+    uint32_t type; // Written last, see write()
+    uint32_t size; // Size of data following the header
+    unsigned char server_id[16];
+    uint64_t transaction_id;
+    int64_t seqno;
+    int32_t flags;
+    uint32_t pad;
+};
+
+db::fragment_store::fragment_store()
+    : mutex_()
+    , path_()
+    , fd_(-1)
+    , map_()
+    , capacity_()
+    , end_()
+    , live_()
+    , index_()
+    , appended_()
+    , fragments_()
+    , compactions_()
+{ }
+
+db::fragment_store::~fragment_store()
+{
+    unmap();
+    if (fd_ >= 0) ::close(fd_);
+}
+
+void db::fragment_store::open(const std::string& path, bool recover)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    path_ = path;
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | (recover ? 0 : O_TRUNC),
+                 0644);
+    if (fd_ < 0)
+    {
+        throw wsrep::runtime_error(
+            error_message("Failed to open fragment store", path));
+    }
+    struct stat st;
+    if (::fstat(fd_, &st))
+    {
+        throw wsrep::runtime_error(
+            error_message("Failed to stat fragment store", path));
+    }
+    const size_t size(static_cast<size_t>(st.st_size));
+    if (size >= sizeof(magic))
+    {
+        if (map(std::max(size, initial_capacity)) ||
+            std::memcmp(map_, magic, sizeof(magic)))
+        {
+            throw wsrep::runtime_error("Invalid fragment store '" + path + "'");
+        }
+        scan();
+    }
+    else
+    {
+        if (map(initial_capacity))
+        {
+            throw wsrep::runtime_error(
+                error_message("Failed to map fragment store", path));
+        }
+        std::memcpy(map_, magic, sizeof(magic));
+        end_ = sizeof(magic);
+    }
+}
+
+int db::fragment_store::append(const wsrep::ws_meta& ws_meta,
+                               const wsrep::const_buffer& data)
+{
+    record_header header;
+    std::memset(&header, 0, sizeof(header));
+    header.type = r_fragment;
+    header.size = static_cast<uint32_t>(data.size());
+    std::memcpy(header.server_id, ws_meta.server_id().data(),
+                sizeof(header.server_id));
+    header.transaction_id = ws_meta.transaction_id().get();
+    header.seqno = ws_meta.seqno().get();
+    header.flags = ws_meta.flags();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return write(header, data);
+}
+
+int db::fragment_store::remove(const wsrep::id& server_id,
+                               wsrep::transaction_id transaction_id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index_.find(key_type(server_id, transaction_id)) == index_.end())
+    {
+        return 0;
+    }
+    record_header header;
+    std::memset(&header, 0, sizeof(header));
+    header.type = r_remove;
+    std::memcpy(header.server_id, server_id.data(), sizeof(header.server_id));
+    header.transaction_id = transaction_id.get();
+    return write(header, wsrep::const_buffer());
+}
+
+std::vector<db::fragment_store::stored_transaction>
+db::fragment_store::transactions() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<stored_transaction> ret;
+    for (const auto& i : index_)
+    {
+        std::vector<fragment> fragments(i.second);
+        std::sort(fragments.begin(), fragments.end(),
+                  [](const fragment& a, const fragment& b)
+                  { return a.seqno < b.seqno; });
+        stored_transaction trx;
+        for (const auto& f : fragments)
+        {
+            record_header header;
+            std::memcpy(&header, map_ + f.offset, sizeof(header));
+            const char* data(map_ + f.offset + sizeof(header));
+            trx.meta.push_back(
+                wsrep::ws_meta(wsrep::gtid(wsrep::id(), f.seqno),
+                               wsrep::stid(i.first.first, i.first.second,
+                                           wsrep::client_id()),
+                               wsrep::seqno::undefined(), header.flags));
+            trx.data.push_back(std::vector<char>(data, data + header.size));
+        }
+        ret.push_back(std::move(trx));
+    }
+    return ret;
+}
+
+size_t db::fragment_store::appended() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return appended_;
+}
+
+size_t db::fragment_store::fragments() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fragments_;
+}
+
+size_t db::fragment_store::compactions() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return compactions_;
+}
+
+int db::fragment_store::write(const record_header& header,
+                              const wsrep::const_buffer& data)
+{
+    const size_t size(sizeof(header) + align(data.size()));
+    if (reserve(size))
+    {
+        return 1;
+    }
+    // The type is written last so that a partially written record
+    // terminates the log when it is scanned.
+    char* const pos(map_ + end_);
+    std::memcpy(pos + sizeof(header), data.data(), data.size());
+    std::memcpy(pos + sizeof(uint32_t),
+                reinterpret_cast<const char*>(&header) + sizeof(uint32_t),
+                sizeof(header) - sizeof(uint32_t));
+    std::memcpy(pos, &header.type, sizeof(uint32_t));
+
+    update_index(header, end_);
+    if (header.type == r_fragment) ++appended_;
+    end_ += size;
+    return 0;
+}
+
+void db::fragment_store::update_index(const record_header& header,
+                                      size_t offset)
+{
+    const key_type key(wsrep::id(header.server_id, sizeof(header.server_id)),
+                       wsrep::transaction_id(header.transaction_id));
+    if (header.type == r_fragment)
+    {
+        index_[key].push_back({offset, wsrep::seqno(header.seqno)});
+        live_ += sizeof(header) + align(header.size);
+        ++fragments_;
+    }
+    else
+    {
+        auto i(index_.find(key));
+        if (i != index_.end())
+        {
+            for (const auto& f : i->second)
+            {
+                record_header fh;
+                std::memcpy(&fh, map_ + f.offset, sizeof(fh));
+                live_ -= sizeof(fh) + align(fh.size);
+            }
+            fragments_ -= i->second.size();
+            index_.erase(i);
+        }
+    }
+}
+
+int db::fragment_store::reserve(size_t size)
+{
+    if (end_ + size <= capacity_)
+    {
+        return 0;
+    }
+    if (end_ - live_ >= end_ / 2 &&
+        sizeof(magic) + live_ + size <= capacity_ && compact() == 0)
+    {
+        return 0;
+    }
+    size_t capacity(capacity_ * 2);
+    while (end_ + size > capacity) capacity *= 2;
+    return map(capacity);
+}
+
+// Copy stored fragments into a new file which replaces the log.
+int db::fragment_store::compact()
+{
+    const std::string tmp_path(path_ + ".compact");
+    const int fd(::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644));
+    void* ptr(MAP_FAILED);
+    if (fd < 0 || ::ftruncate(fd, off_t(capacity_)) ||
+        (ptr = ::mmap(nullptr, capacity_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0)) == MAP_FAILED)
+    {
+        wsrep::log_warning() << error_message("Failed to compact", tmp_path);
+        if (fd >= 0) ::close(fd);
+        return 1;
+    }
+    char* const map(static_cast<char*>(ptr));
+    std::memcpy(map, magic, sizeof(magic));
+    std::vector<fragment*> fragments;
+    for (auto& i : index_)
+    {
+        for (auto& f : i.second) fragments.push_back(&f);
+    }
+    std::sort(fragments.begin(), fragments.end(),
+              [](const fragment* a, const fragment* b)
+              { return a->offset < b->offset; });
+    std::vector<size_t> offsets;
+    offsets.reserve(fragments.size());
+    size_t end(sizeof(magic));
+    for (auto f : fragments)
+    {
+        record_header header;
+        std::memcpy(&header, map_ + f->offset, sizeof(header));
+        const size_t size(sizeof(header) + align(header.size));
+        std::memcpy(map + end, map_ + f->offset, size);
+        offsets.push_back(end);
+        end += size;
+    }
+    if (::rename(tmp_path.c_str(), path_.c_str()))
+    {
+        wsrep::log_warning() << error_message("Failed to compact", path_);
+        ::munmap(map, capacity_);
+        ::close(fd);
+        return 1;
+    }
+    for (size_t i(0); i < fragments.size(); ++i)
+    {
+        fragments[i]->offset = offsets[i];
+    }
+    unmap();
+    ::close(fd_);
+    fd_ = fd;
+    map_ = map;
+    end_ = end;
+    ++compactions_;
+    return 0;
+}
+
+int db::fragment_store::map(size_t capacity)
+{
+    if (::ftruncate(fd_, off_t(capacity)))
+    {
+        return 1;
+    }
+    void* const ptr(::mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+                           MAP_SHARED, fd_, 0));
+    if (ptr == MAP_FAILED)
+    {
+        return 1;
+    }
+    unmap();
+    map_ = static_cast<char*>(ptr);
+    capacity_ = capacity;
+    return 0;
+}
+
+void db::fragment_store::unmap()
+{
+    if (map_)
+    {
+        ::munmap(map_, capacity_);
+        map_ = nullptr;
+    }
+}
+
+// Rebuild index from the log.
+void db::fragment_store::scan()
+{
+    end_ = sizeof(magic);
+    for (;;)
+    {
+        record_header header;
+        if (end_ + sizeof(header) > capacity_)
+        {
+            break;
+        }
+        std::memcpy(&header, map_ + end_, sizeof(header));
+        const size_t size(sizeof(header) + align(header.size));
+        if ((header.type != r_fragment && header.type != r_remove) ||
+            end_ + size > capacity_)
+        {
+            break;
+        }
+        update_index(header, end_);
+        end_ += size;
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file db_fragment_store.hpp
+ *
+ * Streaming replication fragment store.
+ *
+ * Fragments are appended into a memory mapped log file, removal of
+ * the fragments of a transaction appends a removal record. The log
+ * is compacted when it runs out of space and at least half of it is
+ * taken by removed fragments.
+ *
+ * The log is not synced to disk, but the mapping is shared, so the
+ * fragments survive killing the process. The fragments of the
+ * transactions which were not committed or rolled back are
+ * recovered on the next start with --sr-recover.
+ */
+
+#ifndef WSREP_DB_FRAGMENT_STORE_HPP
+#define WSREP_DB_FRAGMENT_STORE_HPP
+
+#include "wsrep/buffer.hpp"
+#include "wsrep/id.hpp"
+#include "wsrep/provider.hpp"
+#include "wsrep/transaction_id.hpp"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace db
+{
+    class fragment_store
+    {
+    public:
+        fragment_store();
+        ~fragment_store();
+
+        /**
+         * Open log file. The file is truncated unless recover
+         * is true, in which case the stored fragments are read
+         * from the file.
+         *
+         * @throw wsrep::runtime_error on failure.
+         */
+        void open(const std::string& path, bool recover);
+
+        /**
+         * Append fragment. Server id, transaction id, seqno and
+         * flags are taken from ws_meta.
+         *
+         * @return Zero on success, non-zero if the log could not
+         *         be extended.
+         */
+        int append(const wsrep::ws_meta& ws_meta,
+                   const wsrep::const_buffer& data);
+
+        /**
+         * Remove fragments of a transaction.
+         *
+         * @return Zero on success, non-zero if the log could not
+         *         be extended.
+         */
+        int remove(const wsrep::id& server_id,
+                   wsrep::transaction_id transaction_id);
+
+        /** Fragments of a stored transaction in seqno order. */
+        struct stored_transaction
+        {
+            std::vector<wsrep::ws_meta> meta;
+            std::vector<std::vector<char>> data;
+        };
+        /** Return copies of the stored transactions. */
+        std::vector<stored_transaction> transactions() const;
+
+        /** Number of fragments appended since open. */
+        size_t appended() const;
+        /** Number of fragments currently stored. */
+        size_t fragments() const;
+        size_t compactions() const;
+    private:
+        fragment_store(const fragment_store&) = delete;
+        fragment_store& operator=(const fragment_store&) = delete;
+
+        struct record_header;
+        struct fragment
+        {
+            size_t offset; // Offset of the record header
+            wsrep::seqno seqno;
+        };
+        typedef std::pair<wsrep::id, wsrep::transaction_id> key_type;
+
+        // Write record and add it to index. Called with mutex locked.
+        int write(const record_header&, const wsrep::const_buffer&);
+        void update_index(const record_header&, size_t offset);
+        // Make room for size bytes, compact or grow the log.
+        // Called with mutex locked.
+        int reserve(size_t size);
+        int compact();
+        int map(size_t size);
+        void unmap();
+        void scan();
+
+        mutable std::mutex mutex_;
+        std::string path_;
+        int fd_;
+        char* map_;
+        size_t capacity_;
+        size_t end_; // End of the last record
+        size_t live_; // Bytes taken by stored fragments
+        std::map<key_type, std::vector<fragment>> index_;
+        size_t appended_;
+        size_t fragments_;
+        size_t compactions_;
+    };
+}
+
+#endif // WSREP_DB_FRAGMENT_STORE_HPP
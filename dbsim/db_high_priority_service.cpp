@@ -20,6 +20,50 @@
 #include "db_high_priority_service.hpp"
 #include "db_server.hpp"
 #include "db_client.hpp"
+#include "db_workload.hpp"
+
+#include "wsrep/logger.hpp"
+
+namespace
+{
+    thread_local db::applier_stats* current_applier(nullptr);
+
+    // Accounts time spent in high priority service call as busy
+    // time of the current applier.
+    class busy_scope
+    {
+    public:
+        busy_scope()
+            : stats_(current_applier)
+            , start_(stats_ ? db::applier_stats::clock::now() :
+                     db::applier_stats::clock::time_point())
+        { }
+        ~busy_scope()
+        {
+            if (stats_)
+            {
+                stats_->busy_ns +=
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        db::applier_stats::clock::now() - start_).count();
+            }
+        }
+    private:
+        busy_scope(const busy_scope&);
+        busy_scope& operator=(const busy_scope&);
+        db::applier_stats* stats_;
+        db::applier_stats::clock::time_point start_;
+    };
+}
+
+db::applier_stats* db::applier_stats::current()
+{
+    return current_applier;
+}
+
+void db::applier_stats::current(applier_stats* stats)
+{
+    current_applier = stats;
+}
 
 db::high_priority_service::high_priority_service(
     db::server& server, db::client& client)
@@ -27,6 +71,9 @@ db::high_priority_service::high_priority_service(
     , server_(server)
     , client_(client)
     , commit_seqno_()
+    , remove_pending_()
+    , remove_server_id_()
+    , remove_transaction_id_()
 { }
 
 int db::high_priority_service::start_transaction(
@@ -46,21 +93,84 @@ const wsrep::transaction& db::high_priority_service::transaction() const
     return client_.client_state().transaction();
 }
 
-int db::high_priority_service::adopt_transaction(const wsrep::transaction&)
+int db::high_priority_service::adopt_transaction(
+    const wsrep::transaction& transaction)
 {
-    throw wsrep::not_implemented_error();
+    client_.client_state_.adopt_transaction(transaction);
+    if (transaction.state() == wsrep::transaction::s_prepared)
+    {
+        client_.client_state_.restore_xid(transaction.xid());
+    }
+    return 0;
 }
 
 int db::high_priority_service::apply_write_set(
-    const wsrep::ws_meta&,
+    const wsrep::ws_meta& ws_meta,
     const wsrep::const_buffer& buf,
     wsrep::mutable_buffer&)
 {
-    client_.se_trx_.start(&client_);
-    client_.se_trx_.apply(client_.client_state().transaction());
-    assert(buf.size() > sizeof(uint64_t));
-    ::memcpy(&commit_seqno_, buf.data() + buf.size() - sizeof(uint64_t),
-             sizeof(uint64_t));
+    busy_scope busy;
+    const auto start(std::chrono::steady_clock::now());
+    // Streaming transaction keeps the storage engine transaction
+    // open between fragments.
+    if (client_.se_trx_.active() == false)
+    {
+        client_.se_trx_.start(&client_);
+    }
+    // Write set data is row writes, followed by commit seqno
+    // in the commit fragment.
+    size_t rows_size(buf.size());
+    if (wsrep::commits_transaction(ws_meta.flags()))
+    {
+        assert(buf.size() >= sizeof(uint64_t));
+        rows_size -= sizeof(uint64_t);
+        ::memcpy(&commit_seqno_, buf.data() + rows_size, sizeof(uint64_t));
+    }
+    wsrep::client_state& client_state(client_.client_state_);
+    int ret(client_.se_trx_.apply(client_state.transaction(),
+                                  wsrep::const_buffer(buf.data(), rows_size)));
+    if (ret == 0 && wsrep::commits_transaction(ws_meta.flags()) == false)
+    {
+        client_state.fragment_applied(ws_meta.seqno());
+    }
+    if (ret == 0 && wsrep::prepares_transaction(ws_meta.flags()))
+    {
+        client_state.assign_xid(db::workload::xid(ws_meta.server_id(),
+                                                  ws_meta.transaction_id()));
+        ret = client_state.before_prepare() || client_state.after_prepare();
+    }
+    client_.latency_stats_.record(db::latency_stats::p_apply,
+                                  std::chrono::steady_clock::now() - start);
+    return ret;
+}
+
+int db::high_priority_service::append_fragment_and_commit(
+    const wsrep::ws_handle& ws_handle,
+    const wsrep::ws_meta& ws_meta,
+    const wsrep::const_buffer& data,
+    const wsrep::xid&)
+{
+    busy_scope busy;
+    wsrep::client_state& client_state(client_.client_state_);
+    int ret(client_state.start_transaction(ws_handle, ws_meta));
+    if (ret == 0 && server_.fragment_store().append(ws_meta, data))
+    {
+        wsrep::log_warning() << "Failed to store fragment " << ws_meta;
+    }
+    ret = ret || client_state.prepare_for_ordering(ws_handle, ws_meta, true);
+    ret = ret || client_state.before_commit();
+    ret = ret || client_state.ordered_commit();
+    ret = ret || client_state.after_commit();
+    event_applied();
+    return ret;
+}
+
+int db::high_priority_service::remove_fragments(
+    const wsrep::ws_meta& ws_meta)
+{
+    remove_pending_ = true;
+    remove_server_id_ = ws_meta.server_id();
+    remove_transaction_id_ = ws_meta.transaction_id();
     return 0;
 }
 
@@ -69,7 +179,10 @@ int db::high_priority_service::apply_toi(
     const wsrep::const_buffer&,
     wsrep::mutable_buffer&)
 {
-    throw wsrep::not_implemented_error();
+    busy_scope busy;
+    // TOI statements do not modify rows.
+    event_applied();
+    return 0;
 }
 
 int db::high_priority_service::apply_nbo_begin(
@@ -83,12 +196,25 @@ int db::high_priority_service::apply_nbo_begin(
 int db::high_priority_service::commit(const wsrep::ws_handle& ws_handle,
                                       const wsrep::ws_meta& ws_meta)
 {
+    busy_scope busy;
+    remove_pending_fragments();
+    if (ws_meta.seqno().is_undefined())
+    {
+        // Fragment removal of orphaned streaming transaction is not
+        // ordered, see server_state::close_orphaned_sr_transactions().
+        client_.client_state_.before_rollback();
+        client_.client_state_.after_rollback();
+        return 0;
+    }
     client_.client_state_.prepare_for_ordering(ws_handle, ws_meta, true);
     int ret(client_.client_state_.before_commit());
     if (ret == 0) client_.se_trx_.commit(ws_meta.gtid());
 
-    /* Local client session replaying. */
+    /* Local client session replaying. XA transactions are not
+     * checked, see db::client::commit(). */
     if (ws_meta.server_id() == server_.server_state().id()
+        && wsrep::commits_transaction(ws_meta.flags())
+        && client_.client_state_.transaction().is_xa() == false
         && client_.params_.check_sequential_consistency)
     {
         server_.check_sequential_consistency(ws_meta.client_id(),
@@ -96,21 +222,57 @@ int db::high_priority_service::commit(const wsrep::ws_handle& ws_handle,
     }
     ret = ret || client_.client_state_.ordered_commit();
     ret = ret || client_.client_state_.after_commit();
+    event_applied();
     return ret;
 }
 
 int db::high_priority_service::rollback(const wsrep::ws_handle& ws_handle,
                                         const wsrep::ws_meta& ws_meta)
 {
+    busy_scope busy;
+    remove_pending_ = false;
     client_.client_state_.prepare_for_ordering(ws_handle, ws_meta, false);
     int ret(client_.client_state_.before_rollback());
     assert(ret == 0);
     client_.se_trx_.rollback();
     ret = client_.client_state_.after_rollback();
     assert(ret == 0);
+    event_applied();
     return ret;
 }
 
+void db::high_priority_service::event_applied()
+{
+    db::applier_stats* stats(current_applier);
+    if (stats)
+    {
+        ++stats->applied;
+        if (stats->exit_requested)
+        {
+            stats->hps->must_exit_ = true;
+        }
+    }
+}
+
+void db::high_priority_service::remove_pending_fragments()
+{
+    if (remove_pending_)
+    {
+        remove_pending_ = false;
+        if (server_.fragment_store().remove(remove_server_id_,
+                                            remove_transaction_id_))
+        {
+            wsrep::log_warning() << "Failed to remove fragments of "
+                                 << remove_transaction_id_;
+        }
+    }
+}
+
+void db::high_priority_service::store_globals()
+{
+    client_.store_globals();
+}
+
 void db::high_priority_service::adopt_apply_error(wsrep::mutable_buffer& err)
 {
     client_.client_state_.adopt_apply_error(err);
@@ -126,6 +288,7 @@ int db::high_priority_service::log_dummy_write_set(
     const wsrep::ws_meta& ws_meta,
     wsrep::mutable_buffer& err)
 {
+    busy_scope busy;
     int ret(client_.client_state_.start_transaction(ws_handle, ws_meta));
     assert(ret == 0);
     if (ws_meta.ordered())
@@ -140,6 +303,7 @@ int db::high_priority_service::log_dummy_write_set(
         assert(ret == 0);
     }
     client_.client_state_.after_applying();
+    event_applied();
     return ret;
 }
 
@@ -147,3 +311,24 @@ bool db::high_priority_service::is_replaying() const
 {
     return false;
 }
+
+db::streaming_applier_service::streaming_applier_service(
+    db::server& server, std::unique_ptr<db::client> client)
+    : db::high_priority_service(server, *client)
+    , applier_client_(std::move(client))
+{
+    wsrep::client_state& client_state(applier_client_->client_state());
+    client_state.open(client_state.id());
+    client_state.before_command();
+}
+
+db::streaming_applier_service::~streaming_applier_service()
+{
+    wsrep::client_state& client_state(applier_client_->client_state());
+    client_state.store_globals();
+    server_.merge_latency_stats(applier_client_->latency_stats());
+    client_state.after_command_before_result();
+    client_state.after_command_after_result();
+    client_state.close();
+    client_state.cleanup();
+}
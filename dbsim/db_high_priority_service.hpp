@@ -22,10 +22,53 @@
 
 #include "wsrep/high_priority_service.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+
 namespace db
 {
     class server;
     class client;
+    class high_priority_service;
+
+    /**
+     * Statistics and control of an applier thread. The applier thread
+     * makes its stats current for the thread, so that the work done
+     * by all high priority services in the thread, including
+     * streaming appliers, is accounted to it.
+     */
+    struct applier_stats
+    {
+        typedef std::chrono::steady_clock clock;
+        applier_stats(size_t id_)
+            : id(id_)
+            , start(clock::now())
+            , stop()
+            , running(true)
+            , busy_ns()
+            , applied()
+            , exit_requested()
+            , hps()
+        { }
+        /** Stats of the applier running in calling thread or nullptr. */
+        static applier_stats* current();
+        static void current(applier_stats*);
+
+        size_t id;
+        clock::time_point start;
+        // Valid when running is false.
+        clock::time_point stop;
+        std::atomic<bool> running;
+        // Time spent in high priority service calls, including waits
+        // for row locks and commit order.
+        std::atomic<long long> busy_ns;
+        std::atomic<long long> applied;
+        // Applier exits after the next event it processes.
+        std::atomic<bool> exit_requested;
+        // High priority service passed to provider run_applier().
+        db::high_priority_service* hps;
+    };
     class high_priority_service : public wsrep::high_priority_service
     {
     public:
@@ -42,10 +85,8 @@ namespace db
             const wsrep::ws_handle&,
             const wsrep::ws_meta&,
             const wsrep::const_buffer&,
-            const wsrep::xid&) override
-        { return 0; }
-        int remove_fragments(const wsrep::ws_meta&) override
-        { return 0; }
+            const wsrep::xid&) override;
+        int remove_fragments(const wsrep::ws_meta&) override;
         int commit(const wsrep::ws_handle&, const wsrep::ws_meta&) override;
         int rollback(const wsrep::ws_handle&, const wsrep::ws_meta&) override;
         int apply_toi(const wsrep::ws_meta&, const wsrep::const_buffer&,
@@ -55,7 +96,7 @@ namespace db
             override;
         void adopt_apply_error(wsrep::mutable_buffer&) override;
         virtual void after_apply() override;
-        void store_globals() override { }
+        void store_globals() override;
         void reset_globals() override { }
         void switch_execution_context(wsrep::high_priority_service&) override
         { }
@@ -64,12 +105,23 @@ namespace db
                                 wsrep::mutable_buffer&) override;
         virtual bool is_replaying() const override;
         void debug_crash(const char*) override { }
+    protected:
+        // Account event applied to the current applier and make the
+        // applier exit if it was requested to.
+        void event_applied();
+        // Remove fragments from store if removal is pending.
+        void remove_pending_fragments();
+        db::server& server_;
+        db::client& client_;
     private:
         high_priority_service(const high_priority_service&);
         high_priority_service& operator=(const high_priority_service&);
-        db::server& server_;
-        db::client& client_;
         uint64_t commit_seqno_;
+        // Fragments of the transaction are removed from the store
+        // on commit.
+        bool remove_pending_;
+        wsrep::id remove_server_id_;
+        wsrep::transaction_id remove_transaction_id_;
     };
 
     class replayer_service : public db::high_priority_service
@@ -85,6 +137,20 @@ namespace db
         bool is_replaying() const override { return true; }
     };
 
+    /**
+     * Streaming applier owns a high priority client which holds
+     * the streaming transaction between fragments.
+     */
+    class streaming_applier_service : public db::high_priority_service
+    {
+    public:
+        streaming_applier_service(db::server& server,
+                                  std::unique_ptr<db::client> client);
+        ~streaming_applier_service();
+    private:
+        std::unique_ptr<db::client> applier_client_;
+    };
+
 }
 
 #endif // WSREP_DB_HIGH_PRIORITY_SERVICE_HPP
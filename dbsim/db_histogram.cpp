@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "db_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Number of sub buckets in each power of two range above the
+// exactly recorded values.
+static const size_t half_sub_buckets(size_t(1) << 6);
+
+db::histogram::histogram()
+    : counts_()
+    , count_()
+    , max_()
+{
+    static_assert(half_sub_buckets == (size_t(1) << (sub_bucket_bits - 1)),
+                  "Sub bucket count mismatch");
+}
+
+void db::histogram::record(uint64_t value)
+{
+    // Buckets are allocated on first record, histograms which are
+    // never used are cheap to construct.
+    if (counts_.empty())
+    {
+        counts_.resize(index((uint64_t(1) << max_bits) - 1) + 1);
+    }
+    ++counts_[index(value)];
+    ++count_;
+    max_ = std::max(max_, value);
+}
+
+void db::histogram::merge(const histogram& other)
+{
+    if (other.count_ == 0)
+    {
+        return;
+    }
+    counts_.resize(other.counts_.size());
+    for (size_t i(0); i < counts_.size(); ++i)
+    {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    max_ = std::max(max_, other.max_);
+}
+
+uint64_t db::histogram::percentile(double percentile) const
+{
+    if (count_ == 0)
+    {
+        return 0;
+    }
+    const uint64_t target(
+        std::max(uint64_t(1),
+                 static_cast<uint64_t>(
+                     std::ceil(percentile / 100. * double(count_)))));
+    uint64_t cumulative(0);
+    for (size_t i(0); i < counts_.size(); ++i)
+    {
+        cumulative += counts_[i];
+        if (cumulative >= target)
+        {
+            return std::min(highest_equivalent(i), max_);
+        }
+    }
+    return max_;
+}
+
+size_t db::histogram::index(uint64_t value)
+{
+    if (value < (uint64_t(1) << sub_bucket_bits))
+    {
+        return size_t(value);
+    }
+    value = std::min(value, (uint64_t(1) << max_bits) - 1);
+    const int magnitude(63 - __builtin_clzll(value));
+    const int shift(magnitude - sub_bucket_bits + 1);
+    return size_t(shift) * half_sub_buckets + size_t(value >> shift);
+}
+
+uint64_t db::histogram::highest_equivalent(size_t index)
+{
+    if (index < (size_t(1) << sub_bucket_bits))
+    {
+        return index;
+    }
+    const size_t shift(index / half_sub_buckets - 1);
+    const uint64_t top(index - shift * half_sub_buckets);
+    return ((top + 1) << shift) - 1;
+}
+
+const char* db::latency_stats::to_string(enum phase phase)
+{
+    switch (phase)
+    {
+    case p_start:          return "start";
+    case p_append:         return "append";
+    case p_certify:        return "certify";
+    case p_commit_order:   return "commit_order";
+    case p_ordered_commit: return "ordered_commit";
+    case p_after_commit:   return "after_commit";
+    case p_response:       return "response";
+    case p_apply:          return "apply";
+    }
+    return "unknown";
+}
+
+void db::latency_stats::merge(const latency_stats& other)
+{
+    for (int i(0); i < phases; ++i)
+    {
+        histograms_[i].merge(other.histograms_[i]);
+    }
+    if (steps_.size() < other.steps_.size())
+    {
+        steps_.resize(other.steps_.size());
+    }
+    for (size_t i(0); i < other.steps_.size(); ++i)
+    {
+        steps_[i].response.merge(other.steps_[i].response);
+        steps_[i].completed += other.steps_[i].completed;
+    }
+}
+
+static double to_us(uint64_t ns)
+{
+    return double(ns) / 1000.;
+}
+
+void db::latency_stats::print(std::ostream& os,
+                              const std::string& prefix) const
+{
+    for (int i(0); i < phases; ++i)
+    {
+        const db::histogram& h(histograms_[i]);
+        if (h.count() == 0) continue;
+        os << "\n" << prefix << to_string(static_cast<enum phase>(i))
+           << ": count " << h.count()
+           << " p50 " << to_us(h.percentile(50.))
+           << " p90 " << to_us(h.percentile(90.))
+           << " p99 " << to_us(h.percentile(99.))
+           << " p99.9 " << to_us(h.percentile(99.9))
+           << " max " << to_us(h.max())
+           << " us";
+    }
+}
+
+void db::latency_stats::print_json(std::ostream& os) const
+{
+    os << "{";
+    const char* sep("");
+    for (int i(0); i < phases; ++i)
+    {
+        const db::histogram& h(histograms_[i]);
+        if (h.count() == 0) continue;
+        os << sep << "\"" << to_string(static_cast<enum phase>(i)) << "\": {"
+           << "\"count\": " << h.count()
+           << ", \"p50_us\": " << to_us(h.percentile(50.))
+           << ", \"p90_us\": " << to_us(h.percentile(90.))
+           << ", \"p99_us\": " << to_us(h.percentile(99.))
+           << ", \"p99_9_us\": " << to_us(h.percentile(99.9))
+           << ", \"max_us\": " << to_us(h.max())
+           << "}";
+        sep = ", ";
+    }
+    os << "}";
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file db_histogram.hpp
+ *
+ * Latency histograms for transaction phases.
+ *
+ * The histograms are not thread safe. Each client and applier
+ * records into its own histograms, which are merged into server
+ * totals when the client or applier is done.
+ */
+
+#ifndef WSREP_DB_HISTOGRAM_HPP
+#define WSREP_DB_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace db
+{
+    /**
+     * Log-linear histogram in the style of HdrHistogram. Values
+     * below 2^sub_bucket_bits are recorded exactly, larger ones with
+     * relative precision of 2^-(sub_bucket_bits - 1). Values above
+     * 2^max_bits are recorded into the highest bucket, but the
+     * maximum is tracked exactly.
+     */
+    class histogram
+    {
+    public:
+        histogram();
+        void record(uint64_t value);
+        void merge(const histogram&);
+        uint64_t count() const { return count_; }
+        uint64_t max() const { return max_; }
+        /**
+         * Return the value at percentile (0-100). The value is the
+         * highest value which is equivalent to the bucket the
+         * percentile falls into, capped by the maximum.
+         */
+        uint64_t percentile(double) const;
+    private:
+        static const int sub_bucket_bits = 7;
+        static const int max_bits = 40;
+        static size_t index(uint64_t);
+        static uint64_t highest_equivalent(size_t);
+
+        std::vector<uint64_t> counts_;
+        uint64_t count_;
+        uint64_t max_;
+    };
+
+    /**
+     * Latencies of transaction processing phases.
+     */
+    class latency_stats
+    {
+    public:
+        enum phase
+        {
+            /* Client phases */
+            p_start,
+            p_append,
+            p_certify,
+            p_commit_order,
+            p_ordered_commit,
+            p_after_commit,
+            /* Whole transaction from the intended start time */
+            p_response,
+            /* Applier phases */
+            p_apply
+        };
+        static const int phases = p_apply + 1;
+
+        static const char* to_string(enum phase);
+
+        latency_stats()
+            : histograms_()
+            , steps_()
+        { }
+
+        void record(enum phase phase, std::chrono::steady_clock::duration d)
+        {
+            histograms_[phase].record(to_ns(d));
+        }
+        /**
+         * Open-loop load step. Response times are recorded for the
+         * step the transaction was intended to start in, completions
+         * for the step it completed in.
+         */
+        struct step
+        {
+            db::histogram response;
+            uint64_t completed;
+            step() : response(), completed() { }
+        };
+        void record_step(size_t intended_step, size_t completed_step,
+                         std::chrono::steady_clock::duration d)
+        {
+            const size_t n(std::max(intended_step, completed_step) + 1);
+            if (steps_.size() < n) steps_.resize(n);
+            steps_[intended_step].response.record(to_ns(d));
+            ++steps_[completed_step].completed;
+        }
+        void merge(const latency_stats&);
+        const db::histogram& get(enum phase phase) const
+        { return histograms_[phase]; }
+        db::histogram& get(enum phase phase)
+        { return histograms_[phase]; }
+        const std::vector<step>& steps() const { return steps_; }
+
+        /**
+         * Print p50/p90/p99/p99.9/max in microseconds, one line
+         * per phase which has samples.
+         */
+        void print(std::ostream&, const std::string& prefix) const;
+        /**
+         * Print phases as JSON object.
+         */
+        void print_json(std::ostream&) const;
+    private:
+        static uint64_t to_ns(std::chrono::steady_clock::duration d)
+        {
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    d).count());
+        }
+        db::histogram histograms_[phases];
+        std::vector<step> steps_;
+    };
+}
+
+#endif // WSREP_DB_HISTOGRAM_HPP
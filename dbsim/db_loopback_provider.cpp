@@ -0,0 +1,968 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "db_loopback_provider.hpp"
+
+#include "wsrep/server_state.hpp"
+#include "wsrep/high_priority_service.hpp"
+#include "wsrep/logger.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    // Purge certification index after this many certified write sets.
+    const size_t purge_interval = 1024;
+
+    std::string serialize_key(const wsrep::key& key)
+    {
+        std::string ret;
+        for (size_t i(0); i < key.size(); ++i)
+        {
+            const uint32_t len(
+                static_cast<uint32_t>(key.key_parts()[i].size()));
+            ret.append(reinterpret_cast<const char*>(&len), sizeof(len));
+            ret.append(key.key_parts()[i].data(), len);
+        }
+        return ret;
+    }
+
+    bool is_write_key(const wsrep::key& key)
+    {
+        return (key.type() == wsrep::key::update ||
+                key.type() == wsrep::key::exclusive);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                             Cluster                                      //
+//////////////////////////////////////////////////////////////////////////////
+
+void db::loopback_cluster::purge_index()
+{
+    long long min_committed(std::numeric_limits<long long>::max());
+    for (const auto* m : members_)
+    {
+        std::lock_guard<std::mutex> lock(m->mutex_);
+        min_committed = std::min(min_committed, m->last_left_);
+    }
+    for (auto i(index_.begin()); i != index_.end();)
+    {
+        if (i->second.sr_owner == nullptr &&
+            std::max(i->second.write_seqno, i->second.read_seqno)
+            <= min_committed)
+        {
+            i = index_.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+wsrep::view db::loopback_cluster::make_view(
+    const loopback_provider* member) const
+{
+    std::vector<wsrep::view::member> members;
+    ssize_t own_index(-1);
+    for (size_t i(0); i < members_.size(); ++i)
+    {
+        if (members_[i] == member) own_index = ssize_t(i);
+        members.push_back(
+            wsrep::view::member(members_[i]->id_,
+                                members_[i]->server_state_.name(), ""));
+    }
+    return wsrep::view(wsrep::gtid(group_id_, wsrep::seqno(last_seqno_)),
+                       wsrep::seqno(view_seqno_),
+                       wsrep::view::primary,
+                       member->capabilities(),
+                       own_index,
+                       4,
+                       members);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                             Provider                                     //
+//////////////////////////////////////////////////////////////////////////////
+
+db::loopback_provider::loopback_provider(wsrep::server_state& server_state,
+                                         loopback_cluster& cluster)
+    : wsrep::provider(server_state)
+    , cluster_(cluster)
+    , mutex_()
+    , cond_()
+    , id_(server_state.name())
+    , queue_()
+    , connected_()
+    , closed_()
+    , last_left_()
+    , cancelled_()
+    , trxs_()
+    , replicated_()
+    , cert_failures_()
+    , bf_aborts_()
+    , replays_()
+    , applied_()
+{ }
+
+db::loopback_provider::~loopback_provider()
+{
+    std::lock_guard<std::mutex> clock(cluster_.mutex_);
+    auto i(std::find(cluster_.members_.begin(), cluster_.members_.end(),
+                     this));
+    if (i != cluster_.members_.end())
+    {
+        cluster_.members_.erase(i);
+    }
+}
+
+enum wsrep::provider::status
+db::loopback_provider::connect(const std::string&,
+                               const std::string&,
+                               const std::string&,
+                               bool bootstrap)
+{
+    std::lock_guard<std::mutex> clock(cluster_.mutex_);
+    if (std::find(cluster_.members_.begin(), cluster_.members_.end(), this)
+        != cluster_.members_.end())
+    {
+        return error_not_allowed;
+    }
+    loopback_provider* donor(cluster_.members_.empty() ?
+                             nullptr : cluster_.members_.front());
+    if (donor == nullptr && bootstrap == false)
+    {
+        wsrep::log_error() << "Loopback cluster has no members to join";
+        return error_connection_failed;
+    }
+
+    const long long position(cluster_.last_seqno_);
+    cluster_.members_.push_back(this);
+    ++cluster_.view_seqno_;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connected_ = true;
+        closed_ = false;
+        // Joiner gets its position from state transfer.
+        if (donor == nullptr) last_left_ = position;
+    }
+
+    event connected(event::e_connected, position);
+    connected.view = cluster_.make_view(this);
+    enqueue(connected);
+    if (donor)
+    {
+        event sst(event::e_state_transfer, position);
+        sst.donor = donor;
+        enqueue(sst);
+    }
+    for (auto* m : cluster_.members_)
+    {
+        event view(event::e_view, position);
+        view.view = cluster_.make_view(m);
+        m->enqueue(view);
+    }
+    enqueue(event(event::e_sync, position));
+    return success;
+}
+
+int db::loopback_provider::disconnect()
+{
+    std::lock_guard<std::mutex> clock(cluster_.mutex_);
+    auto i(std::find(cluster_.members_.begin(), cluster_.members_.end(),
+                     this));
+    if (i == cluster_.members_.end())
+    {
+        return 1;
+    }
+    cluster_.members_.erase(i);
+    ++cluster_.view_seqno_;
+    const long long position(cluster_.last_seqno_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connected_ = false;
+    }
+
+    event final_view(event::e_final, position);
+    final_view.view = wsrep::view(
+        wsrep::gtid(cluster_.group_id_, wsrep::seqno(position)),
+        wsrep::seqno::undefined(),
+        wsrep::view::disconnected,
+        0,
+        -1,
+        0,
+        std::vector<wsrep::view::member>());
+    enqueue(final_view);
+    for (auto* m : cluster_.members_)
+    {
+        event view(event::e_view, position);
+        view.view = cluster_.make_view(m);
+        m->enqueue(view);
+    }
+    return 0;
+}
+
+int db::loopback_provider::capabilities() const
+{
+    return (capability::multi_master |
+            capability::certification |
+            capability::parallel_applying |
+            capability::transaction_replay |
+            capability::isolation |
+            capability::streaming);
+}
+
+enum wsrep::provider::status
+db::loopback_provider::run_applier(wsrep::high_priority_service* hps)
+{
+    assert(hps);
+    for (;;)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this]() { return (!queue_.empty() || closed_); });
+        if (queue_.empty())
+        {
+            return success;
+        }
+        const event ev(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+
+        if (handle(ev, *hps))
+        {
+            return error_fatal;
+        }
+        if (ev.type == event::e_final || hps->must_exit())
+        {
+            return success;
+        }
+    }
+}
+
+enum wsrep::provider::status
+db::loopback_provider::assign_read_view(wsrep::ws_handle& ws_handle,
+                                        const wsrep::gtid* gtid)
+{
+    trx& t(get_trx(ws_handle));
+    std::lock_guard<std::mutex> lock(mutex_);
+    t.read_view = (gtid ? gtid->seqno().get() : last_left_);
+    return success;
+}
+
+int db::loopback_provider::append_key(wsrep::ws_handle& ws_handle,
+                                      const wsrep::key& key)
+{
+    trx& t(get_trx(ws_handle));
+    t.keys.push_back(std::make_pair(serialize_key(key), is_write_key(key)));
+    return 0;
+}
+
+enum wsrep::provider::status
+db::loopback_provider::append_data(wsrep::ws_handle& ws_handle,
+                                   const wsrep::const_buffer& data)
+{
+    trx& t(get_trx(ws_handle));
+    t.data.insert(t.data.end(), data.data(), data.data() + data.size());
+    return success;
+}
+
+enum wsrep::provider::status
+db::loopback_provider::certify(wsrep::client_id client_id,
+                               wsrep::ws_handle& ws_handle,
+                               int flags,
+                               wsrep::ws_meta& ws_meta,
+                               const seq_cb_t* seq_cb)
+{
+    trx& t(get_trx(ws_handle));
+    wsrep::ws_meta meta;
+    bool certified;
+    {
+        std::lock_guard<std::mutex> clock(cluster_.mutex_);
+        long long last_seen;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (connected_ == false)
+            {
+                return error_connection_failed;
+            }
+            if (t.aborted)
+            {
+                ++cert_failures_;
+                return error_certification_failed;
+            }
+            last_seen = (t.read_view >= 0 ? t.read_view : last_left_);
+        }
+
+        const long long seqno(++cluster_.last_seqno_);
+        long long depends_on;
+        const bool fragment((flags & (flag::commit | flag::rollback)) == 0);
+        certified = certify_keys(t.keys, seqno, last_seen, depends_on,
+                                 &t, fragment);
+        // Keys of failed commit stay held until the rollback is
+        // replicated, see rollback(wsrep::transaction_id).
+        if (fragment == false && certified)
+        {
+            release_sr_keys(t, seqno);
+        }
+        // Fragments of a streaming transaction are applied in order.
+        depends_on = std::max(depends_on, t.last_fragment);
+        if (certified && fragment)
+        {
+            t.last_fragment = seqno;
+        }
+        if (flags & flag::pa_unsafe)
+        {
+            depends_on = seqno - 1;
+        }
+        meta = wsrep::ws_meta(
+            wsrep::gtid(cluster_.group_id_, wsrep::seqno(seqno)),
+            wsrep::stid(id_, ws_handle.transaction_id(), client_id),
+            wsrep::seqno(depends_on), flags);
+
+        if (certified)
+        {
+            auto ws(std::make_shared<write_set>());
+            ws->meta = meta;
+            ws->data = t.data;
+            replicate(ws);
+        }
+        else
+        {
+            // Failed streaming fragment does not go through commit
+            // order on this member either.
+            for (auto* m : cluster_.members_)
+            {
+                if (m != this || fragment) m->cancel(seqno);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        t.meta = meta;
+        t.certified = certified;
+    }
+
+    ws_meta = meta;
+    if (seq_cb)
+    {
+        seq_cb->fn(seq_cb->ctx);
+    }
+    if (certified)
+    {
+        ++replicated_;
+        return success;
+    }
+    ++cert_failures_;
+    return error_certification_failed;
+}
+
+enum wsrep::provider::status
+db::loopback_provider::bf_abort(wsrep::seqno bf_seqno,
+                                wsrep::transaction_id victim_id,
+                                wsrep::client_service&,
+                                wsrep::seqno& victim_seqno)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<trx>& t(trxs_[victim_id.get()]);
+    if (!t)
+    {
+        // Victim has not appended anything yet.
+        t.reset(new trx);
+    }
+    victim_seqno = t->meta.seqno();
+    if (t->meta.ordered())
+    {
+        // Failed, committing or replaying transactions can't be
+        // aborted, neither the ones which precede the aborter.
+        if (t->certified == false || t->committing || t->replaying ||
+            t->meta.seqno() < bf_seqno)
+        {
+            return error_not_allowed;
+        }
+    }
+    t->aborted = true;
+    ++bf_aborts_;
+    cond_.notify_all();
+    return success;
+}
+
+enum wsrep::provider::status
+db::loopback_provider::rollback(wsrep::transaction_id id)
+{
+    std::lock_guard<std::mutex> clock(cluster_.mutex_);
+    const long long seqno(++cluster_.last_seqno_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto i(trxs_.find(id.get()));
+        if (i != trxs_.end())
+        {
+            release_sr_keys(*i->second, seqno);
+        }
+    }
+    auto ws(std::make_shared<write_set>());
+    ws->meta = wsrep::ws_meta(
+        wsrep::gtid(cluster_.group_id_, wsrep::seqno(seqno)),
+        wsrep::stid(id_, id, wsrep::client_id()),
+        wsrep::seqno(seqno - 1),
+        flag::rollback | flag::pa_unsafe);
+    // Rollback event is delivered to all members, including this one.
+    event ev(event::e_apply, seqno);
+    ev.ws = ws;
+    for (auto* m : cluster_.members_)
+    {
+        m->enqueue(ev);
+    }
+    ++replicated_;
+    return success;
+}
+
+enum wsrep::provider::status
+db::loopback_provider::commit_order_enter(const wsrep::ws_handle& ws_handle,
+                                          const wsrep::ws_meta& ws_meta)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    trx* const t(find_trx(ws_handle));
+    for (;;)
+    {
+        // Report BF abort once, the following call comes from
+        // rollback and must go through the monitor. Streaming
+        // fragments are always committed, the abort is reported
+        // when the next fragment is certified.
+        if (t && t->aborted && t->certified && t->abort_reported == false &&
+            t->replaying == false &&
+            (ws_meta.flags() & (flag::commit | flag::rollback)))
+        {
+            t->abort_reported = true;
+            return error_bf_abort;
+        }
+        if (last_left_ + 1 >= ws_meta.seqno().get())
+        {
+            break;
+        }
+        cond_.wait(lock);
+    }
+    if (t) t->committing = true;
+    return success;
+}
+
+int db::loopback_provider::commit_order_leave(const wsrep::ws_handle&,
+                                              const wsrep::ws_meta& ws_meta,
+                                              const wsrep::mutable_buffer&)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    leave(lock, ws_meta.seqno().get());
+    return 0;
+}
+
+int db::loopback_provider::release(wsrep::ws_handle& ws_handle)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto i(trxs_.find(ws_handle.transaction_id().get()));
+    if (i == trxs_.end())
+    {
+        return 0;
+    }
+    trx& t(*i->second);
+    const int flags(t.meta.flags());
+    if (t.meta.ordered() && t.certified &&
+        (flags & (flag::commit | flag::rollback)) == 0)
+    {
+        // Streaming fragment, keep the transaction for the next one.
+        t.keys.clear();
+        t.data.clear();
+        t.read_view = -1;
+        t.meta = wsrep::ws_meta();
+        t.certified = false;
+        t.committing = false;
+        return 0;
+    }
+    if (t.sr_keys.empty() == false)
+    {
+        // Streaming transaction failed to commit, keep the keys
+        // held until rollback.
+        t.keys.clear();
+        t.data.clear();
+        t.meta = wsrep::ws_meta();
+        t.certified = false;
+        return 0;
+    }
+    trxs_.erase(i);
+    ws_handle = wsrep::ws_handle(ws_handle.transaction_id());
+    return 0;
+}
+
+enum wsrep::provider::status
+db::loopback_provider::replay(const wsrep::ws_handle& ws_handle,
+                              wsrep::high_priority_service* hps)
+{
+    trx* t;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        t = find_trx(ws_handle);
+        if (t == nullptr || t->meta.ordered() == false ||
+            t->certified == false)
+        {
+            return error_certification_failed;
+        }
+        t->aborted = false;
+        t->abort_reported = false;
+        t->replaying = true;
+    }
+    const wsrep::const_buffer data(t->data.data(), t->data.size());
+    if (hps->apply(ws_handle, t->meta, data))
+    {
+        wsrep::log_error() << "Failed to replay " << t->meta;
+        return error_fatal;
+    }
+    ++replays_;
+    return success;
+}
+
+enum wsrep::provider::status
+db::loopback_provider::enter_toi(wsrep::client_id client_id,
+                                 const wsrep::key_array& keys,
+                                 const wsrep::const_buffer& buffer,
+                                 wsrep::ws_meta& ws_meta,
+                                 int flags)
+{
+    if (!(wsrep::starts_transaction(flags) &&
+          wsrep::commits_transaction(flags)))
+    {
+        // Non-blocking operations are not supported.
+        return error_not_implemented;
+    }
+
+    std::vector<std::pair<std::string, bool> > toi_keys;
+    for (const auto& key : keys)
+    {
+        toi_keys.push_back(std::make_pair(serialize_key(key), true));
+    }
+
+    long long seqno;
+    {
+        std::lock_guard<std::mutex> clock(cluster_.mutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (connected_ == false)
+            {
+                return error_connection_failed;
+            }
+        }
+        seqno = ++cluster_.last_seqno_;
+        // TOI is never failed, certification only records the keys.
+        long long depends_on;
+        certify_keys(toi_keys, seqno, seqno, depends_on, nullptr, false);
+        auto ws(std::make_shared<write_set>());
+        ws->meta = wsrep::ws_meta(
+            wsrep::gtid(cluster_.group_id_, wsrep::seqno(seqno)),
+            wsrep::stid(id_, wsrep::transaction_id::undefined(), client_id),
+            wsrep::seqno(seqno - 1),
+            flags | flag::isolation);
+        ws->data.assign(buffer.data(), buffer.data() + buffer.size());
+        replicate(ws);
+        ws_meta = ws->meta;
+    }
+    ++replicated_;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    wait_position(lock, seqno - 1);
+    return success;
+}
+
+enum wsrep::provider::status
+db::loopback_provider::leave_toi(wsrep::client_id,
+                                 const wsrep::ws_meta& ws_meta,
+                                 const wsrep::mutable_buffer&)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    leave(lock, ws_meta.seqno().get());
+    return success;
+}
+
+std::pair<wsrep::gtid, enum wsrep::provider::status>
+db::loopback_provider::causal_read(int timeout) const
+{
+    long long target;
+    {
+        std::lock_guard<std::mutex> clock(cluster_.mutex_);
+        target = cluster_.last_seqno_;
+    }
+    const wsrep::gtid gtid(cluster_.group_id_, wsrep::seqno(target));
+    return std::make_pair(gtid, wait_for_gtid(gtid, timeout));
+}
+
+enum wsrep::provider::status
+db::loopback_provider::wait_for_gtid(const wsrep::gtid& gtid,
+                                     int timeout) const
+{
+    const long long target(gtid.seqno().get());
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto reached([this, target]() { return last_left_ >= target; });
+    if (timeout < 0)
+    {
+        cond_.wait(lock, reached);
+        return success;
+    }
+    return (cond_.wait_for(lock, std::chrono::seconds(timeout), reached) ?
+            success : error_unknown);
+}
+
+wsrep::gtid db::loopback_provider::last_committed_gtid() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return wsrep::gtid(cluster_.group_id_, wsrep::seqno(last_left_));
+}
+
+enum wsrep::provider::status
+db::loopback_provider::sst_sent(const wsrep::gtid&, int)
+{
+    std::lock_guard<std::mutex> clock(cluster_.mutex_);
+    enqueue(event(event::e_sync, cluster_.last_seqno_));
+    return success;
+}
+
+enum wsrep::provider::status
+db::loopback_provider::sst_received(const wsrep::gtid& gtid, int error)
+{
+    if (error || gtid.is_undefined())
+    {
+        wsrep::log_error() << "Loopback state transfer failed: " << error;
+        return error_fatal;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    advance(lock, gtid.seqno().get());
+    return success;
+}
+
+std::vector<wsrep::provider::status_variable>
+db::loopback_provider::status() const
+{
+    std::vector<status_variable> ret;
+    ret.push_back(status_variable("loopback_replicated",
+                                  std::to_string(replicated_.load())));
+    ret.push_back(status_variable("loopback_cert_failures",
+                                  std::to_string(cert_failures_.load())));
+    ret.push_back(status_variable("loopback_bf_aborts",
+                                  std::to_string(bf_aborts_.load())));
+    ret.push_back(status_variable("loopback_replays",
+                                  std::to_string(replays_.load())));
+    ret.push_back(status_variable("loopback_applied",
+                                  std::to_string(applied_.load())));
+    ret.push_back(status_variable("loopback_last_committed",
+                                  std::to_string(
+                                      last_committed_gtid().seqno().get())));
+    return ret;
+}
+
+void db::loopback_provider::reset_status()
+{
+    replicated_ = 0;
+    cert_failures_ = 0;
+    bf_aborts_ = 0;
+    replays_ = 0;
+    applied_ = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                              Private                                     //
+//////////////////////////////////////////////////////////////////////////////
+
+db::loopback_provider::trx&
+db::loopback_provider::get_trx(wsrep::ws_handle& ws_handle)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<trx>& t(trxs_[ws_handle.transaction_id().get()]);
+    if (!t)
+    {
+        t.reset(new trx);
+    }
+    if (ws_handle.opaque() == nullptr)
+    {
+        ws_handle = wsrep::ws_handle(ws_handle.transaction_id(), t.get());
+    }
+    return *t;
+}
+
+db::loopback_provider::trx*
+db::loopback_provider::find_trx(const wsrep::ws_handle& ws_handle) const
+{
+    // Write sets delivered to appliers have null opaque, transaction
+    // ids from other members may collide with local ones.
+    if (ws_handle.opaque() == nullptr)
+    {
+        return nullptr;
+    }
+    auto i(trxs_.find(ws_handle.transaction_id().get()));
+    return ((i == trxs_.end() || i->second.get() != ws_handle.opaque()) ?
+            nullptr : i->second.get());
+}
+
+bool db::loopback_provider::certify_keys(
+    const std::vector<std::pair<std::string, bool> >& keys,
+    long long seqno,
+    long long last_seen,
+    long long& depends_on,
+    trx* sr_trx,
+    bool fragment)
+{
+    depends_on = 0;
+    for (const auto& key : keys)
+    {
+        auto i(cluster_.index_.find(key.first));
+        if (i == cluster_.index_.end())
+        {
+            continue;
+        }
+        const loopback_cluster::cert_entry& e(i->second);
+        // Write set conflicts with newer write from other member,
+        // write key also with newer read from other member.
+        if ((e.write_seqno > last_seen && e.write_source != this) ||
+            (key.second && e.read_seqno > last_seen && e.read_source != this))
+        {
+            return false;
+        }
+        // Rows written by a streaming transaction stay locked in
+        // streaming appliers until the transaction commits. Applier
+        // of conflicting write set would wait for the commit which is
+        // ordered after it.
+        if (key.second && e.sr_owner && e.sr_owner != sr_trx)
+        {
+            return false;
+        }
+        depends_on = std::max(depends_on, e.write_seqno);
+        if (key.second)
+        {
+            depends_on = std::max(depends_on, e.read_seqno);
+        }
+    }
+
+    for (const auto& key : keys)
+    {
+        loopback_cluster::cert_entry& e(cluster_.index_[key.first]);
+        if (key.second)
+        {
+            e.write_seqno = seqno;
+            e.write_source = this;
+            if (fragment && e.sr_owner == nullptr)
+            {
+                e.sr_owner = sr_trx;
+                sr_trx->sr_keys.push_back(key.first);
+            }
+        }
+        else
+        {
+            e.read_seqno = seqno;
+            e.read_source = this;
+        }
+    }
+    if (++cluster_.certified_ % purge_interval == 0)
+    {
+        cluster_.purge_index();
+    }
+    return true;
+}
+
+void db::loopback_provider::release_sr_keys(trx& t, long long seqno)
+{
+    // Rows stay locked in streaming appliers until the commit or
+    // rollback event at seqno is applied, following conflicting
+    // write sets must depend on it.
+    for (const auto& key : t.sr_keys)
+    {
+        auto i(cluster_.index_.find(key));
+        if (i != cluster_.index_.end() && i->second.sr_owner == &t)
+        {
+            i->second.sr_owner = nullptr;
+            i->second.write_seqno = std::max(i->second.write_seqno, seqno);
+            i->second.write_source = this;
+        }
+    }
+    t.sr_keys.clear();
+}
+
+void db::loopback_provider::replicate(
+    const std::shared_ptr<const write_set>& ws)
+{
+    event ev(event::e_apply, ws->meta.seqno().get());
+    ev.ws = ws;
+    for (auto* m : cluster_.members_)
+    {
+        if (m != this) m->enqueue(ev);
+    }
+}
+
+wsrep::gtid db::loopback_provider::reserve_seqnos(size_t n)
+{
+    std::lock_guard<std::mutex> clock(cluster_.mutex_);
+    const long long first(cluster_.last_seqno_ + 1);
+    cluster_.last_seqno_ += static_cast<long long>(n);
+    return wsrep::gtid(cluster_.group_id_, wsrep::seqno(first));
+}
+
+void db::loopback_provider::inject(const wsrep::ws_meta& meta,
+                                   std::vector<char> data)
+{
+    auto ws(std::make_shared<write_set>());
+    ws->meta = meta;
+    ws->data.swap(data);
+    event ev(event::e_apply, meta.seqno().get());
+    ev.ws = ws;
+    enqueue(ev);
+}
+
+void db::loopback_provider::wait_committed(long long seqno) const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    wait_position(lock, seqno);
+}
+
+long long db::loopback_provider::rollback_streaming(
+    const wsrep::id& server_id, wsrep::transaction_id id)
+{
+    std::lock_guard<std::mutex> clock(cluster_.mutex_);
+    const long long seqno(++cluster_.last_seqno_);
+    auto ws(std::make_shared<write_set>());
+    ws->meta = wsrep::ws_meta(
+        wsrep::gtid(cluster_.group_id_, wsrep::seqno(seqno)),
+        wsrep::stid(server_id, id, wsrep::client_id()),
+        wsrep::seqno(seqno - 1),
+        flag::rollback | flag::pa_unsafe);
+    event ev(event::e_apply, seqno);
+    ev.ws = ws;
+    for (auto* m : cluster_.members_)
+    {
+        if (m == this) m->enqueue(ev);
+        else m->cancel(seqno);
+    }
+    return seqno;
+}
+
+void db::loopback_provider::enqueue(const event& ev)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(ev);
+    cond_.notify_all();
+}
+
+void db::loopback_provider::wait_position(
+    std::unique_lock<std::mutex>& lock, long long position) const
+{
+    cond_.wait(lock, [this, position]() { return last_left_ >= position; });
+}
+
+void db::loopback_provider::leave(std::unique_lock<std::mutex>& lock,
+                                  long long seqno)
+{
+    assert(last_left_ + 1 == seqno);
+    advance(lock, seqno);
+}
+
+void db::loopback_provider::cancel(long long seqno)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cancelled_.insert(seqno);
+    advance(lock, last_left_);
+}
+
+void db::loopback_provider::advance(std::unique_lock<std::mutex>&,
+                                    long long position)
+{
+    last_left_ = std::max(last_left_, position);
+    while (cancelled_.empty() == false &&
+           *cancelled_.begin() <= last_left_ + 1)
+    {
+        last_left_ = std::max(last_left_, *cancelled_.begin());
+        cancelled_.erase(cancelled_.begin());
+    }
+    cond_.notify_all();
+}
+
+int db::loopback_provider::handle(const event& ev,
+                                  wsrep::high_priority_service& hps)
+{
+    switch (ev.type)
+    {
+    case event::e_connected:
+        server_state_.on_connect(ev.view);
+        break;
+    case event::e_state_transfer:
+    {
+        const std::string request(server_state_.prepare_for_sst());
+        {
+            std::unique_lock<std::mutex> lock(ev.donor->mutex_);
+            ev.donor->wait_position(lock, ev.position);
+        }
+        const wsrep::gtid gtid(cluster_.group_id_, wsrep::seqno(ev.position));
+        if (ev.donor->server_state_.start_sst(request, gtid, false))
+        {
+            wsrep::log_error() << "Failed to start state transfer from "
+                               << ev.donor->id_;
+            return 1;
+        }
+        break;
+    }
+    case event::e_view:
+    case event::e_final:
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wait_position(lock, ev.position);
+        }
+        server_state_.on_view(ev.view, &hps);
+        if (ev.type == event::e_final)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            cond_.notify_all();
+        }
+        break;
+    }
+    case event::e_sync:
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wait_position(lock, ev.position);
+        }
+        server_state_.on_sync();
+        break;
+    }
+    case event::e_apply:
+    {
+        const write_set& ws(*ev.ws);
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wait_position(lock, ws.meta.depends_on().get());
+        }
+        const wsrep::ws_handle ws_handle(ws.meta.transaction_id(), nullptr);
+        const wsrep::const_buffer data(ws.data.data(), ws.data.size());
+        if (hps.apply(ws_handle, ws.meta, data))
+        {
+            wsrep::log_error() << "Failed to apply write set " << ws.meta;
+            return 1;
+        }
+        ++applied_;
+        break;
+    }
+    }
+    return 0;
+}
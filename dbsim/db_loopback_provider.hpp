@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file db_loopback_provider.hpp
+ *
+ * In-process provider which simulates a cluster of dbsim servers
+ * without network or Galera library. All servers of the simulator
+ * share a single db::loopback_cluster which implements total order
+ * sequencer and certification. Each server gets its own
+ * db::loopback_provider which implements commit order monitor and
+ * delivers ordered events to the server appliers.
+ */
+
+#ifndef WSREP_DB_LOOPBACK_PROVIDER_HPP
+#define WSREP_DB_LOOPBACK_PROVIDER_HPP
+
+#include "wsrep/provider.hpp"
+#include "wsrep/view.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace db
+{
+    class loopback_provider;
+
+    /**
+     * State shared by all loopback providers: global seqno,
+     * certification index and cluster membership.
+     */
+    class loopback_cluster
+    {
+    public:
+        loopback_cluster()
+            : mutex_()
+            , group_id_("loopback")
+            , last_seqno_()
+            , view_seqno_()
+            , members_()
+            , index_()
+            , certified_()
+        { }
+    private:
+        friend class loopback_provider;
+
+        loopback_cluster(const loopback_cluster&);
+        loopback_cluster& operator=(const loopback_cluster&);
+
+        struct cert_entry
+        {
+            long long write_seqno;
+            long long read_seqno;
+            const loopback_provider* write_source;
+            const loopback_provider* read_source;
+            // Streaming transaction which has written the key in
+            // a fragment and has not committed or rolled back yet.
+            const void* sr_owner;
+        };
+
+        // Remove entries which are committed on all members.
+        void purge_index();
+        wsrep::view make_view(const loopback_provider*) const;
+
+        std::mutex mutex_;
+        wsrep::id group_id_;
+        long long last_seqno_;
+        long long view_seqno_;
+        std::vector<loopback_provider*> members_;
+        std::unordered_map<std::string, cert_entry> index_;
+        size_t certified_;
+    };
+
+    class loopback_provider : public wsrep::provider
+    {
+    public:
+        loopback_provider(wsrep::server_state&, loopback_cluster&);
+        ~loopback_provider() override;
+
+        enum wsrep::provider::status
+        connect(const std::string&, const std::string&, const std::string&,
+                bool) override;
+        int disconnect() override;
+        int capabilities() const override;
+
+        int desync() override { return 0; }
+        int resync() override { return 0; }
+        wsrep::seqno pause() override { return wsrep::seqno::undefined(); }
+        int resume() override { return 0; }
+
+        enum wsrep::provider::status
+        run_applier(wsrep::high_priority_service*) override;
+
+        int start_transaction(wsrep::ws_handle&) override { return 0; }
+        enum wsrep::provider::status
+        assign_read_view(wsrep::ws_handle&, const wsrep::gtid*) override;
+        int append_key(wsrep::ws_handle&, const wsrep::key&) override;
+        enum wsrep::provider::status
+        append_data(wsrep::ws_handle&, const wsrep::const_buffer&) override;
+        enum wsrep::provider::status
+        certify(wsrep::client_id, wsrep::ws_handle&, int, wsrep::ws_meta&,
+                const seq_cb_t*) override;
+        enum wsrep::provider::status
+        bf_abort(wsrep::seqno, wsrep::transaction_id, wsrep::client_service&,
+                 wsrep::seqno&) override;
+        enum wsrep::provider::status
+        rollback(wsrep::transaction_id) override;
+        enum wsrep::provider::status
+        commit_order_enter(const wsrep::ws_handle&,
+                           const wsrep::ws_meta&) override;
+        int commit_order_leave(const wsrep::ws_handle&, const wsrep::ws_meta&,
+                               const wsrep::mutable_buffer&) override;
+        int release(wsrep::ws_handle&) override;
+        enum wsrep::provider::status
+        replay(const wsrep::ws_handle&,
+               wsrep::high_priority_service*) override;
+
+        enum wsrep::provider::status
+        enter_toi(wsrep::client_id, const wsrep::key_array&,
+                  const wsrep::const_buffer&, wsrep::ws_meta&,
+                  int) override;
+        enum wsrep::provider::status
+        leave_toi(wsrep::client_id, const wsrep::ws_meta&,
+                  const wsrep::mutable_buffer&) override;
+
+        std::pair<wsrep::gtid, enum wsrep::provider::status>
+        causal_read(int) const override;
+        enum wsrep::provider::status
+        wait_for_gtid(const wsrep::gtid&, int) const override;
+        wsrep::gtid last_committed_gtid() const override;
+        enum wsrep::provider::status
+        sst_sent(const wsrep::gtid&, int) override;
+        enum wsrep::provider::status
+        sst_received(const wsrep::gtid&, int) override;
+        enum wsrep::provider::status
+        enc_set_key(const wsrep::const_buffer&) override
+        { return success; }
+
+        std::vector<status_variable> status() const override;
+        void reset_status() override;
+        std::string options() const override { return ""; }
+        enum wsrep::provider::status
+        options(const std::string&) override { return success; }
+        enum wsrep::provider::status
+        set_node_isolation(enum node_isolation) override
+        { return error_not_implemented; }
+
+        std::string name() const override { return "loopback"; }
+        std::string version() const override { return "1.0"; }
+        std::string vendor() const override { return "Codership Oy"; }
+        void* native() const override { return nullptr; }
+
+        /* Write set replay, see db::ws_replay */
+
+        /**
+         * Reserve n consecutive seqnos for injected write sets and
+         * return GTID of the first one.
+         */
+        wsrep::gtid reserve_seqnos(size_t n);
+        /**
+         * Deliver write set to the appliers of this member only. The
+         * seqno must have been reserved with reserve_seqnos().
+         */
+        void inject(const wsrep::ws_meta&, std::vector<char> data);
+        /** Wait until events up to seqno have been committed. */
+        void wait_committed(long long seqno) const;
+
+        /**
+         * Roll back streaming transaction recovered from the fragment
+         * store of this member. The rollback event is delivered to
+         * this member only, the other members skip the seqno.
+         *
+         * @return Seqno of the rollback event.
+         */
+        long long rollback_streaming(const wsrep::id& server_id,
+                                     wsrep::transaction_id id);
+    private:
+        friend class loopback_cluster;
+
+        loopback_provider(const loopback_provider&);
+        loopback_provider& operator=(const loopback_provider&);
+
+        // Write set delivered to other members
+        struct write_set
+        {
+            wsrep::ws_meta meta;
+            std::vector<char> data;
+        };
+
+        // Local transaction
+        struct trx
+        {
+            trx()
+                : keys()
+                , data()
+                , read_view(-1)
+                , meta()
+                , certified()
+                , aborted()
+                , abort_reported()
+                , committing()
+                , replaying()
+                , sr_keys()
+                , last_fragment()
+            { }
+            // Serialized key and write flag
+            std::vector<std::pair<std::string, bool> > keys;
+            std::vector<char> data;
+            long long read_view;
+            wsrep::ws_meta meta;
+            bool certified;
+            bool aborted;
+            bool abort_reported;
+            bool committing;
+            bool replaying;
+            // Write keys held by certified streaming fragments
+            std::vector<std::string> sr_keys;
+            // Seqno of the last certified streaming fragment, the next
+            // fragment depends on it
+            long long last_fragment;
+        };
+
+        struct event
+        {
+            enum type
+            {
+                e_connected,
+                e_state_transfer,
+                e_view,
+                e_sync,
+                e_apply,
+                e_final
+            };
+            event(enum type t, long long pos)
+                : type(t)
+                , position(pos)
+                , view()
+                , ws()
+                , donor()
+            { }
+            enum type type;
+            long long position;
+            wsrep::view view;
+            std::shared_ptr<const write_set> ws;
+            loopback_provider* donor;
+        };
+
+        trx& get_trx(wsrep::ws_handle&);
+        trx* find_trx(const wsrep::ws_handle&) const;
+
+        // Certify keys against the certification index and record them
+        // if the certification passes. Write keys of a streaming
+        // fragment are held for the transaction sr_trx until it
+        // commits or rolls back. Called with cluster mutex locked.
+        bool certify_keys(const std::vector<std::pair<std::string, bool> >&,
+                          long long seqno, long long last_seen,
+                          long long& depends_on,
+                          trx* sr_trx, bool fragment);
+        // Release keys held by streaming transaction.
+        // Called with cluster mutex locked.
+        void release_sr_keys(trx&, long long seqno);
+        // Deliver write set to all members except this.
+        // Called with cluster mutex locked.
+        void replicate(const std::shared_ptr<const write_set>&);
+        void enqueue(const event&);
+
+        // Commit order monitor
+        void wait_position(std::unique_lock<std::mutex>&, long long) const;
+        void leave(std::unique_lock<std::mutex>&, long long);
+        void cancel(long long);
+        void advance(std::unique_lock<std::mutex>&, long long);
+
+        int handle(const event&, wsrep::high_priority_service&);
+
+        loopback_cluster& cluster_;
+        mutable std::mutex mutex_;
+        mutable std::condition_variable cond_;
+        wsrep::id id_;
+        std::deque<event> queue_;
+        bool connected_;
+        bool closed_;
+        long long last_left_;
+        std::set<long long> cancelled_;
+        std::unordered_map<unsigned long long, std::unique_ptr<trx> > trxs_;
+        std::atomic<long long> replicated_;
+        std::atomic<long long> cert_failures_;
+        std::atomic<long long> bf_aborts_;
+        std::atomic<long long> replays_;
+        std::atomic<long long> applied_;
+    };
+}
+
+#endif // WSREP_DB_LOOPBACK_PROVIDER_HPP
@@ -18,13 +18,76 @@
  */
 
 #include "db_params.hpp"
+#include "db_threads.hpp"
 
 #include <boost/program_options.hpp>
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 
 namespace
 {
+    // Parse comma separated list of <seconds>:<appliers>.
+    std::vector<std::pair<double, size_t>>
+    parse_applier_schedule(const std::string& str)
+    {
+        std::vector<std::pair<double, size_t>> ret;
+        std::istringstream is(str);
+        std::string entry;
+        while (std::getline(is, entry, ','))
+        {
+            std::istringstream es(entry);
+            double seconds;
+            char delim;
+            size_t appliers;
+            if (!(es >> seconds >> delim >> appliers) || delim != ':' ||
+                seconds < 0 || appliers == 0 ||
+                (ret.size() && ret.back().first > seconds))
+            {
+                throw std::invalid_argument(
+                    "Error: invalid --applier-schedule entry " + entry);
+            }
+            ret.push_back(std::make_pair(seconds, appliers));
+        }
+        return ret;
+    }
+
+    // Parse semicolon separated list of <name>=<cpulist> or
+    // <name>=node<N>.
+    std::vector<std::pair<std::string, wsrep::thread_service::placement>>
+    parse_thread_placement(const std::string& str)
+    {
+        std::vector<std::pair<std::string,
+                              wsrep::thread_service::placement>> ret;
+        std::istringstream is(str);
+        std::string entry;
+        while (std::getline(is, entry, ';'))
+        {
+            const size_t eq(entry.find('='));
+            wsrep::thread_service::placement placement;
+            const std::string value(eq == std::string::npos ? "" :
+                                    entry.substr(eq + 1));
+            bool valid(eq != std::string::npos && eq > 0);
+            if (valid && value.compare(0, 4, "node") == 0)
+            {
+                std::istringstream vs(value.substr(4));
+                valid = (vs >> placement.numa_node) && vs.eof() &&
+                    placement.numa_node >= 0;
+            }
+            else if (valid)
+            {
+                valid = db::ti::parse_cpu_list(value, placement.cpus) == 0;
+            }
+            if (not valid)
+            {
+                throw std::invalid_argument(
+                    "Error: invalid --thread-placement entry " + entry);
+            }
+            ret.push_back(std::make_pair(entry.substr(0, eq), placement));
+        }
+        return ret;
+    }
+
     void validate_params(const db::params& params)
     {
         std::ostringstream os;
@@ -37,6 +100,64 @@ namespace
                    << params.n_servers << "\n";
             }
         }
+        if (params.key_distribution != "uniform" &&
+            params.key_distribution != "zipf" &&
+            params.key_distribution != "hotspot")
+        {
+            os << "Error: unknown --key-distribution="
+               << params.key_distribution << "\n";
+        }
+        if (params.zipf_theta <= 0 || params.zipf_theta >= 1)
+        {
+            os << "Error: --zipf-theta must be between 0 and 1\n";
+        }
+        if (params.hotspot_rows <= 0 || params.hotspot_rows > 1 ||
+            params.hotspot_access < 0 || params.hotspot_access > 1)
+        {
+            os << "Error: --hotspot-rows must be in (0, 1] and "
+               << "--hotspot-access in [0, 1]\n";
+        }
+        if (params.n_rows == 0 || params.statements == 0 ||
+            params.rows_per_statement == 0 || params.sr_fragment_rows == 0)
+        {
+            os << "Error: --rows, --statements, --rows-per-statement and "
+               << "--sr-fragment-rows must be greater than zero\n";
+        }
+        if (params.read_ratio < 0 || params.read_ratio > 1 ||
+            params.sr_ratio < 0 || params.xa_ratio < 0 ||
+            params.sr_ratio + params.xa_ratio > 1)
+        {
+            os << "Error: --read-ratio must be in [0, 1] and "
+               << "--sr-ratio + --xa-ratio must not exceed 1\n";
+        }
+        if (params.n_appliers == 0)
+        {
+            os << "Error: --appliers must be greater than zero\n";
+        }
+        if (params.ws_replay.size() &&
+            (params.wsrep_provider != "loopback" || params.n_servers != 1 ||
+             params.check_sequential_consistency))
+        {
+            os << "Error: --ws-replay requires --wsrep-provider=loopback "
+               << "and --servers=1 without "
+               << "--check-sequential-consistency\n";
+        }
+        if (params.sr_recover && params.wsrep_provider != "loopback")
+        {
+            os << "Error: --sr-recover requires --wsrep-provider=loopback\n";
+        }
+        if (params.ws_replay_speed < 0)
+        {
+            os << "Error: --ws-replay-speed must not be negative\n";
+        }
+        if (params.rate < 0 || params.rate_step < 0 ||
+            params.rate_step_duration <= 0 ||
+            (params.arrival != "poisson" && params.arrival != "constant"))
+        {
+            os << "Error: --rate and --rate-step must not be negative, "
+               << "--rate-step-duration must be positive and "
+               << "--arrival poisson or constant\n";
+        }
         if (os.str().size())
         {
             throw std::invalid_argument(os.str());
@@ -48,18 +169,22 @@ db::params db::parse_args(int argc, char** argv)
 {
     namespace po = boost::program_options;
     db::params params;
+    std::string applier_schedule;
+    std::string thread_placement;
     po::options_description desc("Allowed options");
     desc.add_options()
         ("help", "produce help message")
         ("wsrep-provider",
          po::value<std::string>(&params.wsrep_provider)->required(),
-         "wsrep provider to load")
+         "wsrep provider to load, 'loopback' for in-process "
+         "cluster simulation")
         ("wsrep-provider-options",
          po::value<std::string>(&params.wsrep_provider_options),
          "wsrep provider options")
         ("status-file",
          po::value<std::string>(&params.status_file),
-         "status output file")
+         "status output file, results and per server phase latencies "
+         "are written into it as JSON")
         ("servers", po::value<size_t>(&params.n_servers)->required(),
          "number of servers to start")
         ("topology", po::value<std::string>(&params.topology),
@@ -74,6 +199,69 @@ db::params db::parse_args(int argc, char** argv)
          "maximum size of data payload (default 8)")
         ("random-data-size", po::value<bool>(&params.random_data_size),
          "randomized payload data size (default 0)")
+        ("append-nocopy", po::value<bool>(&params.append_nocopy),
+         "append data payload into write set without copying (default 0)")
+        ("key-distribution",
+         po::value<std::string>(&params.key_distribution),
+         "row selection: uniform (default), zipf or hotspot")
+        ("zipf-theta", po::value<double>(&params.zipf_theta),
+         "skew of zipf distribution, between 0 and 1 (default 0.99)")
+        ("hotspot-rows", po::value<double>(&params.hotspot_rows),
+         "fraction of hot rows with hotspot distribution (default 0.01)")
+        ("hotspot-access", po::value<double>(&params.hotspot_access),
+         "fraction of accesses to hot rows with hotspot distribution "
+         "(default 0.9)")
+        ("key-spaces", po::value<size_t>(&params.key_spaces),
+         "number of key spaces shared by all clients, "
+         "0 for private key space per client (default 0)")
+        ("statements", po::value<size_t>(&params.statements),
+         "number of statements per transaction (default 1)")
+        ("rows-per-statement", po::value<size_t>(&params.rows_per_statement),
+         "number of rows accessed per statement (default 1)")
+        ("read-ratio", po::value<double>(&params.read_ratio),
+         "fraction of row accesses which are reads (default 0)")
+        ("sr-ratio", po::value<double>(&params.sr_ratio),
+         "fraction of streaming replication transactions (default 0)")
+        ("sr-fragment-rows", po::value<size_t>(&params.sr_fragment_rows),
+         "streaming replication fragment size in rows (default 1)")
+        ("xa-ratio", po::value<double>(&params.xa_ratio),
+         "fraction of XA transactions (default 0)")
+        ("sr-recover", po::value<bool>(&params.sr_recover),
+         "recover streaming transactions from the fragment stores of "
+         "the previous run and roll them back before starting clients")
+        ("toi-interval", po::value<size_t>(&params.toi_interval),
+         "run every Nth transaction of a client as TOI statement, "
+         "0 to disable (default 0)")
+        ("lock-wait-timeout", po::value<size_t>(&params.lock_wait_timeout),
+         "milliseconds a local transaction waits for a row lock held "
+         "by a streaming applier (default 100)")
+        ("rate", po::value<double>(&params.rate),
+         "open-loop mode: target transactions per second per server, "
+         "0 for closed loop (default 0)")
+        ("arrival", po::value<std::string>(&params.arrival),
+         "open-loop arrival schedule: poisson (default) or constant")
+        ("rate-step", po::value<double>(&params.rate_step),
+         "open-loop rate increment per load step (default 0)")
+        ("rate-steps", po::value<size_t>(&params.rate_steps),
+         "number of open-loop load steps, the run ends after the last "
+         "step. 0 runs --transactions per client at --rate (default 0)")
+        ("rate-step-duration", po::value<double>(&params.rate_step_duration),
+         "duration of open-loop load step in seconds (default 10)")
+        ("appliers", po::value<size_t>(&params.n_appliers),
+         "number of applier threads per server (default 1)")
+        ("applier-schedule", po::value<std::string>(&applier_schedule),
+         "resize appliers during the run, comma separated list of "
+         "<seconds>:<appliers>, seconds counted from the start of "
+         "client load")
+        ("ws-capture", po::value<std::string>(&params.ws_capture),
+         "capture write sets delivered to appliers into file "
+         "<prefix>.<server>")
+        ("ws-replay", po::value<std::string>(&params.ws_replay),
+         "replay write sets from capture file instead of running "
+         "clients")
+        ("ws-replay-speed", po::value<double>(&params.ws_replay_speed),
+         "replay pace relative to the capture times, "
+         "0 for maximum speed (default 0)")
         ("alg-freq", po::value<size_t>(&params.alg_freq),
          "ALG frequency")
         ("sync-wait", po::value<bool>(&params.sync_wait),
@@ -85,7 +273,19 @@ db::params db::parse_args(int argc, char** argv)
         ("ti",
          po::value<int>(&params.thread_instrumentation),
          "use instrumentation for threads/mutexes/condition variables"
-         "(0 default disabled, 1 total counts, 2 per object)")
+         "(0 default disabled, 1 total counts, 2 per object, "
+         "3 per object with wait and hold time histograms)")
+        ("thread-placement", po::value<std::string>(&thread_placement),
+         "pin threads to CPUs, semicolon separated list of "
+         "<name>=<cpulist> or <name>=node<N>, where name is a prefix "
+         "of thread key name. dbsim threads are named 'applier' and "
+         "'client', provider threads by their thread service keys. "
+         "Example: 'applier=0-3;client=4-15;gcs=node1'")
+        ("ti-sample",
+         po::value<size_t>(&params.ti_sample),
+         "instrument one in N mutex acquisitions and condition "
+         "operations per object and thread, 0 to instrument only "
+         "contended locks and condition waits (default 1)")
         ("ti-cond-checks",
          po::value<bool>(&params.cond_checks),
          "Enable checks for correct condition variable use. "
@@ -95,6 +295,10 @@ db::params db::parse_args(int argc, char** argv)
          "Configure TLS service stubs.\n0 default disabled\n1 enabled\n"
          "2 enabled with short read/write and renegotiation simulation\n"
          "3 enabled with error simulation.")
+        ("encryption",
+         po::value<bool>(&params.encryption),
+         "Enable AES-CTR encryption service with a random key per "
+         "server. Requires dbsim built with OpenSSL")
         ("check-sequential-consistency",
          po::value<bool>(&params.check_sequential_consistency),
          "Check if the provider provides sequential consistency")
@@ -112,6 +316,8 @@ db::params db::parse_args(int argc, char** argv)
             exit(0);
         }
         po::notify(vm);
+        params.applier_schedule = parse_applier_schedule(applier_schedule);
+        params.thread_placement = parse_thread_placement(thread_placement);
         validate_params(params);
     }
     catch (const po::error& e)
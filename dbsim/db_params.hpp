@@ -20,8 +20,12 @@
 #ifndef WSREP_DB_PARAMS_HPP
 #define WSREP_DB_PARAMS_HPP
 
+#include "wsrep/thread_service.hpp"
+
 #include <cstddef>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace db
 {
@@ -33,6 +37,37 @@ namespace db
         size_t n_rows{1000};
         size_t max_data_size{8}; // Maximum size of write set data payload.
         bool random_data_size{false}; // If true, randomize data payload size.
+        bool append_nocopy{false}; // If true, append payload without copying.
+        /* Workload, see db_workload.hpp. */
+        std::string key_distribution{"uniform"};
+        double zipf_theta{0.99};
+        double hotspot_rows{0.01}; // Fraction of rows which are hot.
+        double hotspot_access{0.9}; // Fraction of accesses to hot rows.
+        size_t key_spaces{0}; // 0 - private key space per client
+        size_t statements{1}; // Statements per transaction
+        size_t rows_per_statement{1};
+        double read_ratio{0}; // Fraction of row accesses which are reads
+        double sr_ratio{0}; // Fraction of streaming transactions
+        size_t sr_fragment_rows{1};
+        double xa_ratio{0}; // Fraction of XA transactions
+        // Recover streaming transactions from fragment store
+        bool sr_recover{false};
+        size_t toi_interval{0}; // Every Nth transaction is TOI, 0 - none
+        size_t lock_wait_timeout{100}; // Milliseconds
+        /* Open-loop load, see db::arrival_schedule. */
+        double rate{0}; // Transactions per second per server, 0 - closed loop
+        std::string arrival{"poisson"};
+        double rate_step{0}; // Rate increment per step
+        size_t rate_steps{0}; // Number of load steps, 0 - no stepping
+        double rate_step_duration{10}; // Seconds
+        size_t n_appliers{1}; // Applier threads per server
+        // Seconds since the start of client load and number of
+        // appliers to resize to at that time.
+        std::vector<std::pair<double, size_t>> applier_schedule{};
+        /* Write set capture and replay, see db::ws_replay. */
+        std::string ws_capture{}; // Capture file prefix
+        std::string ws_replay{}; // Capture file to replay
+        double ws_replay_speed{0}; // 0 - maximum speed
         /* Asymmetric lock granularity frequency. */
         size_t alg_freq{0};
         /* Whether to sync wait before start of transaction. */
@@ -44,8 +79,14 @@ namespace db
         int debug_log_level{0};
         int fast_exit{0};
         int thread_instrumentation{0};
+        size_t ti_sample{1}; // 0 - slow paths only
+        // Thread key name prefix and placement of matching threads
+        std::vector<std::pair<std::string,
+                              wsrep::thread_service::placement>>
+        thread_placement{};
         bool cond_checks{false};
         int tls_service{0};
+        bool encryption{false};
         bool check_sequential_consistency{false};
         bool do_2pc{false};
     };
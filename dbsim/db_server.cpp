@@ -22,6 +22,7 @@
 #include "db_high_priority_service.hpp"
 #include "db_client.hpp"
 #include "db_simulator.hpp"
+#include "db_loopback_provider.hpp"
 
 #include "wsrep/logger.hpp"
 
@@ -57,17 +58,26 @@ db::server::server(simulator& simulator,
                    const std::string& address)
     : simulator_(simulator)
     , storage_engine_(simulator_.params())
+    , fragment_store_()
+    , key_distribution_(simulator_.params())
+    , arrival_schedule_(simulator_.params())
     , mutex_()
     , cond_()
     , server_service_(*this)
     , reporter_(mutex_, name + ".json", 4)
-    , server_state_(server_service_,
+    , server_state_(server_service_, simulator_.encryption_service(),
                     name, address, "dbsim_" + name + "_data")
     , last_client_id_(0)
     , last_transaction_id_(0)
+    , appliers_mutex_()
     , appliers_()
     , clients_()
     , client_threads_()
+    , ws_capture_()
+    , recovered_()
+    , recovery_summary_()
+    , latency_mutex_()
+    , latency_stats_()
     , commit_mutex_()
     , next_commit_seqno_()
     , committed_seqno_()
@@ -75,8 +85,9 @@ db::server::server(simulator& simulator,
     wsrep::log::logger_fn(logger_fn);
 }
 
-void db::server::applier_thread()
+void db::server::applier_thread(db::applier_stats* stats)
 {
+    simulator_.apply_thread_placement("applier");
     wsrep::client_id client_id(last_client_id_.fetch_add(1) + 1);
     db::client applier(*this, client_id,
                        wsrep::client_state::m_high_priority,
@@ -84,34 +95,168 @@ void db::server::applier_thread()
     wsrep::client_state* cc(static_cast<wsrep::client_state*>(
                                 &applier.client_state()));
     db::high_priority_service hps(*this, applier);
+    stats->hps = &hps;
+    db::applier_stats::current(stats);
     cc->open(cc->id());
     cc->before_command();
     enum wsrep::provider::status ret(
         server_state_.provider().run_applier(&hps));
     wsrep::log_info() << "Applier thread exited with error code " << ret;
+    merge_latency_stats(applier.latency_stats());
     cc->after_command_before_result();
     cc->after_command_after_result();
     cc->close();
     cc->cleanup();
+    db::applier_stats::current(nullptr);
+    stats->hps = nullptr;
+    stats->stop = db::applier_stats::clock::now();
+    stats->running = false;
 }
 
 void db::server::start_applier()
 {
-    wsrep::unique_lock<wsrep::mutex> lock(mutex_);
-    appliers_.push_back(boost::thread(&server::applier_thread, this));
+    wsrep::unique_lock<wsrep::default_mutex> lock(appliers_mutex_);
+    applier a;
+    a.stats.reset(new db::applier_stats(appliers_.size() + 1));
+    a.thread = boost::thread(&server::applier_thread, this, a.stats.get());
+    appliers_.push_back(std::move(a));
 }
 
-void db::server::stop_applier()
+void db::server::resize_appliers(size_t n)
 {
-    wsrep::unique_lock<wsrep::mutex> lock(mutex_);
-    appliers_.front().join();
-    appliers_.erase(appliers_.begin());
+    n = std::max(n, size_t(1));
+    size_t active(0);
+    {
+        wsrep::unique_lock<wsrep::default_mutex> lock(appliers_mutex_);
+        for (auto& a : appliers_)
+        {
+            if (a.stats->exit_requested) continue;
+            if (++active > n)
+            {
+                a.stats->exit_requested = true;
+            }
+        }
+    }
+    wsrep::log_info() << "Server " << server_state_.name()
+                      << " resizing appliers " << active << " -> " << n;
+    for (; active < n; ++active)
+    {
+        start_applier();
+    }
 }
 
+void db::server::stop_appliers()
+{
+    wsrep::unique_lock<wsrep::default_mutex> lock(appliers_mutex_);
+    for (auto& a : appliers_)
+    {
+        a.thread.join();
+    }
+}
+
+std::vector<db::server::applier_summary>
+db::server::applier_summaries() const
+{
+    std::vector<applier_summary> ret;
+    wsrep::unique_lock<wsrep::default_mutex> lock(appliers_mutex_);
+    for (const auto& a : appliers_)
+    {
+        const db::applier_stats& stats(*a.stats);
+        const auto stop(stats.running ? db::applier_stats::clock::now() :
+                        stats.stop);
+        ret.push_back({stats.id, stats.applied,
+                       std::chrono::duration<double>(
+                           stop - stats.start).count(),
+                       double(stats.busy_ns) / 1e9});
+    }
+    return ret;
+}
+
+void db::server::start_ws_capture(const std::string& path)
+{
+    ws_capture_.reset(new wsrep::ws_capture(path));
+    server_state_.set_ws_capture(ws_capture_.get());
+    wsrep::log_info() << "Server " << server_state_.name()
+                      << " capturing write sets into " << path;
+}
+
+void db::server::stop_ws_capture()
+{
+    if (ws_capture_)
+    {
+        server_state_.set_ws_capture(nullptr);
+        if (ws_capture_->flush())
+        {
+            wsrep::log_error() << "Failed to flush write set capture";
+        }
+        wsrep::log_info() << "Server " << server_state_.name()
+                          << " captured " << ws_capture_->records()
+                          << " write sets";
+        ws_capture_.reset();
+    }
+}
+
+void db::server::recover_streaming_appliers()
+{
+    const auto start(std::chrono::steady_clock::now());
+    size_t fragments(0);
+    for (const auto& trx : fragment_store_.transactions())
+    {
+        const wsrep::ws_meta& first(trx.meta.front());
+        db::high_priority_service* sa(
+            static_cast<db::high_priority_service*>(
+                streaming_applier_service()));
+        sa->store_globals();
+        sa->start_transaction(wsrep::ws_handle(first.transaction_id()),
+                              first);
+        for (size_t i(0); i < trx.meta.size(); ++i)
+        {
+            if (i > 0) sa->next_fragment(trx.meta[i]);
+            wsrep::mutable_buffer err;
+            if (sa->apply_write_set(trx.meta[i],
+                                    wsrep::const_buffer(trx.data[i].data(),
+                                                        trx.data[i].size()),
+                                    err))
+            {
+                wsrep::log_warning() << "Failed to apply recovered fragment "
+                                     << trx.meta[i];
+            }
+            sa->after_apply();
+        }
+        server_state_.start_streaming_applier(first.server_id(),
+                                              first.transaction_id(), sa);
+        recovered_.push_back(std::make_pair(first.server_id(),
+                                            first.transaction_id()));
+        fragments += trx.meta.size();
+    }
+    recovery_summary_.transactions = recovered_.size();
+    recovery_summary_.fragments = fragments;
+    recovery_summary_.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    wsrep::log_info() << "Server " << server_state_.name() << " recovered "
+                      << recovery_summary_.transactions
+                      << " streaming transactions with "
+                      << recovery_summary_.fragments << " fragments in "
+                      << recovery_summary_.seconds << " seconds";
+}
+
+long long db::server::rollback_recovered_transactions()
+{
+    long long last(-1);
+    db::loopback_provider& provider(
+        static_cast<db::loopback_provider&>(server_state_.provider()));
+    for (const auto& trx : recovered_)
+    {
+        last = provider.rollback_streaming(trx.first, trx.second);
+    }
+    recovered_.clear();
+    return last;
+}
 
 void db::server::start_clients()
 {
     size_t n_clients(simulator_.params().n_clients);
+    arrival_schedule_.start(std::chrono::steady_clock::now());
     for (size_t i(0); i < n_clients; ++i)
     {
         start_client(i + 1);
@@ -130,11 +275,26 @@ void db::server::stop_clients()
         simulator_.stats_.commits += stats.commits;
         simulator_.stats_.rollbacks  += stats.rollbacks;
         simulator_.stats_.replays += stats.replays;
+        simulator_.stats_.tois += stats.tois;
+        merge_latency_stats(i->latency_stats());
     }
 }
 
+void db::server::merge_latency_stats(const db::latency_stats& stats)
+{
+    wsrep::unique_lock<wsrep::default_mutex> lock(latency_mutex_);
+    latency_stats_.merge(stats);
+}
+
+db::latency_stats db::server::latency_stats() const
+{
+    wsrep::unique_lock<wsrep::default_mutex> lock(latency_mutex_);
+    return latency_stats_;
+}
+
 void db::server::client_thread(const std::shared_ptr<db::client>& client)
 {
+    simulator_.apply_thread_placement("client");
     client->start();
 }
 
@@ -159,7 +319,16 @@ void db::server::donate_sst(const std::string& req,
 
 wsrep::high_priority_service* db::server::streaming_applier_service()
 {
-    throw wsrep::not_implemented_error();
+    return new db::streaming_applier_service(*this, high_priority_client());
+}
+
+std::unique_ptr<db::client> db::server::high_priority_client()
+{
+    return std::unique_ptr<db::client>(
+        new db::client(*this,
+                       wsrep::client_id(last_client_id_.fetch_add(1) + 1),
+                       wsrep::client_state::m_high_priority,
+                       simulator_.params()));
 }
 
 void db::server::log_state_change(enum wsrep::server_state::state from,
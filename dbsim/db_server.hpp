@@ -23,15 +23,21 @@
 #include "wsrep/gtid.hpp"
 #include "wsrep/client_state.hpp"
 #include "wsrep/reporter.hpp"
+#include "wsrep/ws_capture.hpp"
 
 #include "db_storage_engine.hpp"
 #include "db_server_state.hpp"
 #include "db_server_service.hpp"
+#include "db_workload.hpp"
+#include "db_histogram.hpp"
+#include "db_high_priority_service.hpp"
+#include "db_fragment_store.hpp"
 
 #include <boost/thread.hpp>
 
-#include <string>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace db
 {
@@ -43,14 +49,59 @@ namespace db
         server(simulator& simulator,
                const std::string& name,
                const std::string& address);
-        void applier_thread();
+        void applier_thread(db::applier_stats*);
         void start_applier();
-        void stop_applier();
+        /**
+         * Start or stop appliers so that n appliers are running.
+         * Stopped appliers exit after applying their next event.
+         */
+        void resize_appliers(size_t n);
+        void stop_appliers();
+        struct applier_summary
+        {
+            size_t id;
+            long long applied;
+            double seconds; // Running time
+            double busy_seconds;
+        };
+        /** Return summary of each applier started so far. */
+        std::vector<applier_summary> applier_summaries() const;
+        /** Capture write sets delivered to appliers into file. */
+        void start_ws_capture(const std::string& path);
+        /** Stop capturing, must be called after appliers have stopped. */
+        void stop_ws_capture();
+        /**
+         * Recreate streaming appliers from the fragments found in
+         * the fragment store. Caller must restore its globals
+         * afterwards.
+         */
+        void recover_streaming_appliers();
+        /**
+         * Roll back recovered streaming transactions through the
+         * provider, which must be loopback provider.
+         *
+         * @return Seqno of the last rollback event or -1 if
+         *         there was nothing to roll back.
+         */
+        long long rollback_recovered_transactions();
+        struct recovery_summary
+        {
+            size_t transactions;
+            size_t fragments;
+            double seconds;
+        };
+        /** Summary of streaming applier recovery. */
+        const recovery_summary& recovery() const
+        { return recovery_summary_; }
         void start_clients();
         void stop_clients();
         void client_thread(const std::shared_ptr<db::client>& client);
         db::storage_engine& storage_engine() { return storage_engine_; }
+        db::fragment_store& fragment_store() { return fragment_store_; }
         db::server_state& server_state() { return server_state_; }
+        const db::key_distribution& key_distribution() const
+        { return key_distribution_; }
+        db::arrival_schedule& arrival_schedule() { return arrival_schedule_; }
         wsrep::transaction_id next_transaction_id()
         {
             return wsrep::transaction_id(last_transaction_id_.fetch_add(1) + 1);
@@ -59,8 +110,13 @@ namespace db
         wsrep::client_state* local_client_state();
         void release_client_state(wsrep::client_state*);
         wsrep::high_priority_service* streaming_applier_service();
+        /** Create a high priority client for storage or applier use. */
+        std::unique_ptr<db::client> high_priority_client();
         void log_state_change(enum wsrep::server_state::state,
                               enum wsrep::server_state::state);
+        /** Add client or applier latencies to server totals. */
+        void merge_latency_stats(const db::latency_stats&);
+        db::latency_stats latency_stats() const;
 
         /* Sequential consistency checks */
         struct commit_critical_section
@@ -87,6 +143,9 @@ namespace db
 
         db::simulator& simulator_;
         db::storage_engine storage_engine_;
+        db::fragment_store fragment_store_;
+        db::key_distribution key_distribution_;
+        db::arrival_schedule arrival_schedule_;
         wsrep::default_mutex mutex_;
         wsrep::default_condition_variable cond_;
         db::server_service server_service_;
@@ -94,10 +153,22 @@ namespace db
         db::server_state server_state_;
         std::atomic<size_t> last_client_id_;
         std::atomic<size_t> last_transaction_id_;
-        std::vector<boost::thread> appliers_;
+        struct applier
+        {
+            boost::thread thread;
+            std::unique_ptr<db::applier_stats> stats;
+        };
+        mutable wsrep::default_mutex appliers_mutex_;
+        std::vector<applier> appliers_;
         std::vector<std::shared_ptr<db::client>> clients_;
         std::vector<boost::thread> client_threads_;
+        std::unique_ptr<wsrep::ws_capture> ws_capture_;
+        // Streaming transactions recovered from fragment store
+        std::vector<std::pair<wsrep::id, wsrep::transaction_id>> recovered_;
+        recovery_summary recovery_summary_;
 
+        mutable wsrep::default_mutex latency_mutex_;
+        db::latency_stats latency_stats_;
         wsrep::default_mutex commit_mutex_;
         uint64_t next_commit_seqno_;
         uint64_t committed_seqno_;
@@ -21,6 +21,7 @@
 #include "db_server.hpp"
 #include "db_storage_service.hpp"
 
+#include "wsrep/client_service.hpp"
 #include "wsrep/logger.hpp"
 #include "wsrep/high_priority_service.hpp"
 
@@ -31,13 +32,13 @@ db::server_service::server_service(db::server& server)
 wsrep::storage_service* db::server_service::storage_service(
     wsrep::client_service&)
 {
-    return new db::storage_service();
+    return new db::storage_service(server_);
 }
 
 wsrep::storage_service* db::server_service::storage_service(
     wsrep::high_priority_service&)
 {
-    return new db::storage_service();
+    return new db::storage_service(server_);
 }
 
 void db::server_service::release_storage_service(
@@ -114,13 +115,17 @@ void db::server_service::log_view(wsrep::high_priority_service*,
 }
 
 void db::server_service::recover_streaming_appliers(
-    wsrep::client_service&)
+    wsrep::client_service& client_service)
 {
+    server_.recover_streaming_appliers();
+    client_service.store_globals();
 }
 
 void db::server_service::recover_streaming_appliers(
-    wsrep::high_priority_service&)
+    wsrep::high_priority_service& high_priority_service)
 {
+    server_.recover_streaming_appliers();
+    high_priority_service.store_globals();
 }
 
 wsrep::view db::server_service::get_view(wsrep::client_service&,
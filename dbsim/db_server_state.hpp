@@ -33,6 +33,7 @@ namespace db
     {
     public:
         server_state(wsrep::server_service& server_service,
+                     wsrep::encryption_service* encryption_service,
                      const std::string& name,
                      const std::string& address,
                      const std::string& working_dir)
@@ -40,7 +41,7 @@ namespace db
                 mutex_,
                 cond_,
                 server_service,
-                nullptr,
+                encryption_service,
                 name,
                 "",
                 address,
@@ -21,14 +21,22 @@
 #include "db_client.hpp"
 #include "db_threads.hpp"
 #include "db_tls.hpp"
+#include "db_ws_replay.hpp"
+#ifdef DBSIM_WITH_ENCRYPTION
+#include "db_encryption.hpp"
+#endif
 
 #include "wsrep/logger.hpp"
 
 #include <boost/filesystem.hpp>
+#include <fstream>
 #include <sstream>
 
 static db::ti thread_instrumentation;
 static db::tls tls_service;
+#ifdef DBSIM_WITH_ENCRYPTION
+static db::encryption aes_encryption;
+#endif
 
 void db::simulator::run()
 {
@@ -39,6 +47,33 @@ void db::simulator::run()
     std::cout << stats() << std::endl;
     std::cout << db::ti::stats() << std::endl;
     std::cout << db::tls::stats() << std::endl;
+#ifdef DBSIM_WITH_ENCRYPTION
+    if (params_.encryption)
+    {
+        std::cout << aes_encryption.stats() << std::endl;
+    }
+#endif
+    write_status_file();
+}
+
+wsrep::encryption_service* db::simulator::encryption_service() const
+{
+#ifdef DBSIM_WITH_ENCRYPTION
+    if (params_.encryption) return &aes_encryption;
+#endif
+    return nullptr;
+}
+
+void db::simulator::apply_thread_placement(const char* name)
+{
+    if (params_.thread_placement.size())
+    {
+        if (int err = thread_instrumentation.apply_placement(name))
+        {
+            wsrep::log_warning() << "Failed to set placement for "
+                                 << name << " thread: " << err;
+        }
+    }
 }
 
 void db::simulator::sst(db::server& server,
@@ -90,9 +125,16 @@ std::string db::simulator::stats() const
                       clients_stop_ - clients_start_).count());
     long long transactions(stats_.commits + stats_.rollbacks);
     long long bf_aborts(0);
+    long long lock_waits(0);
+    long long lock_wait_timeouts(0);
+    long long deadlocks(0);
     for (const auto& s : servers_)
     {
         bf_aborts += s.second->storage_engine().bf_aborts();
+        lock_waits += s.second->storage_engine().lock_waits();
+        lock_wait_timeouts +=
+            s.second->storage_engine().lock_wait_timeouts();
+        deadlocks += s.second->storage_engine().deadlocks();
     }
     std::ostringstream os;
     os << "Number of transactions: " << transactions
@@ -104,11 +146,67 @@ std::string db::simulator::stats() const
        << "BF aborts: "
        << bf_aborts
        << "\n"
+       << "Row lock waits: " << lock_waits
+       << "\n"
+       << "Lock wait timeouts: " << lock_wait_timeouts
+       << "\n"
+       << "Deadlocks: " << deadlocks
+       << "\n"
        << "Client commits: " << stats_.commits
        << "\n"
        << "Client rollbacks: " << stats_.rollbacks
        << "\n"
-       << "Client replays: " << stats_.replays;
+       << "Client replays: " << stats_.replays
+       << "\n"
+       << "Client TOI statements: " << stats_.tois;
+    if (params_.ws_replay.size())
+    {
+        os << "\nReplayed write sets: " << replayed_
+           << "\nReplayed write sets per second: "
+           << double(replayed_) / duration;
+    }
+    for (const auto& s : servers_)
+    {
+        const db::latency_stats latency(s.second->latency_stats());
+        latency.print(os, "Server " + s.first + " latency ");
+        if (params_.sr_ratio > 0 || params_.xa_ratio > 0 ||
+            params_.sr_recover)
+        {
+            const db::fragment_store& store(s.second->fragment_store());
+            const db::server::recovery_summary& recovery(
+                s.second->recovery());
+            os << "\nServer " << s.first << " fragment store: appended "
+               << store.appended() << " remaining " << store.fragments()
+               << " compactions " << store.compactions()
+               << " recovered transactions " << recovery.transactions
+               << " fragments " << recovery.fragments
+               << " in " << recovery.seconds << " seconds";
+        }
+        for (const auto& a : s.second->applier_summaries())
+        {
+            os << "\nServer " << s.first << " applier " << a.id
+               << ": applied " << a.applied
+               << " events per second " << double(a.applied) / a.seconds
+               << " utilization " << 100. * a.busy_seconds / a.seconds
+               << "%";
+        }
+        const db::arrival_schedule& schedule(s.second->arrival_schedule());
+        const double step_seconds(std::chrono::duration<double>(
+                                      schedule.step_duration()).count());
+        for (size_t i(0); i < schedule.steps() && i < latency.steps().size();
+             ++i)
+        {
+            const db::latency_stats::step& step(latency.steps()[i]);
+            const db::histogram& h(step.response);
+            os << "\nServer " << s.first << " step " << i
+               << ": offered " << schedule.rate(i)
+               << " achieved " << double(step.completed) / step_seconds
+               << " tps response p50 " << double(h.percentile(50.)) / 1000.
+               << " p99 " << double(h.percentile(99.)) / 1000.
+               << " p99.9 " << double(h.percentile(99.9)) / 1000.
+               << " max " << double(h.max()) / 1000. << " us";
+        }
+    }
     return os.str();
 }
 
@@ -119,9 +217,30 @@ std::string db::simulator::stats() const
 void db::simulator::start()
 {
     thread_instrumentation.level(params_.thread_instrumentation);
+    thread_instrumentation.sample(params_.ti_sample);
+    for (const auto& p : params_.thread_placement)
+    {
+        if (thread_instrumentation.set_placement(p.first.c_str(), p.second))
+        {
+            throw wsrep::runtime_error("Invalid thread placement for "
+                                       + p.first);
+        }
+    }
     thread_instrumentation.cond_checks(params_.cond_checks);
     tls_service.init(params_.tls_service);
+#ifndef DBSIM_WITH_ENCRYPTION
+    if (params_.encryption)
+    {
+        throw wsrep::runtime_error("Encryption requires dbsim built "
+                                   "with OpenSSL");
+    }
+#endif
     wsrep::log_info() << "Provider: " << params_.wsrep_provider;
+    std::unique_ptr<db::ws_replay> replay;
+    if (params_.ws_replay.size())
+    {
+        replay = std::make_unique<db::ws_replay>(params_.ws_replay);
+    }
 
     std::string cluster_address(build_cluster_address());
     wsrep::log_info() << "Cluster address: " << cluster_address;
@@ -153,17 +272,45 @@ void db::simulator::start()
         std::string server_options(params_.wsrep_provider_options);
 
         wsrep::provider::services services;
-        services.thread_service = params_.thread_instrumentation
+        services.thread_service = params_.thread_instrumentation ||
+                                  params_.thread_placement.size()
                                       ? &thread_instrumentation
                                       : nullptr;
         services.tls_service = params_.tls_service
             ? &tls_service
             : nullptr;
+        if (params_.wsrep_provider == "loopback")
+        {
+            server.server_state().set_provider_factory(
+                [this](wsrep::server_state& server_state,
+                       const std::string&,
+                       const std::string&,
+                       const wsrep::provider::services&)
+                {
+                    return std::unique_ptr<wsrep::provider>(
+                        new db::loopback_provider(server_state,
+                                                  loopback_cluster_));
+                });
+        }
+#ifdef DBSIM_WITH_ENCRYPTION
+        if (params_.encryption)
+        {
+            // The provider reads the key from server state on init.
+            std::vector<unsigned char> key(db::encryption::generate_key());
+            server.server_state().set_encryption_key(key);
+        }
+#endif
         if (server.server_state().load_provider(params_.wsrep_provider,
                                                 server_options, services))
         {
             throw wsrep::runtime_error("Failed to load provider");
         }
+        if (params_.ws_capture.size())
+        {
+            server.start_ws_capture(params_.ws_capture + "." + name_os.str());
+        }
+        server.fragment_store().open((dir / "fragments.log").string(),
+                                     params_.sr_recover);
         if (server.server_state().connect("sim_cluster", cluster_address, "",
                                           i == 0))
         {
@@ -186,6 +333,39 @@ void db::simulator::start()
             throw wsrep::runtime_error("Failed to reach synced state");
         }
         wsrep::log_debug() << "main: Server synced";
+        if (params_.n_appliers > 1)
+        {
+            server.resize_appliers(params_.n_appliers);
+        }
+    }
+
+    if (replay)
+    {
+        // Validated to run with a single loopback server.
+        db::server& server(*servers_.begin()->second);
+        wsrep::log_info() << "####################### Starting replay";
+        clients_start_ = std::chrono::steady_clock::now();
+        replay->run(static_cast<db::loopback_provider&>(
+                        server.server_state().provider()),
+                    params_.ws_replay_speed);
+        replayed_ = replay->size();
+        return;
+    }
+
+    if (params_.sr_recover)
+    {
+        // Recovered transactions may clash with the transaction
+        // ids of new clients, roll them back first.
+        for (auto& i : servers_)
+        {
+            const long long last(
+                i.second->rollback_recovered_transactions());
+            if (last > 0)
+            {
+                static_cast<db::loopback_provider&>(
+                    i.second->server_state().provider()).wait_committed(last);
+            }
+        }
     }
 
     // Start client threads
@@ -200,6 +380,11 @@ void db::simulator::start()
         }
         ++index;
     }
+    if (params_.applier_schedule.empty() == false)
+    {
+        applier_scheduler_ = std::thread(&simulator::run_applier_schedule,
+                                         this);
+    }
 }
 
 void db::simulator::stop()
@@ -210,12 +395,24 @@ void db::simulator::stop()
         server.stop_clients();
     }
     clients_stop_ = std::chrono::steady_clock::now();
+    if (applier_scheduler_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(schedule_mutex_);
+            schedule_stop_ = true;
+        }
+        schedule_cond_.notify_all();
+        applier_scheduler_.join();
+    }
     wsrep::log_info() << "######## Stats ############";
     wsrep::log_info()  << stats();
     std::cout << db::ti::stats() << std::endl;
     wsrep::log_info() << "######## Stats ############";
     if (params_.fast_exit)
     {
+        // The process exits here, run() will not get to write
+        // the status file.
+        write_status_file();
         exit(0);
     }
     for (auto& i : servers_)
@@ -235,11 +432,109 @@ void db::simulator::stop()
         {
             throw wsrep::runtime_error("Failed to reach disconnected state");
         }
-        server.stop_applier();
+        server.stop_appliers();
+        server.stop_ws_capture();
         server.server_state().unload_provider();
     }
 }
 
+void db::simulator::write_status_file() const
+{
+    if (params_.status_file.empty())
+    {
+        return;
+    }
+    auto duration(std::chrono::duration<double>(
+                      clients_stop_ - clients_start_).count());
+    long long transactions(stats_.commits + stats_.rollbacks);
+    std::ofstream os(params_.status_file);
+    os << "{\"transactions\": " << transactions
+       << ", \"seconds\": " << duration
+       << ", \"tps\": " << double(transactions)/double(duration)
+       << ", \"commits\": " << stats_.commits
+       << ", \"rollbacks\": " << stats_.rollbacks
+       << ", \"replays\": " << stats_.replays
+       << ", \"tois\": " << stats_.tois
+       << ", \"replayed\": " << replayed_
+       << ", \"servers\": {";
+    const char* sep("");
+    for (const auto& s : servers_)
+    {
+        const db::latency_stats latency(s.second->latency_stats());
+        const db::arrival_schedule& schedule(s.second->arrival_schedule());
+        const double step_seconds(std::chrono::duration<double>(
+                                      schedule.step_duration()).count());
+        os << sep << "\"" << s.first << "\": {\"latency\": ";
+        latency.print_json(os);
+        os << ", \"steps\": [";
+        for (size_t i(0); i < schedule.steps() && i < latency.steps().size();
+             ++i)
+        {
+            const db::latency_stats::step& step(latency.steps()[i]);
+            const db::histogram& h(step.response);
+            os << (i ? ", " : "")
+               << "{\"offered_tps\": " << schedule.rate(i)
+               << ", \"achieved_tps\": "
+               << double(step.completed) / step_seconds
+               << ", \"p50_us\": " << double(h.percentile(50.)) / 1000.
+               << ", \"p99_us\": " << double(h.percentile(99.)) / 1000.
+               << ", \"p99_9_us\": " << double(h.percentile(99.9)) / 1000.
+               << ", \"max_us\": " << double(h.max()) / 1000. << "}";
+        }
+        os << "], \"appliers\": [";
+        const char* applier_sep("");
+        for (const auto& a : s.second->applier_summaries())
+        {
+            os << applier_sep << "{\"id\": " << a.id
+               << ", \"applied\": " << a.applied
+               << ", \"events_per_second\": "
+               << double(a.applied) / a.seconds
+               << ", \"utilization\": " << a.busy_seconds / a.seconds
+               << "}";
+            applier_sep = ", ";
+        }
+        const db::fragment_store& store(s.second->fragment_store());
+        const db::server::recovery_summary& recovery(s.second->recovery());
+        os << "], \"fragment_store\": {\"appended\": " << store.appended()
+           << ", \"remaining\": " << store.fragments()
+           << ", \"compactions\": " << store.compactions()
+           << ", \"recovered_transactions\": " << recovery.transactions
+           << ", \"recovered_fragments\": " << recovery.fragments
+           << ", \"recovery_seconds\": " << recovery.seconds
+           << "}}";
+        sep = ", ";
+    }
+    os << "}}" << std::endl;
+    if (not os)
+    {
+        wsrep::log_error() << "Failed to write status file "
+                           << params_.status_file;
+    }
+}
+
+void db::simulator::run_applier_schedule()
+{
+    for (const auto& entry : params_.applier_schedule)
+    {
+        const auto at(clients_start_ +
+                      std::chrono::duration_cast<
+                          std::chrono::steady_clock::duration>(
+                              std::chrono::duration<double>(entry.first)));
+        {
+            std::unique_lock<std::mutex> lock(schedule_mutex_);
+            if (schedule_cond_.wait_until(lock, at, [this]()
+                                          { return schedule_stop_; }))
+            {
+                return;
+            }
+        }
+        for (auto& i : servers_)
+        {
+            i.second->resize_appliers(entry.second);
+        }
+    }
+}
+
 std::string db::simulator::server_port(size_t i) const
 {
     std::ostringstream os;
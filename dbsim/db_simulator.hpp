@@ -26,9 +26,13 @@
 
 #include "db_params.hpp"
 #include "db_server.hpp"
+#include "db_loopback_provider.hpp"
 
 #include <memory>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <unordered_set>
 #include <map>
 
@@ -42,8 +46,14 @@ namespace db
             : mutex_()
             , params_(params)
             , servers_()
+            , loopback_cluster_()
             , clients_start_()
             , clients_stop_()
+            , schedule_mutex_()
+            , schedule_cond_()
+            , schedule_stop_()
+            , applier_scheduler_()
+            , replayed_()
             , stats_()
         { }
 
@@ -52,28 +62,45 @@ namespace db
                  const std::string&, const wsrep::gtid&, bool);
         const db::params& params() const
         { return params_; }
+        /** Apply --thread-placement to the calling thread. */
+        void apply_thread_placement(const char* name);
+        /** Encryption service if enabled with --encryption. */
+        wsrep::encryption_service* encryption_service() const;
         std::string stats() const;
     private:
         void start();
         void stop();
+        // Write results with per server phase latencies as JSON
+        // into params().status_file.
+        void write_status_file() const;
+        // Resize appliers according to params().applier_schedule.
+        void run_applier_schedule();
         std::string server_port(size_t i) const;
         std::string build_cluster_address() const;
 
         wsrep::default_mutex mutex_;
         const db::params& params_;
         std::map<std::string, std::unique_ptr<db::server>> servers_;
+        db::loopback_cluster loopback_cluster_;
         std::chrono::time_point<std::chrono::steady_clock> clients_start_;
         std::chrono::time_point<std::chrono::steady_clock> clients_stop_;
+        std::mutex schedule_mutex_;
+        std::condition_variable schedule_cond_;
+        bool schedule_stop_;
+        std::thread applier_scheduler_;
+        size_t replayed_; // Write sets replayed with --ws-replay
     public:
         struct stats
         {
             long long commits;
             long long rollbacks;
             long long replays;
+            long long tois;
             stats()
                 : commits(0)
                 , rollbacks(0)
                 , replays(0)
+                , tois(0)
             { }
         } stats_;
     };
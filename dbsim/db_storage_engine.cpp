@@ -21,22 +21,120 @@
 #include "db_client.hpp"
 
 #include <cassert>
+#include <cstring>
 
 void db::storage_engine::transaction::start(db::client* cc)
 {
     wsrep::unique_lock<wsrep::mutex> lock(se_.mutex_);
-    if (se_.transactions_.insert(cc).second == false)
+    if (se_.transactions_.insert(this).second == false)
     {
         ::abort();
     }
     cc_ = cc;
+    aborted_ = false;
 }
 
-void db::storage_engine::transaction::apply(
-    const wsrep::transaction& transaction)
+int db::storage_engine::transaction::write(const row_key& key,
+                                           const wsrep::const_buffer& value)
 {
     assert(cc_);
+    wsrep::unique_lock<wsrep::mutex> lock(se_.mutex_);
+    row& row(se_.rows_[key]);
+    if (row.owner != this)
+    {
+        const bool high_priority(cc_->client_state().mode() !=
+                                 wsrep::client_state::m_local);
+        if (row.owner)
+        {
+            ++se_.lock_waits_;
+        }
+        while (row.owner && not aborted_)
+        {
+            if (high_priority)
+            {
+                se_.bf_abort(cc_->client_state().transaction(), row.owner);
+            }
+            else if (se_.is_deadlock(this, &row))
+            {
+                ++se_.deadlocks_;
+                return 1;
+            }
+            ++row.waiters;
+            waits_for_ = &row;
+            std::cv_status status(std::cv_status::no_timeout);
+            if (high_priority)
+            {
+                se_.cond_.wait(lock);
+            }
+            else
+            {
+                status = se_.cond_.wait_for(lock, se_.lock_wait_timeout_);
+            }
+            waits_for_ = nullptr;
+            --row.waiters;
+            if (status == std::cv_status::timeout && row.owner &&
+                row.owner->cc_->client_state().mode() !=
+                wsrep::client_state::m_local)
+            {
+                ++se_.lock_wait_timeouts_;
+                return 1;
+            }
+        }
+        if (aborted_)
+        {
+            return 1;
+        }
+        row.owner = this;
+        locks_.push_back(&row);
+    }
+    row.new_value.assign(value.data(), value.data() + value.size());
+    return 0;
+}
+
+void db::storage_engine::transaction::read(const row_key& key,
+                                          std::vector<char>& value)
+{
+    wsrep::unique_lock<wsrep::mutex> lock(se_.mutex_);
+    auto i(se_.rows_.find(key));
+    if (i == se_.rows_.end())
+    {
+        value.clear();
+    }
+    else if (i->second.owner == this)
+    {
+        value = i->second.new_value;
+    }
+    else
+    {
+        value = i->second.value;
+    }
+}
+
+int db::storage_engine::transaction::apply(
+    const wsrep::transaction& transaction,
+    const wsrep::const_buffer& data)
+{
+    assert(cc_);
+    const char* pos(data.data());
+    const char* const end(pos + data.size());
+    while (pos < end)
+    {
+        row_write rw;
+        if (size_t(end - pos) < sizeof(rw))
+        {
+            return 1;
+        }
+        ::memcpy(&rw, pos, sizeof(rw));
+        pos += sizeof(rw);
+        if (size_t(end - pos) < rw.size ||
+            write(rw.key, wsrep::const_buffer(pos, rw.size)))
+        {
+            return 1;
+        }
+        pos += rw.size;
+    }
     se_.bf_abort_some(transaction);
+    return 0;
 }
 
 void db::storage_engine::transaction::commit(const wsrep::gtid& gtid)
@@ -44,7 +142,8 @@ void db::storage_engine::transaction::commit(const wsrep::gtid& gtid)
     if (cc_)
     {
         wsrep::unique_lock<wsrep::mutex> lock(se_.mutex_);
-        se_.transactions_.erase(cc_);
+        release(true);
+        se_.transactions_.erase(this);
         se_.store_position(gtid);
     }
     cc_ = nullptr;
@@ -56,30 +155,88 @@ void db::storage_engine::transaction::rollback()
     if (cc_)
     {
         wsrep::unique_lock<wsrep::mutex> lock(se_.mutex_);
-        se_.transactions_.erase(cc_);
+        release(false);
+        se_.transactions_.erase(this);
     }
     cc_ = nullptr;
 }
 
+void db::storage_engine::transaction::release(bool commit)
+{
+    bool notify(false);
+    for (auto row : locks_)
+    {
+        if (commit)
+        {
+            // Keep the old value buffer for the next write.
+            row->value.swap(row->new_value);
+        }
+        row->new_value.clear();
+        row->owner = nullptr;
+        notify = notify || row->waiters;
+    }
+    locks_.clear();
+    if (notify)
+    {
+        se_.cond_.notify_all();
+    }
+}
+
+bool db::storage_engine::is_deadlock(const transaction* waiter,
+                                     const row* row) const
+{
+    // Each transaction waits for at most one row, so the wait-for
+    // graph is a chain starting from the row owner.
+    const transaction* owner(row->owner);
+    for (size_t i(0); owner && i <= transactions_.size(); ++i)
+    {
+        if (owner == waiter)
+        {
+            return true;
+        }
+        if (owner->waits_for_ == nullptr)
+        {
+            return false;
+        }
+        owner = owner->waits_for_->owner;
+    }
+    return false;
+}
+
+bool db::storage_engine::bf_abort(const wsrep::transaction& bf_trx,
+                                  transaction* victim)
+{
+    // High priority transactions are ordered by the provider,
+    // the lock will be released when the holder commits.
+    if (victim->aborted_ ||
+        victim->cc_->client_state().mode() != wsrep::client_state::m_local)
+    {
+        return false;
+    }
+    if (victim->cc_->bf_abort(bf_trx.seqno()))
+    {
+        ++bf_aborts_;
+        victim->aborted_ = true;
+        // Wake up the victim if it is waiting for a row lock.
+        cond_.notify_all();
+        return true;
+    }
+    return false;
+}
+
 void db::storage_engine::bf_abort_some(const wsrep::transaction& txc)
 {
     std::uniform_int_distribution<size_t> uniform_dist(0, alg_freq_);
     wsrep::unique_lock<wsrep::mutex> lock(mutex_);
     if (alg_freq_ && uniform_dist(random_engine_) == 0)
     {
-        if (transactions_.empty() == false)
+        for (auto victim : transactions_)
         {
-            for (auto victim : transactions_)
+            if (victim->cc_->client_state().mode() ==
+                wsrep::client_state::m_local)
             {
-                wsrep::client_state& cc(victim->client_state());
-                if (cc.mode() == wsrep::client_state::m_local)
-                {
-                    if (victim->bf_abort(txc.seqno()))
-                    {
-                        ++bf_aborts_;
-                    }
-                    break;
-                }
+                bf_abort(txc, victim);
+                break;
             }
         }
     }
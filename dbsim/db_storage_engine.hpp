@@ -17,42 +17,95 @@
  * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+/** @file db_storage_engine.hpp
+ *
+ * In-memory row store for dbsim. Rows are identified by the
+ * (key space, row) pair which also forms the last two parts of the
+ * certification key. Transactions take exclusive row locks on write
+ * and install the written values on commit. Local transactions wait
+ * for conflicting locks, high priority transactions BF abort local
+ * lock holders.
+ *
+ * A streaming applier holds its locks between fragments. Local
+ * transactions waiting for such a lock may form a deadlock which
+ * spans several servers, so local waits time out after
+ * --lock-wait-timeout milliseconds if the lock is still held by
+ * a high priority transaction.
+ */
+
 #ifndef WSREP_DB_STORAGE_ENGINE_HPP
 #define WSREP_DB_STORAGE_ENGINE_HPP
 
 #include "db_params.hpp"
 
+#include "wsrep/buffer.hpp"
 #include "wsrep/mutex.hpp"
+#include "wsrep/condition_variable.hpp"
 #include "wsrep/view.hpp"
 #include "wsrep/transaction.hpp"
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <unordered_map>
 #include <unordered_set>
 #include <random>
+#include <vector>
 
 namespace db
 {
     class client;
     class storage_engine
     {
+        struct row;
     public:
         storage_engine(const params& params)
             : mutex_()
+            , cond_()
             , transactions_()
+            , rows_()
             , alg_freq_(params.alg_freq)
+            , lock_wait_timeout_(params.lock_wait_timeout)
             , bf_aborts_()
+            , lock_waits_()
+            , lock_wait_timeouts_()
+            , deadlocks_()
             , position_()
             , view_()
             , random_device_()
             , random_engine_(random_device_())
         { }
 
+        struct row_key
+        {
+            uint64_t space;
+            uint64_t row;
+            bool operator==(const row_key& other) const
+            {
+                return (space == other.space && row == other.row);
+            }
+        };
+
+        /**
+         * Header of a row write in write set data. The header
+         * is followed by size bytes of row value.
+         */
+        struct row_write
+        {
+            row_key key;
+            uint64_t size;
+        };
+
         class transaction
         {
         public:
             transaction(storage_engine& se)
                 : se_(se)
                 , cc_()
+                , locks_()
+                , waits_for_()
+                , aborted_()
             { }
             ~transaction()
             {
@@ -60,28 +113,85 @@ namespace db
             }
             bool active() const { return cc_ != nullptr; }
             void start(client* cc);
-            void apply(const wsrep::transaction&);
+            /**
+             * Lock the row and store the value to be installed
+             * at commit. Returns non-zero if the transaction was
+             * BF aborted, chosen as a deadlock victim or timed out
+             * while waiting for the row lock.
+             */
+            int write(const row_key& key, const wsrep::const_buffer& value);
+            /**
+             * Read the row value into value. Reads do not take locks,
+             * the value is the last committed one unless the row has
+             * been written by this transaction.
+             */
+            void read(const row_key& key, std::vector<char>& value);
+            /**
+             * Apply row writes from write set data. The data
+             * is a sequence of row_write headers each followed
+             * by the row value.
+             */
+            int apply(const wsrep::transaction&, const wsrep::const_buffer&);
             void commit(const wsrep::gtid&);
             void rollback();
             db::client* client() { return cc_; }
             transaction(const transaction&) = delete;
             transaction& operator=(const transaction&) = delete;
         private:
+            friend class storage_engine;
+            void release(bool commit);
             db::storage_engine& se_;
             db::client* cc_;
+            // Locked rows, pointers are stable as rows are never erased
+            std::vector<row*> locks_;
+            row* waits_for_;
+            bool aborted_;
         };
         void bf_abort_some(const wsrep::transaction& tc);
         long long bf_aborts() const { return bf_aborts_; }
+        long long lock_waits() const { return lock_waits_; }
+        long long lock_wait_timeouts() const { return lock_wait_timeouts_; }
+        long long deadlocks() const { return deadlocks_; }
         void store_position(const wsrep::gtid& gtid);
         wsrep::gtid get_position() const;
         void store_view(const wsrep::view& view);
         wsrep::view get_view() const;
     private:
+        struct row
+        {
+            row()
+                : value()
+                , new_value()
+                , owner()
+                , waiters()
+            { }
+            std::vector<char> value;
+            std::vector<char> new_value;
+            transaction* owner;
+            size_t waiters;
+        };
+        struct row_key_hash
+        {
+            size_t operator()(const row_key& key) const
+            {
+                return std::hash<uint64_t>()(
+                    key.space * 0x9e3779b97f4a7c15ULL ^ key.row);
+            }
+        };
+        bool is_deadlock(const transaction* waiter, const row* row) const;
+        bool bf_abort(const wsrep::transaction& bf_trx, transaction* victim);
         void validate_position(const wsrep::gtid& gtid) const;
         wsrep::default_mutex mutex_;
-        std::unordered_set<db::client*> transactions_;
+        // Timed waits are needed for lock wait timeout.
+        std::condition_variable_any cond_;
+        std::unordered_set<transaction*> transactions_;
+        std::unordered_map<row_key, row, row_key_hash> rows_;
         size_t alg_freq_;
+        std::chrono::milliseconds lock_wait_timeout_;
         std::atomic<long long> bf_aborts_;
+        std::atomic<long long> lock_waits_;
+        std::atomic<long long> lock_wait_timeouts_;
+        std::atomic<long long> deadlocks_;
         wsrep::gtid position_;
         wsrep::view view_;
         std::random_device random_device_;
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "db_storage_service.hpp"
+#include "db_server.hpp"
+#include "db_client.hpp"
+
+#include "wsrep/logger.hpp"
+
+db::storage_service::storage_service(db::server& server)
+    : server_(server)
+    , client_(server.high_priority_client())
+    , server_id_()
+    , transaction_id_()
+    , flags_()
+    , data_()
+    , ws_meta_()
+    , append_()
+    , remove_()
+{
+    wsrep::client_state& client_state(client_->client_state());
+    client_state.open(client_state.id());
+    client_state.before_command();
+}
+
+db::storage_service::~storage_service()
+{
+    wsrep::client_state& client_state(client_->client_state());
+    client_state.after_command_before_result();
+    client_state.after_command_after_result();
+    client_state.close();
+    client_state.cleanup();
+}
+
+int db::storage_service::start_transaction(const wsrep::ws_handle& ws_handle)
+{
+    return client_->client_state().start_transaction(
+        ws_handle.transaction_id());
+}
+
+void db::storage_service::adopt_transaction(
+    const wsrep::transaction& transaction)
+{
+    client_->client_state().adopt_transaction(transaction);
+    server_id_ = transaction.server_id();
+    transaction_id_ = transaction.id();
+}
+
+int db::storage_service::append_fragment(const wsrep::id& server_id,
+                                         wsrep::transaction_id transaction_id,
+                                         int flags,
+                                         const wsrep::const_buffer& data,
+                                         const wsrep::xid&)
+{
+    server_id_ = server_id;
+    transaction_id_ = transaction_id;
+    flags_ = flags;
+    data_.assign(static_cast<const char*>(data.data()),
+                 static_cast<const char*>(data.data()) + data.size());
+    append_ = true;
+    return 0;
+}
+
+int db::storage_service::update_fragment_meta(const wsrep::ws_meta& ws_meta)
+{
+    ws_meta_ = ws_meta;
+    return 0;
+}
+
+int db::storage_service::remove_fragments()
+{
+    remove_ = true;
+    return 0;
+}
+
+int db::storage_service::commit(const wsrep::ws_handle& ws_handle,
+                                const wsrep::ws_meta& ws_meta)
+{
+    wsrep::client_state& client_state(client_->client_state());
+    int ret(0);
+    db::fragment_store& store(server_.fragment_store());
+    if (append_ &&
+        store.append(
+            wsrep::ws_meta(ws_meta_.gtid(),
+                           wsrep::stid(server_id_, transaction_id_,
+                                       ws_meta_.client_id()),
+                           ws_meta_.depends_on(), flags_),
+            wsrep::const_buffer(data_.data(), data_.size())))
+    {
+        wsrep::log_warning() << "Failed to store fragment of "
+                             << transaction_id_;
+    }
+    if (remove_ && store.remove(server_id_, transaction_id_))
+    {
+        wsrep::log_warning() << "Failed to remove fragments of "
+                             << transaction_id_;
+    }
+    reset_pending();
+    if (ws_meta.seqno().is_undefined())
+    {
+        // Not ordered, roll back out of order.
+        client_state.before_rollback();
+        client_state.after_rollback();
+    }
+    else
+    {
+        ret = client_state.prepare_for_ordering(ws_handle, ws_meta, true);
+        ret = ret || client_state.before_commit();
+        ret = ret || client_state.ordered_commit();
+        ret = ret || client_state.after_commit();
+        if (ret)
+        {
+            client_state.prepare_for_ordering(wsrep::ws_handle(),
+                                              wsrep::ws_meta(), false);
+        }
+    }
+    client_state.after_applying();
+    return ret;
+}
+
+int db::storage_service::rollback(const wsrep::ws_handle& ws_handle,
+                                  const wsrep::ws_meta& ws_meta)
+{
+    reset_pending();
+    wsrep::client_state& client_state(client_->client_state());
+    int ret(client_state.prepare_for_ordering(ws_handle, ws_meta, false) ||
+            client_state.before_rollback() ||
+            client_state.after_rollback());
+    client_state.after_applying();
+    return ret;
+}
+
+void db::storage_service::reset_pending()
+{
+    data_.clear();
+    ws_meta_ = wsrep::ws_meta();
+    append_ = false;
+    remove_ = false;
+}
+
+void db::storage_service::store_globals()
+{
+    client_->store_globals();
+}
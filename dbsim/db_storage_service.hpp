@@ -21,33 +21,56 @@
 #define WSREP_DB_STORAGE_SERVICE_HPP
 
 #include "wsrep/storage_service.hpp"
-#include "wsrep/exception.hpp"
+#include "wsrep/id.hpp"
+#include "wsrep/provider.hpp"
+#include "wsrep/transaction_id.hpp"
+
+#include <memory>
+#include <vector>
 
 namespace db
 {
+    class server;
+    class client;
+
+    /**
+     * Storage service for streaming replication fragments. The
+     * fragment or removal is written into server fragment store
+     * when the fragment storage transaction commits.
+     */
     class storage_service : public wsrep::storage_service
     {
-        int start_transaction(const wsrep::ws_handle&) override
-        { throw wsrep::not_implemented_error(); }
-        void adopt_transaction(const wsrep::transaction&) override
-        { throw wsrep::not_implemented_error(); }
+    public:
+        storage_service(db::server&);
+        ~storage_service();
+        int start_transaction(const wsrep::ws_handle&) override;
+        void adopt_transaction(const wsrep::transaction&) override;
         int append_fragment(const wsrep::id&,
                             wsrep::transaction_id,
                             int,
                             const wsrep::const_buffer&,
-                            const wsrep::xid&) override
-        { throw wsrep::not_implemented_error(); }
-        int update_fragment_meta(const wsrep::ws_meta&) override
-        { throw wsrep::not_implemented_error(); }
-        int remove_fragments() override
-        { throw wsrep::not_implemented_error(); }
-        int commit(const wsrep::ws_handle&, const wsrep::ws_meta&) override
-        { throw wsrep::not_implemented_error(); }
+                            const wsrep::xid&) override;
+        int update_fragment_meta(const wsrep::ws_meta&) override;
+        int remove_fragments() override;
+        int commit(const wsrep::ws_handle&, const wsrep::ws_meta&) override;
         int rollback(const wsrep::ws_handle&, const wsrep::ws_meta&)
-            override
-        { throw wsrep::not_implemented_error(); }
-        void store_globals() override { }
+            override;
+        void store_globals() override;
         void reset_globals() override { }
+    private:
+        storage_service(const storage_service&) = delete;
+        storage_service& operator=(const storage_service&) = delete;
+        void reset_pending();
+        db::server& server_;
+        std::unique_ptr<db::client> client_;
+        // Fragment or removal to be written into store on commit
+        wsrep::id server_id_;
+        wsrep::transaction_id transaction_id_;
+        int flags_;
+        std::vector<char> data_;
+        wsrep::ws_meta ws_meta_;
+        bool append_;
+        bool remove_;
     };
 }
 
@@ -18,23 +18,27 @@
  */
 
 #include "db_threads.hpp"
+#include "db_histogram.hpp"
 #include "wsrep/compiler.hpp"
 #include "wsrep/logger.hpp"
 
 #include <cassert>
 #include <cstdint>
 #include <pthread.h>
+#include <sched.h>
 
 #include <algorithm>
 #include <atomic>
 #include <array>
 #include <chrono>
+#include <fstream>
+#include <iterator>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <ostream>
 #include <sstream>
 #include <thread>
-#include <unordered_map>
 #include <vector>
 
 extern "C" { static void* start_thread(void* args_ptr); }
@@ -84,21 +88,13 @@ namespace
 
     static std::vector<std::string> key_vec;
     static std::atomic<int> key_cnt;
-    static std::vector<std::vector<size_t>> ops_map;
-    static std::vector<std::mutex*> ops_map_sync;
-    static struct ops_map_sync_deleter
-    {
-        ~ops_map_sync_deleter()
-        {
-            std::for_each(ops_map_sync.begin(), ops_map_sync.end(),
-                          [](auto entry) { delete entry; });
-        }
-    } ops_map_sync_deleter;
-    static std::array<std::atomic<size_t>, oc_max> total_ops;
     static std::atomic<size_t> total_allocations;
-    static std::atomic<size_t> mutex_contention;
-    static std::unordered_map<std::string, size_t> mutex_contention_counts;
     static int op_level;
+    // Instrument one in sample_interval acquisitions per key and
+    // thread, the rest go directly to the pthread objects. Zero
+    // instruments only the slow paths: contended mutex locks and
+    // condition waits.
+    static size_t sample_interval = 1;
     // Check correct condition variable usage:
     // - Associated mutex must be locked when waiting for cond
     // - There must be at least one waiter when signalling for condition
@@ -117,9 +113,6 @@ namespace
     static inline int append_key(const char* name, const char* type)
     {
         key_vec.push_back(std::string(name) + "_" + type);
-        ops_map.push_back(std::vector<size_t>());
-        ops_map_sync.push_back(new std::mutex());
-        ops_map.back().resize(oc_max);
         return ++key_cnt;
     }
 
@@ -142,6 +135,126 @@ namespace
         return key_vec[index];
     }
 
+    typedef std::chrono::steady_clock ti_clock;
+
+    // Wait and hold times are measured on level 3.
+    static inline bool timing() { return op_level >= 3; }
+
+    // Counters are written only by the owning thread, plain load and
+    // store avoid the cost of atomic read-modify-write.
+    static inline void increment(std::atomic<size_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+    }
+
+    struct key_counters
+    {
+        key_counters() : ops(), contended(), wait(), hold(), skipped() { }
+        std::array<std::atomic<size_t>, oc_max> ops;
+        // Mutex locks which had to wait for the mutex
+        std::atomic<size_t> contended;
+        // Nanoseconds waited for contended mutex or condition and
+        // mutex hold times, protected by thread_counters::mutex.
+        db::histogram wait;
+        db::histogram hold;
+        // Operations skipped since the last sample, owner thread only.
+        size_t skipped;
+    };
+
+    // Counters of a single thread. The thread updates its own block
+    // without synchronizing with other threads, the blocks are
+    // merged in db::ti::stats().
+    struct thread_counters
+    {
+        thread_counters() : mutex(), totals(), contended(), keys() { }
+        // Protects histograms and growing keys against stats()
+        std::mutex mutex;
+        std::array<std::atomic<size_t>, oc_max> totals;
+        std::atomic<size_t> contended;
+        std::vector<std::unique_ptr<key_counters>> keys;
+
+        // Must be called by the owning thread or with mutex locked.
+        key_counters& key(size_t index)
+        {
+            if (index >= keys.size() || not keys[index])
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (index >= keys.size()) keys.resize(index + 1);
+                keys[index].reset(new key_counters());
+            }
+            return *keys[index];
+        }
+
+        // Add counters of other into this, the mutex of other must
+        // be locked.
+        void merge(thread_counters& other)
+        {
+            for (size_t i(0); i < totals.size(); ++i)
+            {
+                totals[i] += other.totals[i];
+            }
+            contended += other.contended;
+            for (size_t i(0); i < other.keys.size(); ++i)
+            {
+                if (not other.keys[i]) continue;
+                const key_counters& from(*other.keys[i]);
+                key_counters& to(key(i));
+                for (size_t j(0); j < to.ops.size(); ++j)
+                {
+                    to.ops[j] += from.ops[j];
+                }
+                to.contended += from.contended;
+                to.wait.merge(from.wait);
+                to.hold.merge(from.hold);
+            }
+        }
+    };
+
+    // Counter blocks of running threads and sum of the exited ones
+    static std::mutex counters_mutex;
+    static std::vector<thread_counters*> thread_counters_list;
+    static thread_counters exited_counters;
+
+    // Plain pointers are used for thread local state so that the
+    // counters are not recreated by the instrumented objects which
+    // are destroyed after the thread local destructors have run.
+    thread_local thread_counters* this_counters = nullptr;
+    thread_local bool this_counters_released = false;
+
+    struct thread_counters_release
+    {
+        ~thread_counters_release()
+        {
+            std::lock_guard<std::mutex> lock(counters_mutex);
+            thread_counters_list.erase(
+                std::find(thread_counters_list.begin(),
+                          thread_counters_list.end(), this_counters));
+            {
+                std::lock_guard<std::mutex> counters_lock(
+                    this_counters->mutex);
+                exited_counters.merge(*this_counters);
+            }
+            delete this_counters;
+            this_counters = nullptr;
+            this_counters_released = true;
+        }
+    };
+
+    static inline thread_counters* get_thread_counters()
+    {
+        if (this_counters == nullptr && not this_counters_released)
+        {
+            this_counters = new thread_counters();
+            {
+                std::lock_guard<std::mutex> lock(counters_mutex);
+                thread_counters_list.push_back(this_counters);
+            }
+            static thread_local thread_counters_release release;
+        }
+        return this_counters;
+    }
+
     // Note: Do not refer the obj pointer in this function, it may
     // have been deleted before the call.
     template <class Key>
@@ -151,7 +264,10 @@ namespace
     {
         if (op_level < 1)
             return;
-        total_ops[op] += 1;
+        thread_counters* counters(get_thread_counters());
+        if (not counters)
+            return;
+        increment(counters->totals[op]);
         if (op_level < 2)
             return;
         if (false && op == oc_mutex_destroy)
@@ -162,8 +278,82 @@ namespace
                               << " op: " << ti_opstring(op);
         }
 
-        std::lock_guard<std::mutex> lock(*ops_map_sync[get_key_index(key)]);
-        ops_map[get_key_index(key)][op] += 1;
+        increment(counters->key(get_key_index(key)).ops[op]);
+    }
+
+    // Return true if the next acquisition or signal of key should be
+    // instrumented.
+    template <class Key> static inline bool sample(const Key* key)
+    {
+        if (op_level < 1 || sample_interval == 0)
+            return false;
+        if (sample_interval == 1)
+            return true;
+        thread_counters* counters(get_thread_counters());
+        if (not counters)
+            return false;
+        key_counters& kc(counters->key(get_key_index(key)));
+        if (++kc.skipped < sample_interval)
+            return false;
+        kc.skipped = 0;
+        return true;
+    }
+
+    static inline bool sample_slow_path()
+    {
+        return op_level >= 1 && sample_interval == 0;
+    }
+
+    // Multiplier for sampled counts
+    static inline size_t sample_scale()
+    {
+        return std::max(sample_interval, size_t(1));
+    }
+
+    static inline bool sampled_op(enum ti_opcode op)
+    {
+        switch (op)
+        {
+        case oc_mutex_lock:
+        case oc_mutex_trylock:
+        case oc_mutex_unlock:
+        case oc_cond_wait:
+        case oc_cond_timedwait:
+        case oc_cond_signal:
+        case oc_cond_broadcast:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    template <class Key>
+    static inline void update_contention(const Key* key)
+    {
+        if (op_level < 1)
+            return;
+        thread_counters* counters(get_thread_counters());
+        if (not counters)
+            return;
+        increment(counters->contended);
+        if (op_level < 2)
+            return;
+        increment(counters->key(get_key_index(key)).contended);
+    }
+
+    template <class Key>
+    static inline void record_time(const Key* key,
+                                   db::histogram key_counters::*histogram,
+                                   ti_clock::duration duration)
+    {
+        thread_counters* counters(get_thread_counters());
+        if (not counters)
+            return;
+        key_counters& kc(counters->key(get_key_index(key)));
+        std::lock_guard<std::mutex> lock(counters->mutex);
+        (kc.*histogram).record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                duration).count()));
     }
 
     struct thread_args
@@ -210,6 +400,8 @@ namespace
 
         bool detached() const { return detached_; }
 
+        const wsrep::thread_service::thread_key* key() const { return key_; }
+
         void retval(void* retval) { retval_ = retval; }
 
         static ti_thread* self();
@@ -237,6 +429,37 @@ namespace
 
     thread_local ti_thread* this_ti_thread = nullptr;
 
+    // CPUs allowed for threads by key name prefix, see
+    // db::ti::set_placement().
+    static std::mutex placement_mutex;
+    static std::vector<std::pair<std::string, std::vector<int>>> placements;
+
+    static int apply_thread_placement(const std::string& name)
+    {
+        std::vector<int> cpus;
+        {
+            std::lock_guard<std::mutex> lock(placement_mutex);
+            size_t matched(0);
+            for (const auto& p : placements)
+            {
+                if (p.first.size() >= matched &&
+                    name.compare(0, p.first.size(), p.first) == 0)
+                {
+                    matched = p.first.size();
+                    cpus = p.second;
+                }
+            }
+        }
+        if (cpus.empty())
+        {
+            return 0;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
     static bool main_thread_initializer()
     {
         const auto* main_thread_key
@@ -261,6 +484,8 @@ namespace
             : mutex_(PTHREAD_MUTEX_INITIALIZER)
             , key_(key)
             , inplace_(inplace)
+            , locked_at_()
+            , sampled_()
 #ifndef NDEBUG
             , locked_()
             , owner_()
@@ -277,17 +502,27 @@ namespace
 
         int lock()
         {
-            update_ops(this, key_, oc_mutex_lock);
+            bool sampled(sample(key_));
+            if (sampled) update_ops(this, key_, oc_mutex_lock);
             int ret(pthread_mutex_trylock(&mutex_));
             if (ret == EBUSY)
             {
-                mutex_contention++;
+                sampled = sampled || sample_slow_path();
+                const ti_clock::time_point start(
+                    sampled && timing() ? ti_clock::now()
+                    : ti_clock::time_point());
+                ret = pthread_mutex_lock(&mutex_);
+                if (sampled)
                 {
-                    std::lock_guard<std::mutex> lock(*ops_map_sync[get_key_index(key_)]);
-                    mutex_contention_counts[get_key_name(key_)] += 1;
+                    update_contention(key_);
+                    if (timing())
+                    {
+                        record_time(key_, &key_counters::wait,
+                                    ti_clock::now() - start);
+                    }
                 }
-                ret = pthread_mutex_lock(&mutex_);
             }
+            if (ret == 0) start_hold(sampled);
 #ifndef NDEBUG
             if (ret == 0)
             {
@@ -300,8 +535,10 @@ namespace
         }
         int trylock()
         {
-            update_ops(this, key_, oc_mutex_trylock);
+            const bool sampled(sample(key_));
+            if (sampled) update_ops(this, key_, oc_mutex_trylock);
             int ret(pthread_mutex_trylock(&mutex_));
+            if (ret == 0) start_hold(sampled);
 #ifndef NDEBUG
             if (ret == 0)
             {
@@ -323,11 +560,39 @@ namespace
             // Use temporary object. After mutex is unlocked it may be
             // destroyed before this update_ops() finishes.
             auto key(key_);
+            const bool sampled(sampled_);
+            const ti_clock::duration held(held_time());
+            sampled_ = false;
             int ret(pthread_mutex_unlock(&mutex_));
-            update_ops(this, key, oc_mutex_unlock);
+            if (sampled)
+            {
+                update_ops(this, key, oc_mutex_unlock);
+                if (timing()) record_time(key, &key_counters::hold, held);
+            }
             return ret;
         }
 
+        // Called after the mutex has been locked. If the acquisition
+        // was sampled, the unlock is instrumented and hold time is
+        // measured.
+        void start_hold(bool sampled)
+        {
+            sampled_ = sampled;
+            locked_at_ = sampled && timing() ? ti_clock::now()
+                : ti_clock::time_point();
+        }
+
+        bool sampled() const { return sampled_; }
+
+        // Time since start_hold(), called before the mutex
+        // is unlocked.
+        ti_clock::duration held_time() const
+        {
+            return locked_at_ != ti_clock::time_point()
+                ? ti_clock::now() - locked_at_
+                : ti_clock::duration::zero();
+        }
+
         struct condwait_context
         {
 #ifndef NDEBUG
@@ -369,6 +634,8 @@ namespace
         pthread_mutex_t mutex_;
         const wsrep::thread_service::mutex_key* key_;
         const bool inplace_;
+        ti_clock::time_point locked_at_;
+        bool sampled_;
 #ifndef NDEBUG
         bool locked_;
         std::atomic<std::thread::id> owner_;
@@ -398,14 +665,34 @@ namespace
             cond_check(pthread_mutex_trylock(mutex.native_handle()),
                        get_key_name(key_), "Mutex not locked in cond wait");
             waiter_ = true;
-            update_ops(this, key_, oc_cond_wait);
+            // Condition wait is a slow path
+            const bool sampled(sample(key_) || sample_slow_path());
+            if (sampled) update_ops(this, key_, oc_cond_wait);
             // update_ops(&mutex, mutex.key(), oc_mutex_unlock);
             auto condwait_ctx(mutex.save_for_condwait());
             mutex.reset();
+            const bool mutex_sampled(mutex.sampled());
+            const ti_clock::duration held(mutex.held_time());
+            const ti_clock::time_point start(
+                sampled && timing() ? ti_clock::now()
+                : ti_clock::time_point());
             int ret(pthread_cond_wait(&cond_, mutex.native_handle()));
             // update_ops(&mutex, mutex.key(), oc_mutex_lock);
+            mutex.start_hold(mutex_sampled);
             mutex.restore_from_condwait(condwait_ctx);
             waiter_ = false;
+            if (timing())
+            {
+                if (sampled)
+                {
+                    record_time(key_, &key_counters::wait,
+                                ti_clock::now() - start);
+                }
+                if (mutex_sampled)
+                {
+                    record_time(mutex.key(), &key_counters::hold, held);
+                }
+            }
             return ret;
         }
 
@@ -414,20 +701,40 @@ namespace
             cond_check(pthread_mutex_trylock(mutex.native_handle()),
                        get_key_name(key_), "Mutex not locked in cond wait");
             waiter_ = true;
-            update_ops(this, key_, oc_cond_timedwait);
+            // Condition wait is a slow path
+            const bool sampled(sample(key_) || sample_slow_path());
+            if (sampled) update_ops(this, key_, oc_cond_timedwait);
             // update_ops(&mutex, mutex.key(), oc_mutex_unlock);
             auto condwait_ctx(mutex.save_for_condwait());
             mutex.reset();
+            const bool mutex_sampled(mutex.sampled());
+            const ti_clock::duration held(mutex.held_time());
+            const ti_clock::time_point start(
+                sampled && timing() ? ti_clock::now()
+                : ti_clock::time_point());
             int ret(pthread_cond_timedwait(&cond_, mutex.native_handle(), ts));
             // update_ops(&mutex, mutex.key(), oc_mutex_lock);
+            mutex.start_hold(mutex_sampled);
             mutex.restore_from_condwait(condwait_ctx);
             waiter_ = false;
+            if (timing())
+            {
+                if (sampled)
+                {
+                    record_time(key_, &key_counters::wait,
+                                ti_clock::now() - start);
+                }
+                if (mutex_sampled)
+                {
+                    record_time(mutex.key(), &key_counters::hold, held);
+                }
+            }
             return ret;
         }
 
         int signal()
         {
-            update_ops(this, key_, oc_cond_signal);
+            if (sample(key_)) update_ops(this, key_, oc_cond_signal);
             cond_check(waiter_, get_key_name(key_),
                        "Signalling condition variable without waiter");
             return pthread_cond_signal(&cond_);
@@ -435,7 +742,7 @@ namespace
 
         int broadcast()
         {
-            update_ops(this, key_, oc_cond_broadcast);
+            if (sample(key_)) update_ops(this, key_, oc_cond_broadcast);
             return pthread_cond_broadcast(&cond_);
         }
 
@@ -474,6 +781,11 @@ static void* start_thread(void* args_ptr)
     void* (*fn)(void*) = ta->fn;
     void* args = ta->args;
     delete ta;
+    if (int err = apply_thread_placement(get_key_name(thread->key())))
+    {
+        wsrep::log_warning() << "Failed to set placement for thread "
+                             << get_key_name(thread->key()) << ": " << err;
+    }
     void* ret = (*fn)(args);
     this_ti_thread = nullptr;
     // If we end here the thread returned instead of calling
@@ -566,6 +878,82 @@ int db::ti::getschedparam(wsrep::thread_service::thread* thread,
     return reinterpret_cast<ti_thread*>(thread)->getschedparam(policy, param);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+//                              Placement                                   //
+//////////////////////////////////////////////////////////////////////////////
+
+int db::ti::set_placement(const char* name,
+                          const wsrep::thread_service::placement& placement)
+{
+    std::vector<int> cpus(placement.cpus);
+    if (placement.numa_node >= 0)
+    {
+        std::ostringstream path;
+        path << "/sys/devices/system/node/node" << placement.numa_node
+             << "/cpulist";
+        std::ifstream file(path.str());
+        std::string cpulist;
+        std::vector<int> node_cpus;
+        if (not std::getline(file, cpulist) ||
+            parse_cpu_list(cpulist, node_cpus))
+        {
+            return EINVAL;
+        }
+        if (cpus.empty())
+        {
+            cpus = node_cpus;
+        }
+        else
+        {
+            std::sort(cpus.begin(), cpus.end());
+            std::sort(node_cpus.begin(), node_cpus.end());
+            std::vector<int> both;
+            std::set_intersection(cpus.begin(), cpus.end(),
+                                  node_cpus.begin(), node_cpus.end(),
+                                  std::back_inserter(both));
+            if (both.empty()) return EINVAL;
+            cpus.swap(both);
+        }
+    }
+    for (int cpu : cpus)
+    {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) return EINVAL;
+    }
+    std::lock_guard<std::mutex> lock(placement_mutex);
+    placements.push_back(std::make_pair(std::string(name), cpus));
+    return 0;
+}
+
+int db::ti::apply_placement(const char* name) WSREP_NOEXCEPT
+{
+    try
+    {
+        return apply_thread_placement(name);
+    }
+    catch (...)
+    {
+        return ENOMEM;
+    }
+}
+
+int db::ti::parse_cpu_list(const std::string& str, std::vector<int>& cpus)
+{
+    std::istringstream is(str);
+    std::string range;
+    while (std::getline(is, range, ','))
+    {
+        int first, last;
+        char dash;
+        std::istringstream rs(range);
+        if (not (rs >> first)) return 1;
+        last = first;
+        if (rs >> dash && (dash != '-' || not (rs >> last))) return 1;
+        if (first < 0 || last < first) return 1;
+        for (int cpu(first); cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus.empty();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //                                Mutex                                     //
 //////////////////////////////////////////////////////////////////////////////
@@ -680,6 +1068,11 @@ void db::ti::level(int level)
     ::op_level = level;
 }
 
+void db::ti::sample(size_t interval)
+{
+    ::sample_interval = interval;
+}
+
 void db::ti::cond_checks(bool cond_checks)
 {
     if (cond_checks)
@@ -687,40 +1080,110 @@ void db::ti::cond_checks(bool cond_checks)
     ::cond_checks = cond_checks;
 }
 
+namespace
+{
+    void print_times(std::ostream& os, const char* label,
+                     const db::histogram& h)
+    {
+        os << " " << label << " count " << h.count() * sample_scale()
+           << " p50 " << double(h.percentile(50.)) / 1000.
+           << " p99 " << double(h.percentile(99.)) / 1000.
+           << " max " << double(h.max()) / 1000.;
+    }
+}
+
 std::string db::ti::stats()
 {
+    thread_counters counters;
+    {
+        std::lock_guard<std::mutex> lock(counters_mutex);
+        counters.merge(exited_counters);
+        for (auto* c : thread_counters_list)
+        {
+            std::lock_guard<std::mutex> counters_lock(c->mutex);
+            counters.merge(*c);
+        }
+    }
+    auto scaled([](size_t op, size_t count)
+                {
+                    return sampled_op(static_cast<enum ti_opcode>(op))
+                        ? count * sample_scale() : count;
+                });
     std::ostringstream os;
+    if (sample_interval == 0)
+    {
+        os << "Sampling: slow paths only\n";
+    }
+    else if (sample_interval > 1)
+    {
+        os << "Sampling: one in " << sample_interval
+           << " operations, counts are extrapolated\n";
+    }
     os << "Totals:\n";
-    for (size_t i(0); i < total_ops.size(); ++i)
+    for (size_t i(0); i < counters.totals.size(); ++i)
     {
-        if (total_ops[i] > 0)
+        if (counters.totals[i] > 0)
         {
             os << "  " << ti_opstring(static_cast<enum ti_opcode>(i)) << ": "
-               << total_ops[i] << "\n";
+               << scaled(i, counters.totals[i]) << "\n";
         }
     }
     os << "Total allocations: " << total_allocations << "\n";
-    os << "Mutex contention: " << mutex_contention << "\n";
-    for (auto i : mutex_contention_counts)
+    os << "Mutex contention: " << counters.contended * sample_scale()
+       << "\n";
+    // Most contended first
+    std::vector<std::pair<size_t, std::string>> contended;
+    for (size_t i(0); i < counters.keys.size(); ++i)
     {
-        os << "  " << i.first << ": " << i.second << "\n";
+        if (counters.keys[i] && counters.keys[i]->contended)
+        {
+            contended.push_back(std::make_pair(
+                                    counters.keys[i]->contended.load(),
+                                    get_key_name_by_index(i)));
+        }
+    }
+    std::sort(contended.rbegin(), contended.rend());
+    for (const auto& i : contended)
+    {
+        os << "  " << i.second << ": " << i.first * sample_scale() << "\n";
     }
     os << "Per key:\n";
-    std::map<std::string, std::vector<size_t>> sorted;
-    for (size_t i(0); i < ops_map.size(); ++i)
+    std::map<std::string, const key_counters*> sorted;
+    for (size_t i(0); i < counters.keys.size(); ++i)
     {
-        sorted.insert(std::make_pair(get_key_name_by_index(i), ops_map[i]));
+        if (counters.keys[i])
+        {
+            sorted.insert(std::make_pair(get_key_name_by_index(i),
+                                         counters.keys[i].get()));
+        }
     }
-    for (auto i : sorted)
+    for (const auto& i : sorted)
     {
-        for (size_t j(0); j < i.second.size(); ++j)
+        for (size_t j(0); j < i.second->ops.size(); ++j)
         {
-            if (i.second[j])
+            if (i.second->ops[j])
             {
                 os << "  " << i.first << ": "
                    << ti_opstring(static_cast<enum ti_opcode>(j)) << ": "
-                   << i.second[j] << "\n";
+                   << scaled(j, i.second->ops[j]) << "\n";
+            }
+        }
+    }
+    if (timing())
+    {
+        os << "Wait and hold times (us):\n";
+        for (const auto& i : sorted)
+        {
+            if (i.second->wait.count() == 0 && i.second->hold.count() == 0)
+            {
+                continue;
             }
+            os << "  " << i.first << ":";
+            if (i.second->wait.count())
+                print_times(os, "wait", i.second->wait);
+            if (i.second->hold.count())
+                print_times(os, "hold", i.second->hold);
+            os << "\n";
         }
     }
     return os.str();
@@ -22,6 +22,7 @@
 
 #include "wsrep/thread_service.hpp"
 #include <string>
+#include <vector>
 
 namespace db
 {
@@ -47,6 +48,10 @@ namespace db
                           const struct sched_param*) WSREP_NOEXCEPT override;
         int getschedparam(wsrep::thread_service::thread*, int*,
                           struct sched_param*) WSREP_NOEXCEPT override;
+        /* Placement */
+        int set_placement(const char* name,
+                          const wsrep::thread_service::placement&) override;
+        int apply_placement(const char* name) WSREP_NOEXCEPT override;
 
         /* Mutex */
         const wsrep::thread_service::mutex_key*
@@ -74,8 +79,20 @@ namespace db
         int broadcast(wsrep::thread_service::cond* cond) WSREP_NOEXCEPT override;
 
         static void level(int level);
+        /**
+         * Instrument one in interval mutex acquisitions and
+         * condition operations per key and thread. Zero instruments
+         * only contended mutex locks and condition waits.
+         */
+        static void sample(size_t interval);
         static void cond_checks(bool cond_checks);
         static std::string stats();
+
+        /**
+         * Parse list of CPUs in the format of /sys cpulist files,
+         * e.g. "0-3,8". Return zero on success.
+         */
+        static int parse_cpu_list(const std::string&, std::vector<int>&);
     };
 
 
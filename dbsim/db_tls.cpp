@@ -31,12 +31,14 @@
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/socket.h> // send()
+#include <sys/uio.h> // readv()
 #include <cassert>
 #include <cerrno>
 #include <cstring>
 
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace
 {
@@ -95,6 +97,10 @@ namespace
 
         wsrep::tls_service::op_result write(const void*, size_t);
 
+        wsrep::tls_service::op_result readv(const struct iovec*, int);
+
+        wsrep::tls_service::op_result writev(const struct iovec*, int);
+
         enum state state() const { return state_; }
 
         int fd() const { return fd_; }
@@ -132,6 +138,60 @@ namespace
             else return ::send(fd_, buf, count, MSG_NOSIGNAL);
         }
 
+        ssize_t do_readv(const struct iovec* iov, int iovcnt)
+        {
+            if (is_blocking_ || mode_ < 3)
+                return ::readv(fd_, iov, iovcnt);
+            else if (::rand() % 1000 == 0)
+            {
+                errno = EINTR;
+                return -1;
+            }
+            else return ::readv(fd_, iov, iovcnt);
+        }
+
+        // Use sendmsg() instead of ::writev() to pass MSG_NOSIGNAL.
+        ssize_t do_writev(const struct iovec* iov, int iovcnt)
+        {
+            struct msghdr msg;
+            ::memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = const_cast<struct iovec*>(iov);
+            msg.msg_iovlen = size_t(iovcnt);
+            if (is_blocking_ || mode_ < 3)
+                return ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+            else if (::rand() % 1000 == 0)
+            {
+                errno = EINTR;
+                return -1;
+            }
+            else return ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+        }
+
+        // Copy iov into truncated so that the total length does not
+        // exceed count. Returns the number of buffers in truncated.
+        static int truncate(const struct iovec* iov, int iovcnt,
+                            size_t count, std::vector<struct iovec>& truncated)
+        {
+            truncated.assign(iov, iov + iovcnt);
+            for (int i(0); i < iovcnt; ++i)
+            {
+                if (truncated[size_t(i)].iov_len >= count)
+                {
+                    truncated[size_t(i)].iov_len = count;
+                    return i + 1;
+                }
+                count -= truncated[size_t(i)].iov_len;
+            }
+            return iovcnt;
+        }
+
+        static size_t total_length(const struct iovec* iov, int iovcnt)
+        {
+            size_t ret(0);
+            for (int i(0); i < iovcnt; ++i) ret += iov[i].iov_len;
+            return ret;
+        }
+
         wsrep::tls_service::op_result map_success(ssize_t result)
         {
             if (is_blocking_ || mode_ < 2)
@@ -160,7 +220,10 @@ namespace
             }
         }
 
-        wsrep::tls_service::op_result map_result(ssize_t result)
+        // Map system call result, want is the status to return if
+        // the call would block.
+        wsrep::tls_service::op_result map_result(
+            ssize_t result, enum wsrep::tls_service::status want)
         {
             if (result > 0)
             {
@@ -173,8 +236,7 @@ namespace
             }
             else if (errno == EAGAIN || errno == EWOULDBLOCK)
             {
-                return wsrep::tls_service::op_result{
-                    wsrep::tls_service::want_read, 0};
+                return wsrep::tls_service::op_result{want, 0};
             }
             else
             {
@@ -330,7 +392,7 @@ namespace
         {
             inc_reads(size_t(read_result));
         }
-        return map_result(read_result);
+        return map_result(read_result, wsrep::tls_service::want_read);
     }
 
     wsrep::tls_service::op_result db_stream::write(
@@ -350,7 +412,69 @@ namespace
         {
             inc_writes(size_t(write_result));
         }
-        return map_result(write_result);
+        return map_result(write_result, wsrep::tls_service::want_write);
+    }
+
+    wsrep::tls_service::op_result db_stream::readv(
+        const struct iovec* iov, int iovcnt)
+    {
+        clear_error();
+        const size_t max_count(total_length(iov, iovcnt));
+        if (state_ == s_want_read)
+        {
+            state_ = s_idle;
+            if (max_count == 0)
+                return wsrep::tls_service::op_result{
+                    wsrep::tls_service::success, 0};
+        }
+        const size_t count(determine_read_count(max_count));
+        ssize_t read_result;
+        if (count < max_count)
+        {
+            std::vector<struct iovec> truncated;
+            const int n(truncate(iov, iovcnt, count, truncated));
+            read_result = do_readv(truncated.data(), n);
+        }
+        else
+        {
+            read_result = do_readv(iov, iovcnt);
+        }
+        if (read_result > 0)
+        {
+            inc_reads(size_t(read_result));
+        }
+        return map_result(read_result, wsrep::tls_service::want_read);
+    }
+
+    wsrep::tls_service::op_result db_stream::writev(
+        const struct iovec* iov, int iovcnt)
+    {
+        clear_error();
+        const size_t max_count(total_length(iov, iovcnt));
+        if (state_ == s_want_write)
+        {
+            state_ = s_idle;
+            if (max_count == 0)
+                return wsrep::tls_service::op_result{
+                    wsrep::tls_service::success, 0};
+        }
+        const size_t count(determine_write_count(max_count));
+        ssize_t write_result;
+        if (count < max_count)
+        {
+            std::vector<struct iovec> truncated;
+            const int n(truncate(iov, iovcnt, count, truncated));
+            write_result = do_writev(truncated.data(), n);
+        }
+        else
+        {
+            write_result = do_writev(iov, iovcnt);
+        }
+        if (write_result > 0)
+        {
+            inc_writes(size_t(write_result));
+        }
+        return map_result(write_result, wsrep::tls_service::want_write);
     }
 }
 
@@ -428,6 +552,20 @@ wsrep::tls_service::op_result db::tls::write(
     return static_cast<db_stream*>(stream)->write(buf, count);
 }
 
+wsrep::tls_service::op_result db::tls::readv(
+    wsrep::tls_stream* stream,
+    const struct iovec* iov, int iovcnt) WSREP_NOEXCEPT
+{
+    return static_cast<db_stream*>(stream)->readv(iov, iovcnt);
+}
+
+wsrep::tls_service::op_result db::tls::writev(
+    wsrep::tls_stream* stream,
+    const struct iovec* iov, int iovcnt) WSREP_NOEXCEPT
+{
+    return static_cast<db_stream*>(stream)->writev(iov, iovcnt);
+}
+
 wsrep::tls_service::status
 db::tls::shutdown(wsrep::tls_stream*) WSREP_NOEXCEPT
 {
@@ -51,6 +51,12 @@ namespace db
         virtual wsrep::tls_service::op_result
         write(wsrep::tls_stream*, const void* buf, size_t count)
             WSREP_NOEXCEPT override;
+        virtual wsrep::tls_service::op_result
+        readv(wsrep::tls_stream*, const struct iovec* iov, int iovcnt)
+            WSREP_NOEXCEPT override;
+        virtual wsrep::tls_service::op_result
+        writev(wsrep::tls_stream*, const struct iovec* iov, int iovcnt)
+            WSREP_NOEXCEPT override;
         virtual wsrep::tls_service::status
         shutdown(wsrep::tls_stream*) WSREP_NOEXCEPT override;
 
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "db_workload.hpp"
+
+#include <cmath>
+#include <sstream>
+
+db::key_distribution::key_distribution(const db::params& params)
+    : type_(params.key_distribution == "zipf" ? zipf :
+            params.key_distribution == "hotspot" ? hotspot : uniform)
+    , rows_(params.n_rows)
+    , theta_(params.zipf_theta)
+    , zetan_()
+    , alpha_()
+    , eta_()
+    , hot_rows_(std::max(uint64_t(1),
+                         uint64_t(double(params.n_rows) *
+                                  params.hotspot_rows)))
+    , hot_access_(params.hotspot_access)
+{
+    if (type_ == zipf)
+    {
+        for (uint64_t i(1); i <= rows_; ++i)
+        {
+            zetan_ += 1.0 / std::pow(double(i), theta_);
+        }
+        const double zeta2(1.0 + 1.0 / std::pow(2.0, theta_));
+        alpha_ = 1.0 / (1.0 - theta_);
+        eta_ = (1.0 - std::pow(2.0 / double(rows_), 1.0 - theta_)) /
+            (1.0 - zeta2 / zetan_);
+    }
+}
+
+uint64_t db::key_distribution::operator()(
+    std::default_random_engine& engine) const
+{
+    switch (type_)
+    {
+    case uniform:
+        break;
+    case zipf:
+        return zipf_row(engine);
+    case hotspot:
+        if (hot_rows_ < rows_)
+        {
+            if (std::uniform_real_distribution<double>()(engine) <
+                hot_access_)
+            {
+                return std::uniform_int_distribution<uint64_t>(
+                    0, hot_rows_ - 1)(engine);
+            }
+            return std::uniform_int_distribution<uint64_t>(
+                hot_rows_, rows_ - 1)(engine);
+        }
+        break;
+    }
+    return std::uniform_int_distribution<uint64_t>(0, rows_ - 1)(engine);
+}
+
+uint64_t db::key_distribution::zipf_row(
+    std::default_random_engine& engine) const
+{
+    const double u(std::uniform_real_distribution<double>()(engine));
+    const double uz(u * zetan_);
+    if (uz < 1.0)
+    {
+        return 0;
+    }
+    if (uz < 1.0 + std::pow(0.5, theta_))
+    {
+        return std::min(uint64_t(1), rows_ - 1);
+    }
+    const uint64_t row(static_cast<uint64_t>(
+                           double(rows_) *
+                           std::pow(eta_ * u - eta_ + 1.0, alpha_)));
+    return std::min(row, rows_ - 1);
+}
+
+enum db::workload::kind db::workload::next_kind(
+    std::default_random_engine& engine)
+{
+    ++transactions_;
+    if (params_.toi_interval && transactions_ % params_.toi_interval == 0)
+    {
+        return k_toi;
+    }
+    if (params_.sr_ratio > 0 || params_.xa_ratio > 0)
+    {
+        const double r(std::uniform_real_distribution<double>()(engine));
+        if (r < params_.sr_ratio)
+        {
+            return k_streaming;
+        }
+        if (r < params_.sr_ratio + params_.xa_ratio)
+        {
+            return k_xa;
+        }
+    }
+    return k_regular;
+}
+
+db::workload::row_op db::workload::next_row_op(
+    std::default_random_engine& engine) const
+{
+    row_op ret;
+    ret.key.space = (params_.key_spaces ?
+                     std::uniform_int_distribution<uint64_t>(
+                         1, params_.key_spaces)(engine) :
+                     client_key_);
+    ret.key.row = key_distribution_(engine);
+    ret.write = (params_.read_ratio <= 0 ||
+                 std::uniform_real_distribution<double>()(engine) >=
+                 params_.read_ratio);
+    return ret;
+}
+
+wsrep::xid db::workload::xid(const wsrep::id& server_id,
+                             wsrep::transaction_id transaction_id)
+{
+    std::ostringstream os;
+    os << server_id << ":" << transaction_id.get();
+    const std::string gtrid(os.str());
+    // Maximum gtrid length is 64 bytes, keep the transaction id part.
+    const size_t len(std::min(gtrid.size(), size_t(64)));
+    return wsrep::xid(1, long(len), 0, gtrid.data() + gtrid.size() - len);
+}
+
+db::arrival_schedule::arrival_schedule(const db::params& params)
+    : mutex_()
+    , rate_(params.rate)
+    , rate_step_(params.rate_step)
+    , steps_(params.rate_steps)
+    , step_duration_(std::chrono::duration_cast<clock::duration>(
+                         std::chrono::duration<double>(
+                             params.rate_step_duration)))
+    , poisson_(params.arrival == "poisson")
+    , arrivals_left_(params.n_clients * params.n_transactions)
+    , start_()
+    , next_()
+    , engine_(std::random_device()())
+{ }
+
+void db::arrival_schedule::start(clock::time_point start)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    start_ = start;
+    next_ = start;
+}
+
+bool db::arrival_schedule::next(clock::time_point& intended, size_t& step)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (steps_ == 0)
+    {
+        if (arrivals_left_ == 0)
+        {
+            return false;
+        }
+        --arrivals_left_;
+        step = 0;
+    }
+    else
+    {
+        step = step_at(next_);
+        if (step >= steps_)
+        {
+            return false;
+        }
+    }
+    intended = next_;
+    const double r(rate(step));
+    const double interval(poisson_ ?
+                          std::exponential_distribution<double>(r)(engine_) :
+                          1. / r);
+    next_ += std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(interval));
+    return true;
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file db_workload.hpp
+ *
+ * Workload generator for dbsim clients.
+ *
+ * Each client transaction is one of
+ * - regular transaction with --statements statements each accessing
+ *   --rows-per-statement rows,
+ * - streaming replication transaction (--sr-ratio) which replicates
+ *   a fragment after every --sr-fragment-rows rows,
+ * - XA transaction (--xa-ratio) which is prepared before commit.
+ *   XA transactions which did not write any rows are committed
+ *   as regular transactions,
+ * - TOI statement (every --toi-interval transaction).
+ *
+ * A row access is a read with probability --read-ratio, otherwise
+ * a write. Rows are selected from key spaces according to
+ * --key-distribution. With --key-spaces=0 every client has its own
+ * key space, otherwise the key spaces are shared by all clients
+ * of all servers.
+ *
+ * By default clients run closed loop, each client starts the next
+ * transaction when the previous one completes. With --rate the
+ * clients of a server take the transaction start times from
+ * a shared arrival schedule instead, see db::arrival_schedule.
+ */
+
+#ifndef WSREP_DB_WORKLOAD_HPP
+#define WSREP_DB_WORKLOAD_HPP
+
+#include "db_params.hpp"
+#include "db_storage_engine.hpp"
+
+#include "wsrep/id.hpp"
+#include "wsrep/transaction_id.hpp"
+#include "wsrep/xid.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <random>
+
+namespace db
+{
+    /**
+     * Row number distribution. The object is immutable after
+     * construction and can be shared between clients.
+     */
+    class key_distribution
+    {
+    public:
+        key_distribution(const db::params&);
+        /** Return row number in range [0, --rows). */
+        uint64_t operator()(std::default_random_engine&) const;
+    private:
+        enum type
+        {
+            uniform,
+            zipf,
+            hotspot
+        };
+        uint64_t zipf_row(std::default_random_engine&) const;
+
+        enum type type_;
+        uint64_t rows_;
+        // Zipf parameters, see J. Gray et al., Quickly Generating
+        // Billion-Record Synthetic Databases, SIGMOD 1994.
+        double theta_;
+        double zetan_;
+        double alpha_;
+        double eta_;
+        // Hotspot parameters
+        uint64_t hot_rows_;
+        double hot_access_;
+    };
+
+    class workload
+    {
+    public:
+        enum kind
+        {
+            k_regular,
+            k_streaming,
+            k_xa,
+            k_toi
+        };
+
+        struct row_op
+        {
+            db::storage_engine::row_key key;
+            bool write;
+        };
+
+        workload(const db::params& params,
+                 const db::key_distribution& key_distribution,
+                 uint64_t client_key)
+            : params_(params)
+            , key_distribution_(key_distribution)
+            , client_key_(client_key)
+            , transactions_()
+        { }
+
+        /** Kind of the next transaction. */
+        enum kind next_kind(std::default_random_engine&);
+
+        /** Row access for the next row of a statement. */
+        row_op next_row_op(std::default_random_engine&) const;
+
+        /**
+         * XA transaction identifier. The identifier is derived from
+         * the originating server and transaction so that appliers
+         * can reconstruct it for prepare fragments.
+         */
+        static wsrep::xid xid(const wsrep::id& server_id,
+                              wsrep::transaction_id transaction_id);
+    private:
+        const db::params& params_;
+        const db::key_distribution& key_distribution_;
+        uint64_t client_key_;
+        size_t transactions_;
+    };
+
+    /**
+     * Arrival schedule for open-loop load. The arrivals follow
+     * --arrival schedule at --rate transactions per second. With
+     * --rate-steps the rate is increased by --rate-step every
+     * --rate-step-duration seconds and the schedule ends after the
+     * last step, otherwise it ends after --transactions arrivals
+     * per client.
+     *
+     * Free clients take the next arrival even if its start time
+     * is already past. Latency is measured from the intended start
+     * time, so the time an arrival waits for a client is included
+     * (coordinated omission correction).
+     */
+    class arrival_schedule
+    {
+    public:
+        typedef std::chrono::steady_clock clock;
+        arrival_schedule(const db::params&);
+        bool enabled() const { return rate_ > 0; }
+        /** Start the schedule at given time. */
+        void start(clock::time_point);
+        /**
+         * Get the next arrival. Return false if the schedule is over.
+         */
+        bool next(clock::time_point& intended, size_t& step);
+        /** Load step at given time. */
+        size_t step_at(clock::time_point time) const
+        {
+            return steps_ ? size_t((time - start_) / step_duration_) : 0;
+        }
+        /** Offered rate at load step. */
+        double rate(size_t step) const
+        { return rate_ + double(step) * rate_step_; }
+        size_t steps() const { return steps_; }
+        clock::duration step_duration() const { return step_duration_; }
+    private:
+        std::mutex mutex_;
+        double rate_;
+        double rate_step_;
+        size_t steps_;
+        clock::duration step_duration_;
+        bool poisson_;
+        size_t arrivals_left_;
+        clock::time_point start_;
+        clock::time_point next_;
+        std::default_random_engine engine_;
+    };
+}
+
+#endif // WSREP_DB_WORKLOAD_HPP
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "db_ws_replay.hpp"
+#include "db_loopback_provider.hpp"
+
+#include "wsrep/exception.hpp"
+#include "wsrep/logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+db::ws_replay::ws_replay(const std::string& path)
+    : records_()
+{
+    wsrep::ws_capture_reader reader(path);
+    wsrep::ws_capture_reader::record rec;
+    int ret;
+    while ((ret = reader.read(rec)) > 0)
+    {
+        records_.push_back(rec);
+    }
+    if (ret < 0)
+    {
+        throw wsrep::runtime_error("Corrupted capture file '" + path + "'");
+    }
+    std::stable_sort(records_.begin(), records_.end(),
+                     [](const wsrep::ws_capture_reader::record& a,
+                        const wsrep::ws_capture_reader::record& b)
+                     { return a.ws_meta.seqno() < b.ws_meta.seqno(); });
+    wsrep::log_info() << "Loaded " << records_.size()
+                      << " write sets from " << path;
+}
+
+void db::ws_replay::run(db::loopback_provider& provider, double speed)
+{
+    if (records_.empty())
+    {
+        return;
+    }
+    const wsrep::gtid first(provider.reserve_seqnos(records_.size()));
+    const long long base(first.seqno().get());
+    std::vector<long long> seqnos;
+    seqnos.reserve(records_.size());
+    for (const auto& rec : records_)
+    {
+        seqnos.push_back(rec.ws_meta.seqno().get());
+    }
+
+    const auto start(std::chrono::steady_clock::now());
+    const auto first_timestamp(records_.front().timestamp);
+    for (size_t i(0); i < records_.size(); ++i)
+    {
+        const wsrep::ws_capture_reader::record& rec(records_[i]);
+        if (speed > 0)
+        {
+            std::this_thread::sleep_until(
+                start + std::chrono::duration_cast<
+                std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double, std::nano>(
+                        double((rec.timestamp - first_timestamp).count())
+                        / speed)));
+        }
+        // Number of preceding write sets the original dependency
+        // covers, zero maps to the position before the replay.
+        const long long covered(
+            std::upper_bound(seqnos.begin(), seqnos.begin() + long(i),
+                             rec.ws_meta.depends_on().get())
+            - seqnos.begin());
+        provider.inject(
+            wsrep::ws_meta(wsrep::gtid(first.id(),
+                                       wsrep::seqno(base + long(i))),
+                           wsrep::stid(rec.ws_meta.server_id(),
+                                       rec.ws_meta.transaction_id(),
+                                       rec.ws_meta.client_id()),
+                           wsrep::seqno(base + covered - 1),
+                           rec.ws_meta.flags()),
+            rec.data);
+    }
+    provider.wait_committed(base + long(records_.size()) - 1);
+}
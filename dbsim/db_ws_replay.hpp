@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file db_ws_replay.hpp
+ *
+ * Replay of write sets captured with --ws-capture, see
+ * wsrep::ws_capture.
+ *
+ * The captured stream is loaded into memory and delivered to the
+ * appliers of a single server through the loopback provider, so
+ * that the write sets go through server_state::on_apply() and
+ * the commit order monitor as in the captured run.
+ *
+ * A capture of one server does not contain the transactions which
+ * were committed locally on that server. The write sets are
+ * therefore sorted by seqno and renumbered to consecutive seqnos
+ * following the current position. Dependencies on the missing
+ * seqnos are mapped to the preceding captured write set.
+ */
+
+#ifndef WSREP_DB_WS_REPLAY_HPP
+#define WSREP_DB_WS_REPLAY_HPP
+
+#include "wsrep/ws_capture.hpp"
+
+#include <string>
+#include <vector>
+
+namespace db
+{
+    class loopback_provider;
+
+    class ws_replay
+    {
+    public:
+        /**
+         * Load captured write sets from file.
+         *
+         * @throw wsrep::runtime_error if the file cannot be read.
+         */
+        ws_replay(const std::string& path);
+
+        /**
+         * Deliver the write sets to provider appliers and wait until
+         * all of them have been committed.
+         *
+         * @param speed Zero to deliver at maximum speed, otherwise
+         *        pace the delivery according to the capture times
+         *        scaled by speed.
+         */
+        void run(db::loopback_provider& provider, double speed);
+
+        /** Number of write sets loaded. */
+        size_t size() const { return records_.size(); }
+    private:
+        std::vector<wsrep::ws_capture_reader::record> records_;
+    };
+}
+
+#endif // WSREP_DB_WS_REPLAY_HPP
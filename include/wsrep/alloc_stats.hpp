@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file alloc_stats.hpp
+ *
+ * Per transaction phase allocation accounting.
+ *
+ * When wsrep-lib is compiled with WSREP_LIB_ALLOC_ACCOUNTING defined
+ * (CMake option WSREP_LIB_WITH_ALLOC_ACCOUNTING), the transaction
+ * processing entry points mark the phase which is being executed
+ * with WSREP_ALLOC_PHASE(). The library does not replace global
+ * operator new itself. Instead, the program which wants to collect
+ * the statistics must replace operator new and call
+ * wsrep::alloc_stats::record() for each allocation. Allocations
+ * done outside of any phase are accounted to p_none.
+ *
+ * The commit phase covers also prepare and rollback, the cleanup
+ * phase the end of statement processing and releasing the transaction
+ * resources.
+ *
+ * The phases may nest, allocations are accounted to the innermost
+ * phase. For example, allocations done in certification during
+ * before_commit() are accounted to the certify phase, and the
+ * commit processing done by the applier inside on_apply() to the
+ * commit phase.
+ *
+ * Counters are thread local, so they reflect only the work done
+ * by the calling thread.
+ *
+ * Without WSREP_LIB_ALLOC_ACCOUNTING the phase markers compile
+ * to nothing.
+ */
+
+#ifndef WSREP_ALLOC_STATS_HPP
+#define WSREP_ALLOC_STATS_HPP
+
+#include <cstddef>
+
+namespace wsrep
+{
+    class alloc_stats
+    {
+    public:
+        enum phase
+        {
+            p_none,
+            p_start,
+            p_append,
+            p_certify,
+            p_commit,
+            p_cleanup,
+            p_apply
+        };
+        static const int phases = p_apply + 1;
+
+        struct counters
+        {
+            unsigned long long allocations;
+            unsigned long long bytes;
+        };
+
+        /**
+         * Return true if the library was compiled with allocation
+         * accounting.
+         */
+        static bool enabled();
+
+        /**
+         * Record an allocation of size bytes for the current phase.
+         * Must not allocate.
+         */
+        static void record(size_t size)
+        {
+            counters& c(counters_[current_]);
+            ++c.allocations;
+            c.bytes += size;
+        }
+
+        /**
+         * Return counters for given phase in calling thread.
+         */
+        static counters get(enum phase phase) { return counters_[phase]; }
+
+        /**
+         * Return sum of counters over all phases except p_none.
+         */
+        static counters total();
+
+        /**
+         * Reset counters of the calling thread.
+         */
+        static void reset();
+
+        static enum phase current() { return current_; }
+
+        /**
+         * Scoped phase marker. The previous phase is restored in
+         * destructor.
+         */
+        class scope
+        {
+        public:
+            scope(enum phase phase)
+                : prev_(current_)
+            {
+                current_ = phase;
+            }
+            ~scope()
+            {
+                current_ = prev_;
+            }
+        private:
+            scope(const scope&);
+            scope& operator=(const scope&);
+            enum phase prev_;
+        };
+    private:
+        static thread_local enum phase current_;
+        static thread_local counters counters_[phases];
+    };
+
+    static inline const char* to_string(enum wsrep::alloc_stats::phase phase)
+    {
+        switch (phase)
+        {
+        case wsrep::alloc_stats::p_none:    return "none";
+        case wsrep::alloc_stats::p_start:   return "start";
+        case wsrep::alloc_stats::p_append:  return "append";
+        case wsrep::alloc_stats::p_certify: return "certify";
+        case wsrep::alloc_stats::p_commit:  return "commit";
+        case wsrep::alloc_stats::p_cleanup: return "cleanup";
+        case wsrep::alloc_stats::p_apply:   return "apply";
+        }
+        return "unknown";
+    }
+}
+
+#ifdef WSREP_LIB_ALLOC_ACCOUNTING
+#define WSREP_ALLOC_PHASE(phase_)                                       \
+    wsrep::alloc_stats::scope alloc_stats_scope_(wsrep::alloc_stats::phase_)
+#else
+#define WSREP_ALLOC_PHASE(phase_)
+#endif // WSREP_LIB_ALLOC_ACCOUNTING
+
+#endif // WSREP_ALLOC_STATS_HPP
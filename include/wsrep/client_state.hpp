@@ -46,6 +46,7 @@ namespace wsrep
     class client_service;
     class server_state;
     class provider;
+    class toi_batch;
     class condition_variable;
 
     enum client_error
@@ -345,6 +346,25 @@ namespace wsrep
          */
         int append_data(const wsrep::const_buffer& data);
 
+        /**
+         * Append a key into transaction write set without copying
+         * the key part data. The key part data must remain valid and
+         * unchanged until the write set (or the current fragment
+         * in case of streaming replication) has been certified.
+         * Modifications are detected in debug builds.
+         *
+         * @param key Key to be appended
+         *
+         * @return Zero on success, non-zero on failure.
+         */
+        int append_key_nocopy(const wsrep::key& key);
+
+        /**
+         * Append data into transaction write set without copying it.
+         * Same lifetime rules apply as for append_key_nocopy().
+         */
+        int append_data_nocopy(const wsrep::const_buffer& data);
+
         /** @} */
 
         /** @name Streaming replication interface */
@@ -652,6 +672,29 @@ namespace wsrep
             std::chrono::time_point<wsrep::clock>
             wait_until =
             std::chrono::time_point<wsrep::clock>());
+        /**
+         * Enter total order isolation critical section for a batch
+         * of statements. The statements are replicated as a single
+         * TOI write set which is certified with union of the statement
+         * keys. After successful return the caller executes all
+         * statements of the batch and leaves the critical section
+         * with leave_toi_local(const std::vector<wsrep::mutable_buffer>&).
+         *
+         * Fails without replicating anything unless TOI batches
+         * have been enabled with server_state::enable_toi_batching().
+         *
+         * @param batch Batch of statements
+         * @param wait_until Time point to wait until for successful
+         *                   certification.
+         *
+         * @return Zero on success, non-zero otherwise.
+         */
+        int enter_toi_local(
+            const wsrep::toi_batch& batch,
+            std::chrono::time_point<wsrep::clock>
+            wait_until =
+            std::chrono::time_point<wsrep::clock>());
+
         /**
          * Enter applier TOI mode
          *
@@ -686,6 +729,21 @@ namespace wsrep
          */
         int leave_toi_local(const wsrep::mutable_buffer& err);
 
+        /**
+         * Leave total order isolation critical section entered with
+         * a batch of statements.
+         *
+         * @param errors Errors that happened during the execution of
+         *               each statement of the batch, in the order
+         *               the statements were added into the batch
+         *               (empty buffer for no error).
+         *
+         * If the number of errors does not match the number of
+         * statements in the batch, the critical section is left with
+         * a generic error and non-zero is returned.
+         */
+        int leave_toi_local(const std::vector<wsrep::mutable_buffer>& errors);
+
         /**
          * Leave applier TOI mode.
          */
@@ -975,6 +1033,7 @@ namespace wsrep
             , state_hist_()
             , transaction_(*this)
             , toi_meta_()
+            , toi_batch_size_()
             , nbo_meta_()
             , allow_dirty_reads_()
             , sync_wait_gtid_()
@@ -1038,6 +1097,7 @@ namespace wsrep
         std::vector<enum state> state_hist_;
         wsrep::transaction transaction_;
         wsrep::ws_meta toi_meta_;
+        size_t toi_batch_size_;
         wsrep::ws_meta nbo_meta_;
         bool allow_dirty_reads_;
         wsrep::gtid sync_wait_gtid_;
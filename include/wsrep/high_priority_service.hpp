@@ -161,6 +161,27 @@ namespace wsrep
                               const wsrep::const_buffer& ws,
                               wsrep::mutable_buffer& err) = 0;
 
+        /**
+         * Apply a batch of TOI statements replicated with
+         * client_state::enter_toi_local(const wsrep::toi_batch&).
+         *
+         * The default implementation calls apply_toi() for each
+         * statement in order. All statements are applied even if
+         * some of them fail, as is done on the originating node.
+         *
+         * @params ws_meta Write set meta data
+         * @params statements Statement buffers of the batch
+         * @params errors Buffers to store error data for each
+         *                statement, sized to number of statements
+         *
+         * @return Zero if all statements were applied successfully,
+         *         non-zero otherwise.
+         */
+        virtual int apply_toi_batch(
+            const wsrep::ws_meta& ws_meta,
+            const std::vector<wsrep::const_buffer>& statements,
+            std::vector<wsrep::mutable_buffer>& errors);
+
         /**
          * Apply NBO begin event.
          *
@@ -28,6 +28,13 @@
 
 #include <iosfwd>
 #include <cstring> // std::memset()
+#include <sys/types.h> // ssize_t
+
+/**
+ * Minimum number of bytes guaranteed to store id string representation,
+ * terminating '\0' not included.
+ */
+#define WSREP_LIB_ID_C_STR_LEN 36
 
 namespace wsrep
 {
@@ -105,6 +112,24 @@ namespace wsrep
 
     std::ostream& operator<<(std::ostream&, const wsrep::id& id);
     std::istream& operator>>(std::istream&, wsrep::id& id);
+
+    /**
+     * Scan an id from character buffer. The buffer must contain
+     * either a UUID or a string of at most 16 bytes, as with the
+     * string constructor.
+     *
+     * @return Number of bytes scanned or -EINVAL on error.
+     */
+    ssize_t scan_from_c_str(const char* buf, size_t buf_len, wsrep::id& id);
+
+    /**
+     * Print an id into character buffer in the same format as
+     * operator<<. Terminating '\0' is not printed.
+     *
+     * @return Number of characters printed or -ENOBUFS if the buffer
+     *         is too short.
+     */
+    ssize_t print_to_c_str(const wsrep::id& id, char* buf, size_t buf_len);
 }
 
 #endif // WSREP_ID_HPP
@@ -22,8 +22,19 @@
 
 #include "exception.hpp"
 #include "buffer.hpp"
+#include "compiler.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
 #include <iosfwd>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <stdint.h>
 
 namespace wsrep
 {
@@ -46,6 +57,8 @@ namespace wsrep
             : type_(type)
             , key_parts_()
             , key_parts_len_()
+            , hash_()
+            , has_hash_()
         { }
 
         /**
@@ -80,14 +93,431 @@ namespace wsrep
         {
             return key_parts_;
         }
+
+        /**
+         * Assign precomputed hash of the key parts.
+         *
+         * The hash is used to detect duplicate keys within a
+         * transaction. It must be computed over complete key part data
+         * only, not over key type, and the application must use the
+         * same hash function for all keys it appends. If no hash is
+         * assigned, the hash is computed from key parts on demand.
+         *
+         * @param hash Hash of the key parts.
+         */
+        void hash(uint64_t hash)
+        {
+            hash_ = hash;
+            has_hash_ = true;
+        }
+
+        /**
+         * Return true if precomputed hash has been assigned.
+         */
+        bool has_hash() const
+        {
+            return has_hash_;
+        }
+
+        /**
+         * Return hash of the key parts. Returns precomputed hash
+         * if assigned, otherwise the hash is computed from key parts.
+         */
+        uint64_t hash() const
+        {
+            return (has_hash_ ? hash_ : compute_hash());
+        }
     private:
+        uint64_t compute_hash() const;
 
         enum type type_;
         wsrep::const_buffer key_parts_[3];
         size_t key_parts_len_;
+        uint64_t hash_;
+        bool has_hash_;
+    };
+
+    /**
+     * Keys are equal if they have the same type and key part data.
+     * Precomputed hash is not compared.
+     */
+    bool operator==(const wsrep::key& lhs, const wsrep::key& rhs);
+    inline bool operator!=(const wsrep::key& lhs, const wsrep::key& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    /** @class key_array
+     *
+     * Array of certification keys. Up to inline_capacity keys are
+     * stored inside the array object, so that the common case of
+     * TOI operation with a few keys does not allocate memory.
+     * Larger arrays are stored in heap.
+     *
+     * The interface follows std::vector. Inserting or erasing keys
+     * invalidates iterators, and so does moving an array with inline
+     * storage.
+     */
+    class key_array
+    {
+    public:
+        static const size_t inline_capacity = 4;
+
+        typedef wsrep::key value_type;
+        typedef size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef wsrep::key& reference;
+        typedef const wsrep::key& const_reference;
+        typedef wsrep::key* pointer;
+        typedef const wsrep::key* const_pointer;
+        typedef wsrep::key* iterator;
+        typedef const wsrep::key* const_iterator;
+        typedef std::reverse_iterator<iterator> reverse_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        key_array()
+            : data_(inline_data())
+            , size_()
+            , capacity_(inline_capacity)
+            , inline_()
+        { }
+
+        key_array(size_t count, const wsrep::key& key)
+            : key_array()
+        {
+            assign(count, key);
+        }
+
+        template <class InputIt>
+        key_array(InputIt first, InputIt last)
+            : key_array()
+        {
+            assign(first, last);
+        }
+
+        key_array(std::initializer_list<wsrep::key> keys)
+            : key_array()
+        {
+            assign(keys.begin(), keys.end());
+        }
+
+        key_array(const key_array& other)
+            : key_array()
+        {
+            copy_from(other);
+        }
+
+        key_array(key_array&& other) WSREP_NOEXCEPT
+            : key_array()
+        {
+            move_from(other);
+        }
+
+        key_array& operator=(const key_array& other)
+        {
+            if (this != &other)
+            {
+                clear();
+                copy_from(other);
+            }
+            return *this;
+        }
+
+        key_array& operator=(key_array&& other) WSREP_NOEXCEPT
+        {
+            if (this != &other)
+            {
+                if (other.data_ != other.inline_data())
+                {
+                    release();
+                }
+                clear();
+                move_from(other);
+            }
+            return *this;
+        }
+
+        key_array& operator=(std::initializer_list<wsrep::key> keys)
+        {
+            assign(keys.begin(), keys.end());
+            return *this;
+        }
+
+        ~key_array()
+        {
+            release();
+        }
+
+        void assign(size_t count, const wsrep::key& key)
+        {
+            const wsrep::key tmp(key);
+            clear();
+            reserve(count);
+            std::uninitialized_fill_n(data_, count, tmp);
+            size_ = count;
+        }
+
+        template <class InputIt>
+        void assign(InputIt first, InputIt last)
+        {
+            clear();
+            for (; first != last; ++first)
+            {
+                push_back(*first);
+            }
+        }
+
+        void assign(std::initializer_list<wsrep::key> keys)
+        {
+            assign(keys.begin(), keys.end());
+        }
+
+        void push_back(const wsrep::key& key)
+        {
+            if (size_ == capacity_)
+            {
+                // The key may refer to an element of this array.
+                const wsrep::key tmp(key);
+                grow(2 * capacity_);
+                new (data_ + size_) wsrep::key(tmp);
+            }
+            else
+            {
+                new (data_ + size_) wsrep::key(key);
+            }
+            ++size_;
+        }
+
+        template <class... Args>
+        wsrep::key& emplace_back(Args&&... args)
+        {
+            const wsrep::key tmp(std::forward<Args>(args)...);
+            push_back(tmp);
+            return back();
+        }
+
+        void pop_back() { --size_; }
+
+        iterator insert(const_iterator pos, const wsrep::key& key)
+        {
+            return insert(pos, 1, key);
+        }
+
+        iterator insert(const_iterator pos, size_t count,
+                        const wsrep::key& key)
+        {
+            const wsrep::key tmp(key);
+            const size_t index(make_room(pos, count));
+            std::uninitialized_fill_n(data_ + index, count, tmp);
+            return data_ + index;
+        }
+
+        template <class InputIt>
+        iterator insert(const_iterator pos, InputIt first, InputIt last)
+        {
+            // The range may refer to this array or be single pass.
+            const key_array tmp(first, last);
+            const size_t index(make_room(pos, tmp.size()));
+            std::uninitialized_copy(tmp.begin(), tmp.end(), data_ + index);
+            return data_ + index;
+        }
+
+        iterator insert(const_iterator pos,
+                        std::initializer_list<wsrep::key> keys)
+        {
+            return insert(pos, keys.begin(), keys.end());
+        }
+
+        template <class... Args>
+        iterator emplace(const_iterator pos, Args&&... args)
+        {
+            return insert(pos, wsrep::key(std::forward<Args>(args)...));
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            iterator ret(data_ + (first - data_));
+            std::copy(last, const_iterator(end()), ret);
+            size_ -= static_cast<size_t>(last - first);
+            return ret;
+        }
+
+        /** Resize array to count keys, new keys are copies of key. */
+        void resize(size_t count, const wsrep::key& key)
+        {
+            if (count > size_)
+            {
+                insert(end(), count - size_, key);
+            }
+            else
+            {
+                size_ = count;
+            }
+        }
+
+        /** Reserve space for at least capacity keys. */
+        void reserve(size_t capacity)
+        {
+            if (capacity > capacity_)
+            {
+                grow(capacity);
+            }
+        }
+
+        /** Release heap storage if the keys fit in inline storage. */
+        void shrink_to_fit()
+        {
+            if (data_ != inline_data() && size_ <= inline_capacity)
+            {
+                wsrep::key* heap(data_);
+                data_ = inline_data();
+                capacity_ = inline_capacity;
+                std::uninitialized_copy(heap, heap + size_, data_);
+                ::operator delete(heap);
+            }
+        }
+
+        /** Remove all keys. Heap storage, if any, is retained. */
+        void clear() { size_ = 0; }
+
+        void swap(key_array& other) WSREP_NOEXCEPT
+        {
+            key_array tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        size_t size() const { return size_; }
+        size_t max_size() const { return size_t(-1) / sizeof(wsrep::key); }
+        bool empty() const { return size_ == 0; }
+        size_t capacity() const { return capacity_; }
+
+        wsrep::key& operator[](size_t i) { return data_[i]; }
+        const wsrep::key& operator[](size_t i) const { return data_[i]; }
+        wsrep::key& at(size_t i)
+        {
+            if (i >= size_) throw std::out_of_range("key_array::at");
+            return data_[i];
+        }
+        const wsrep::key& at(size_t i) const
+        {
+            if (i >= size_) throw std::out_of_range("key_array::at");
+            return data_[i];
+        }
+        wsrep::key& front() { return data_[0]; }
+        const wsrep::key& front() const { return data_[0]; }
+        wsrep::key& back() { return data_[size_ - 1]; }
+        const wsrep::key& back() const { return data_[size_ - 1]; }
+        wsrep::key* data() { return data_; }
+        const wsrep::key* data() const { return data_; }
+
+        iterator begin() { return data_; }
+        iterator end() { return data_ + size_; }
+        const_iterator begin() const { return data_; }
+        const_iterator end() const { return data_ + size_; }
+        const_iterator cbegin() const { return data_; }
+        const_iterator cend() const { return data_ + size_; }
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+        const_reverse_iterator rbegin() const
+        { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const
+        { return const_reverse_iterator(begin()); }
+        const_reverse_iterator crbegin() const { return rbegin(); }
+        const_reverse_iterator crend() const { return rend(); }
+    private:
+        static_assert(std::is_trivially_destructible<wsrep::key>::value,
+                      "key_array does not run key destructors");
+
+        wsrep::key* inline_data()
+        {
+            return reinterpret_cast<wsrep::key*>(&inline_);
+        }
+        const wsrep::key* inline_data() const
+        {
+            return reinterpret_cast<const wsrep::key*>(&inline_);
+        }
+        void copy_from(const key_array& other)
+        {
+            reserve(other.size_);
+            std::uninitialized_copy(other.begin(), other.end(), data_);
+            size_ = other.size_;
+        }
+        // Take over heap storage of other, or copy the keys if other
+        // uses inline storage. This array must be empty.
+        void move_from(key_array& other) WSREP_NOEXCEPT
+        {
+            if (other.data_ != other.inline_data())
+            {
+                data_ = other.data_;
+                capacity_ = other.capacity_;
+                other.data_ = other.inline_data();
+                other.capacity_ = inline_capacity;
+            }
+            else
+            {
+                std::uninitialized_copy(other.begin(), other.end(), data_);
+            }
+            size_ = other.size_;
+            other.size_ = 0;
+        }
+        // Release heap storage and return to inline storage.
+        void release()
+        {
+            if (data_ != inline_data())
+            {
+                ::operator delete(data_);
+                data_ = inline_data();
+                capacity_ = inline_capacity;
+            }
+            size_ = 0;
+        }
+        // Open a gap of count keys at pos and return its index. The
+        // caller constructs the keys in the gap. Keys are trivially
+        // destructible, so the old keys need not be destroyed.
+        size_t make_room(const_iterator pos, size_t count)
+        {
+            const size_t index(static_cast<size_t>(pos - data_));
+            if (size_ + count > capacity_)
+            {
+                grow(std::max(2 * capacity_, size_ + count));
+            }
+            for (size_t i(size_); i > index; --i)
+            {
+                new (data_ + i - 1 + count) wsrep::key(data_[i - 1]);
+            }
+            size_ += count;
+            return index;
+        }
+        void grow(size_t capacity);
+
+        wsrep::key* data_;
+        size_t size_;
+        size_t capacity_;
+        std::aligned_storage<sizeof(wsrep::key) * inline_capacity,
+                             alignof(wsrep::key)>::type inline_;
     };
 
-    typedef std::vector<wsrep::key> key_array;
+    inline bool operator==(const key_array& lhs, const key_array& rhs)
+    {
+        return (lhs.size() == rhs.size() &&
+                std::equal(lhs.begin(), lhs.end(), rhs.begin()));
+    }
+
+    inline bool operator!=(const key_array& lhs, const key_array& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    inline void swap(key_array& lhs, key_array& rhs) WSREP_NOEXCEPT
+    {
+        lhs.swap(rhs);
+    }
 
     std::ostream& operator<<(std::ostream&, enum wsrep::key::type);
     std::ostream& operator<<(std::ostream&, const wsrep::key&);
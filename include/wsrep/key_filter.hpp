@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file key_filter.hpp
+ *
+ * Per transaction filter for duplicate certification keys.
+ */
+
+#ifndef WSREP_KEY_FILTER_HPP
+#define WSREP_KEY_FILTER_HPP
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+namespace wsrep
+{
+    class key;
+
+    /**
+     * Key filter records keys appended by a transaction into a small
+     * open addressing hash set and detects keys which need not be
+     * appended again: exact duplicates and keys which are subsumed
+     * by a stronger key with the same key parts (for example shared
+     * key after exclusive key).
+     *
+     * The filter copies key part data, so the keys passed to insert()
+     * need not remain valid after the call returns.
+     */
+    class key_filter
+    {
+    public:
+        enum result
+        {
+            /** Key was not seen before. */
+            inserted,
+            /** Key was seen before with weaker type, type was upgraded. */
+            upgraded,
+            /** Key was seen before with the same type. */
+            duplicate,
+            /** Key was seen before with stronger type. */
+            subsumed
+        };
+
+        key_filter()
+            : slots_()
+            , data_()
+            , size_()
+            , duplicates_()
+            , subsumed_()
+        { }
+
+        /**
+         * Record a key.
+         *
+         * @return Result of the operation. If the result is either
+         *         inserted or upgraded, the key must be appended
+         *         into the write set.
+         */
+        enum result insert(const wsrep::key& key);
+
+        /**
+         * Clear all recorded keys. Hit counters are not reset.
+         */
+        void clear();
+
+        /** Return number of recorded keys. */
+        size_t size() const { return size_; }
+
+        /** Return true if no keys have been recorded. */
+        bool empty() const { return size_ == 0; }
+
+        /** Return total number of exact duplicates detected. */
+        size_t duplicate_hits() const { return duplicates_; }
+
+        /** Return total number of subsumed keys detected. */
+        size_t subsumed_hits() const { return subsumed_; }
+
+        /** Return total number of keys filtered out. */
+        size_t hits() const { return duplicates_ + subsumed_; }
+    private:
+        struct slot
+        {
+            uint64_t hash;
+            // Offset of key part data in data_ plus one, zero for
+            // unused slot.
+            size_t offset;
+            size_t len;
+            int type;
+        };
+        bool equal(const slot&, const wsrep::key&) const;
+        void grow();
+
+        std::vector<slot> slots_;
+        std::vector<char> data_;
+        size_t size_;
+        size_t duplicates_;
+        size_t subsumed_;
+    };
+}
+
+#endif // WSREP_KEY_FILTER_HPP
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file owning_key.hpp
+ *
+ * Certification key which owns the key part data.
+ */
+
+#ifndef WSREP_OWNING_KEY_HPP
+#define WSREP_OWNING_KEY_HPP
+
+#include "key.hpp"
+
+#include <vector>
+
+namespace wsrep
+{
+    /**
+     * Simple bump allocator for key part data. Memory is allocated
+     * from fixed size chunks and released all at once in clear()
+     * or in destructor. Allocated memory does not move, so the
+     * arena can be shared by several owning_key objects.
+     */
+    class key_arena
+    {
+    public:
+        /**
+         * @param chunk_size Size of memory chunks allocated from heap.
+         */
+        explicit key_arena(size_t chunk_size = 4096)
+            : chunks_()
+            , chunk_size_(chunk_size)
+            , pos_()
+        { }
+
+        ~key_arena();
+
+        /**
+         * Allocate memory from arena.
+         */
+        char* allocate(size_t size);
+
+        /**
+         * Release all memory allocated from arena. One chunk is
+         * retained for reuse.
+         */
+        void clear();
+    private:
+        key_arena(const key_arena&);
+        key_arena& operator=(const key_arena&);
+
+        std::vector<char*> chunks_;
+        size_t chunk_size_;
+        // Allocation position in the last chunk of chunks_
+        size_t pos_;
+    };
+
+    /**
+     * Certification key which copies key part data into storage
+     * owned by the key object. Key parts up to inline_capacity
+     * bytes in total are stored inside the object, so that keys
+     * can be built from stack temporaries without heap allocations.
+     * Larger key parts are stored in the key_arena passed in
+     * constructor, or in heap if no arena was given.
+     *
+     * The key is appended into the write set via the
+     * wsrep::key returned by key(), for example
+     * client_state.append_key(owning_key.key()).
+     */
+    class owning_key
+    {
+    public:
+        static const size_t inline_capacity = 64;
+
+        /**
+         * @param type Key type
+         * @param arena Optional arena for key parts which do not fit
+         *              into inline storage. The arena must outlive
+         *              the key object and its copies.
+         */
+        owning_key(enum wsrep::key::type type, wsrep::key_arena* arena = 0)
+            : type_(type)
+            , arena_(arena)
+            , parts_()
+            , parts_len_()
+            , inline_()
+            , data_size_()
+            , heap_()
+            , hash_()
+            , has_hash_()
+        { }
+
+        /**
+         * Append key part to key. The data is copied.
+         *
+         * @param ptr Pointer to key part data.
+         * @param len Length of the key part data.
+         */
+        void append_key_part(const void* ptr, size_t len);
+
+        /** Assign precomputed hash, see wsrep::key::hash(uint64_t). */
+        void hash(uint64_t hash)
+        {
+            hash_ = hash;
+            has_hash_ = true;
+        }
+
+        enum wsrep::key::type type() const { return type_; }
+
+        size_t size() const { return parts_len_; }
+
+        /**
+         * Return key which refers to the data owned by this object.
+         * The returned key is valid as long as this object is not
+         * modified or destroyed.
+         */
+        wsrep::key key() const;
+    private:
+        struct part
+        {
+            // Pointer to arena memory or null if the part is stored
+            // at offset in inline or heap storage.
+            const char* ptr;
+            size_t offset;
+            size_t len;
+        };
+        const char* storage() const
+        {
+            return (heap_.empty() ? inline_ : heap_.data());
+        }
+
+        enum wsrep::key::type type_;
+        wsrep::key_arena* arena_;
+        part parts_[3];
+        size_t parts_len_;
+        char inline_[inline_capacity];
+        size_t data_size_;
+        std::vector<char> heap_;
+        uint64_t hash_;
+        bool has_hash_;
+    };
+}
+
+#endif // WSREP_OWNING_KEY_HPP
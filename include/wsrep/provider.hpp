@@ -334,6 +334,32 @@ namespace wsrep
         virtual enum status append_data(
             wsrep::ws_handle&, const wsrep::const_buffer&) = 0;
 
+        /**
+         * Append key into write set without copying the key part
+         * data. The key part data must remain valid and unchanged
+         * until the write set has been certified.
+         *
+         * Default implementation copies the data.
+         */
+        virtual int append_key_nocopy(wsrep::ws_handle& ws_handle,
+                                      const wsrep::key& key)
+        {
+            return append_key(ws_handle, key);
+        }
+
+        /**
+         * Append data into write set without copying it. The data
+         * must remain valid and unchanged until the write set has
+         * been certified.
+         *
+         * Default implementation copies the data.
+         */
+        virtual enum status append_data_nocopy(
+            wsrep::ws_handle& ws_handle, const wsrep::const_buffer& data)
+        {
+            return append_data(ws_handle, data);
+        }
+
         /**
          * Callback for application defined sequential consistency.
          * The provider will call
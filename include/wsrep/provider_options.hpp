@@ -27,10 +27,14 @@
 
 #include "provider.hpp"
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace wsrep
 {
@@ -60,6 +64,11 @@ namespace wsrep
             virtual ~option_value() {}
             virtual const char* as_string() const = 0;
             virtual const void* get_ptr() const = 0;
+            /**
+             * Return the type flag of the value, zero for string
+             * values. This determines the type get_ptr() points to.
+             */
+            virtual int type() const { return 0; }
         };
 
         class option_value_string : public option_value
@@ -103,6 +112,7 @@ namespace wsrep
                 }
             }
             const void* get_ptr() const WSREP_OVERRIDE { return &value_; }
+            int type() const WSREP_OVERRIDE { return flag::type_bool; }
 
         private:
             bool value_;
@@ -122,6 +132,7 @@ namespace wsrep
                 return value_str_.c_str();
             }
             const void* get_ptr() const WSREP_OVERRIDE { return &value_; }
+            int type() const WSREP_OVERRIDE { return flag::type_integer; }
 
         private:
             int64_t value_;
@@ -142,12 +153,48 @@ namespace wsrep
                 return value_str_.c_str();
             }
             const void* get_ptr() const WSREP_OVERRIDE { return &value_; }
+            int type() const WSREP_OVERRIDE { return flag::type_double; }
 
         private:
             double value_;
             std::string value_str_;
         };
 
+        /**
+         * Handle to the current value of a typed option. Handles are
+         * resolved once with get_handle() and read without a lookup.
+         * The value is updated when set() succeeds, and may be read
+         * concurrently with set().
+         *
+         * Type T is bool, int64_t or double, corresponding to
+         * flag::type_bool, flag::type_integer and flag::type_double.
+         *
+         * Handles resolved before initial_options() keep the values
+         * of the old options and must be resolved again.
+         */
+        template <typename T>
+        class option_handle
+        {
+        public:
+            option_handle() : value_() { }
+
+            /** Return true if the handle has been resolved. */
+            bool valid() const { return bool(value_); }
+
+            /**
+             * Return the current value of the option. The handle must
+             * be valid.
+             */
+            T get() const { return value_->load(std::memory_order_relaxed); }
+        private:
+            friend class provider_options;
+            explicit option_handle(
+                const std::shared_ptr<const std::atomic<T>>& value)
+                : value_(value)
+            { }
+            std::shared_ptr<const std::atomic<T>> value_;
+        };
+
         class option
         {
         public:
@@ -205,6 +252,18 @@ namespace wsrep
             void update_value(std::unique_ptr<option_value> new_value);
 
         private:
+            friend class provider_options;
+            /** Current value of a typed option. */
+            struct typed_value
+            {
+                typed_value() : as_bool(), as_integer(), as_double() { }
+                std::atomic<bool> as_bool;
+                std::atomic<int64_t> as_integer;
+                std::atomic<double> as_double;
+            };
+            /** Store value_ into typed_value_ according to flags. */
+            void update_typed_value();
+
             /** Sanitized name with dots replaced with underscores */
             std::string name_;
             /** Real name in provider */
@@ -212,8 +271,16 @@ namespace wsrep
             std::unique_ptr<option_value> value_;
             std::unique_ptr<option_value> default_value_;
             int flags_;
+            /** Shared with the handles, so that they remain valid
+             * if the option is destroyed. */
+            std::shared_ptr<typed_value> typed_value_;
         };
 
+        /** Option names and values for batched set(). */
+        typedef std::vector<std::pair<std::string,
+                                      std::unique_ptr<option_value>>>
+        option_values;
+
         provider_options(wsrep::provider&);
         provider_options(const provider_options&) = delete;
         provider_options& operator=(const provider_options&) = delete;
@@ -244,6 +311,41 @@ namespace wsrep
         enum wsrep::provider::status set(const std::string& name,
                                          std::unique_ptr<option_value> value);
 
+        /**
+         * Set values for several options with a single call to
+         * provider options(). If any of the options is not found,
+         * no values are set.
+         *
+         * If the provider fails, the stored values are not updated.
+         * Note that the provider may have applied some of the values
+         * before the failure.
+         *
+         * @return Wsrep provider status code.
+         */
+        enum wsrep::provider::status set(option_values values);
+
+        /**
+         * Resolve handle to a typed option.
+         *
+         * @param name Name of the option
+         * @param[out] handle Handle to be resolved
+         *
+         * @return wsrep::provider::success on success,
+         *         wsrep::provider::error_warning if the option is not
+         *         found,
+         *         wsrep::provider::error_not_allowed if the option
+         *         type does not match the handle type.
+         */
+        enum wsrep::provider::status
+        get_handle(const std::string& name,
+                   option_handle<bool>& handle) const;
+        enum wsrep::provider::status
+        get_handle(const std::string& name,
+                   option_handle<int64_t>& handle) const;
+        enum wsrep::provider::status
+        get_handle(const std::string& name,
+                   option_handle<double>& handle) const;
+
         /**
          * Create a new option with default value.
          */
@@ -21,6 +21,13 @@
 #define WSREP_SEQNO_HPP
 
 #include <iosfwd>
+#include <sys/types.h> // ssize_t
+
+/**
+ * Minimum number of bytes guaranteed to store seqno string
+ * representation, terminating '\0' not included.
+ */
+#define WSREP_LIB_SEQNO_C_STR_LEN 20
 
 namespace wsrep
 {
@@ -99,6 +106,29 @@ namespace wsrep
     };
 
     std::ostream& operator<<(std::ostream& os, wsrep::seqno seqno);
+
+    /**
+     * Scan a seqno in decimal format from character buffer. The
+     * scanning stops at the first character which is not a digit.
+     *
+     * @param buf Buffer containing the string
+     * @param buf_len Length of buffer
+     * @param[out] seqno Seqno to be scanned to
+     *
+     * @return Number of bytes scanned, -EINVAL if the buffer does
+     *         not begin with a number or the number is out of range.
+     */
+    ssize_t scan_from_c_str(const char* buf, size_t buf_len,
+                            wsrep::seqno& seqno);
+
+    /**
+     * Print a seqno into character buffer. Terminating '\0' is not
+     * printed.
+     *
+     * @return Number of characters printed or -ENOBUFS if the buffer
+     *         is too short.
+     */
+    ssize_t print_to_c_str(wsrep::seqno seqno, char* buf, size_t buf_len);
 }
 
 #endif // WSREP_SEQNO_HPP
@@ -91,6 +91,7 @@
 #include "provider.hpp"
 #include "compiler.hpp"
 #include "xid.hpp"
+#include "atomic.hpp"
 
 #include <memory>
 #include <deque>
@@ -117,6 +118,7 @@ namespace wsrep
     class server_service;
     class client_service;
     class encryption_service;
+    class ws_capture;
 
     /** @class Server Context
      *
@@ -312,6 +314,33 @@ namespace wsrep
         /** Unload/unset provider. */
         void unload_provider();
 
+        /**
+         * Set write set capture. Write sets delivered to on_apply()
+         * are recorded into the capture before they are applied.
+         *
+         * @param capture Capture to record into, null pointer disables
+         *        capturing. The capture must remain valid until
+         *        appliers have stopped.
+         */
+        void set_ws_capture(wsrep::ws_capture* capture)
+        { ws_capture_ = capture; }
+
+        /**
+         * Enable or disable TOI batches, see wsrep::toi_batch.
+         *
+         * Nodes which do not support batches apply a batch write set
+         * as a single TOI operation, so batching must be enabled only
+         * after all nodes in the cluster support it. While enabled,
+         * TOI write set buffers which begin with the batch header are
+         * applied as batches. Disabled by default.
+         */
+        void enable_toi_batching(bool enable) { toi_batching_ = enable; }
+
+        /**
+         * Return true if TOI batches are enabled.
+         */
+        bool toi_batching() const { return toi_batching_; }
+
         bool is_provider_loaded() const { return provider_ != 0; }
 
         /**
@@ -390,9 +419,23 @@ namespace wsrep
 
         /**
          *  Return current view
+         *
+         *  The reference is not safe to use concurrently with view
+         *  changes, threads other than the one delivering views
+         *  should use view_snapshot() instead.
          */
         const wsrep::view& current_view() const { return current_view_; }
 
+        /**
+         * Return snapshot of the current view. The snapshot is
+         * immutable and remains valid after the view changes.
+         *
+         * This does not lock the server mutex or copy the view.
+         * The snapshot pointer is copied under a short spin lock
+         * which is contended only during view changes.
+         */
+        std::shared_ptr<const wsrep::view> view_snapshot() const;
+
         /**
          * Wait until all the write sets up to given GTID have been
          * committed.
@@ -567,10 +610,14 @@ namespace wsrep
                      const wsrep::ws_meta& ws_meta,
                      const wsrep::const_buffer& data);
 
+        /**
+         * Return current state. This does not lock the server mutex,
+         * the state is read from an atomic copy which is updated
+         * with the state under the lock.
+         */
         enum state state() const
         {
-            wsrep::unique_lock<wsrep::mutex> lock(mutex_);
-            return state(lock);
+            return atomic_state_.load(std::memory_order_acquire);
         }
 
         enum state state(wsrep::unique_lock<wsrep::mutex>& lock) const;
@@ -623,6 +670,7 @@ namespace wsrep
             , server_service_(server_service)
             , encryption_service_(encryption_service)
             , state_(s_disconnected)
+            , atomic_state_(s_disconnected)
             , state_hist_()
             , state_waiters_(n_states_)
             , bootstrap_()
@@ -650,7 +698,11 @@ namespace wsrep
             , connected_gtid_()
             , previous_primary_view_()
             , current_view_()
+            , view_snapshot_(std::make_shared<const wsrep::view>())
+            , view_snapshot_lock_(false)
             , rollback_event_queue_()
+            , ws_capture_(nullptr)
+            , toi_batching_(false)
         { }
 
     private:
@@ -694,11 +746,17 @@ namespace wsrep
         // Handle returning from donor state.
         void return_from_donor_state(wsrep::unique_lock<wsrep::mutex>& lock);
 
+        // Assign current view, store the previous view if it was
+        // primary and publish view snapshot.
+        void set_current_view(const wsrep::view&);
+
         wsrep::mutex& mutex_;
         wsrep::condition_variable& cond_;
         wsrep::server_service& server_service_;
         wsrep::encryption_service* encryption_service_;
         enum state state_;
+        // Copy of state_ for readers which do not hold the mutex.
+        std::atomic<enum state> atomic_state_;
         std::vector<enum state> state_hist_;
         mutable std::vector<int> state_waiters_;
         bool bootstrap_;
@@ -732,7 +790,15 @@ namespace wsrep
         wsrep::gtid connected_gtid_;
         wsrep::view previous_primary_view_;
         wsrep::view current_view_;
+        // Published copy of current_view_. The pointer is swapped and
+        // copied under view_snapshot_lock_, a spin lock which is held
+        // only for the duration of the reference count update. Waiters
+        // yield the CPU, see lock_view_snapshot().
+        std::shared_ptr<const wsrep::view> view_snapshot_;
+        mutable std::atomic<bool> view_snapshot_lock_;
         std::deque<wsrep::transaction_id> rollback_event_queue_;
+        std::atomic<wsrep::ws_capture*> ws_capture_;
+        std::atomic<bool> toi_batching_;
     };
 
     static inline const char* to_c_string(
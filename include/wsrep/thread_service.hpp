@@ -31,7 +31,9 @@
 #ifndef WSREP_THREAD_SERVICE_HPP
 #define WSREP_THREAD_SERVICE_HPP
 
+#include <cerrno> // ENOTSUP
 #include <cstddef> // size_t
+#include <vector>
 #include "compiler.hpp"
 
 struct timespec;
@@ -87,6 +89,50 @@ namespace wsrep
         virtual int getschedparam(thread*, int*, struct sched_param*) WSREP_NOEXCEPT
             = 0;
 
+        /* CPU placement */
+
+        /**
+         * Placement hint for threads. The threads are allowed to run
+         * on the listed CPUs, empty list allows all CPUs. If
+         * numa_node is non-negative, the threads are further
+         * restricted to the CPUs of the NUMA node.
+         */
+        struct placement
+        {
+            placement() : cpus(), numa_node(-1) { }
+            std::vector<int> cpus;
+            int numa_node;
+        };
+
+        /**
+         * Set placement hint for threads whose key name begins with
+         * name. The longest matching name is used. The hint is
+         * applied to the threads created with create_thread() after
+         * the call and to the threads calling apply_placement().
+         *
+         * Implementing placement is optional.
+         *
+         * @return Zero on success, EINVAL if the placement is invalid,
+         *         ENOTSUP if placement is not supported.
+         */
+        virtual int set_placement(const char*, const placement&)
+        {
+            return ENOTSUP;
+        }
+
+        /**
+         * Apply placement hint matching name to the calling thread.
+         * This is meant for application threads which are not
+         * created through the thread service.
+         *
+         * @return Zero on success or if no hint matches name, error
+         *         code otherwise.
+         */
+        virtual int apply_placement(const char*) WSREP_NOEXCEPT
+        {
+            return ENOTSUP;
+        }
+
         /* Mutex */
         virtual const mutex_key* create_mutex_key(const char* name) WSREP_NOEXCEPT
             = 0;
@@ -30,6 +30,7 @@
 #include "compiler.hpp"
 
 #include <sys/types.h> // ssize_t
+#include <sys/uio.h>   // struct iovec
 
 namespace wsrep
 {
@@ -97,6 +98,34 @@ namespace wsrep
         virtual op_result write(tls_stream*,
                                 const void* buf, size_t count) WSREP_NOEXCEPT = 0;
 
+        /**
+         * Read at most the total length of iovcnt buffers in iov,
+         * filling the buffers in order.
+         *
+         * The default implementation calls read() for the first
+         * non-empty buffer only, so that it never blocks waiting for
+         * more data than is available. Implementations which can
+         * scatter the data should override this.
+         */
+        virtual op_result readv(tls_stream*,
+                                const struct iovec* iov,
+                                int iovcnt) WSREP_NOEXCEPT;
+
+        /**
+         * Write at most the total length of iovcnt buffers in iov,
+         * in order.
+         *
+         * The default implementation calls write() for each buffer
+         * and stops at the first short write or at a status other
+         * than success. The returned status is the status of the
+         * last write() call and bytes_transferred is the total over
+         * all calls. Implementations which can gather the data
+         * should override this.
+         */
+        virtual op_result writev(tls_stream*,
+                                 const struct iovec* iov,
+                                 int iovcnt) WSREP_NOEXCEPT;
+
         /**
          * Shutdown TLS stream.
          */
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file toi_batch.hpp
+ *
+ * Batch of independent TOI statements replicated as a single
+ * TOI write set.
+ */
+
+#ifndef WSREP_TOI_BATCH_HPP
+#define WSREP_TOI_BATCH_HPP
+
+#include "key.hpp"
+#include "key_filter.hpp"
+#include "buffer.hpp"
+
+#include <vector>
+
+namespace wsrep
+{
+    /**
+     * TOI batch collects several independent statements into one
+     * TOI write set, so that the statements are ordered with a single
+     * total order operation. The keys of the write set are the union
+     * of the keys of all statements, and the write set buffer contains
+     * the statement buffers in the order they were added.
+     *
+     * On the local node the batch is executed between
+     * client_state::enter_toi_local(const toi_batch&) and
+     * client_state::leave_toi_local(const std::vector<mutable_buffer>&).
+     * Appliers recognize the batch and apply each statement separately
+     * via high_priority_service::apply_toi_batch().
+     *
+     * Batches are used only if enabled with
+     * server_state::enable_toi_batching(). Nodes without batch support
+     * would apply the batch as a single TOI operation, so batching
+     * must be enabled only once all nodes of the cluster support it.
+     *
+     * Statement errors are reported per statement. The error buffer
+     * passed to the provider for voting is empty if all statements
+     * succeeded, otherwise it is encoded by encode_errors().
+     */
+    class toi_batch
+    {
+    public:
+        toi_batch()
+            : keys_()
+            , key_filter_()
+            , data_()
+            , size_()
+        {
+            clear();
+        }
+
+        /**
+         * Add a statement into batch.
+         *
+         * The statement buffer is copied. The key part data is not
+         * copied and must remain valid until the batch has been passed
+         * to client_state::enter_toi_local().
+         *
+         * @param keys Keys of the statement.
+         * @param statement Buffer containing the statement.
+         */
+        void add(const wsrep::key_array& keys,
+                 const wsrep::const_buffer& statement);
+
+        /** Remove all statements from the batch. */
+        void clear();
+
+        /** Return number of statements in the batch. */
+        size_t size() const { return size_; }
+
+        bool empty() const { return size_ == 0; }
+
+        /** Return union of the statement keys. */
+        const wsrep::key_array& keys() const { return keys_; }
+
+        /** Return the write set buffer for the batch. */
+        wsrep::const_buffer data() const
+        {
+            return wsrep::const_buffer(data_.data(), data_.size());
+        }
+
+        /**
+         * Return true if the TOI write set buffer contains
+         * a batch.
+         */
+        static bool is_batch(const wsrep::const_buffer& data);
+
+        /**
+         * Split a batch write set buffer into statements. The returned
+         * buffers point to the data buffer.
+         *
+         * @return Zero on success, non-zero if the buffer is not
+         *         a valid batch.
+         */
+        static int parse(const wsrep::const_buffer& data,
+                         std::vector<wsrep::const_buffer>& statements);
+
+        /**
+         * Encode per statement errors into a single error buffer.
+         * The resulting buffer is empty if all errors are empty.
+         */
+        static void encode_errors(
+            const std::vector<wsrep::mutable_buffer>& errors,
+            wsrep::mutable_buffer& err);
+
+        /**
+         * Decode error buffer produced by encode_errors().
+         *
+         * @param err Encoded error buffer.
+         * @param errors Vector of per statement errors, resized to
+         *               the number of statements.
+         * @param statements Number of statements in the batch.
+         *
+         * @return Zero on success, non-zero if the buffer is malformed.
+         */
+        static int decode_errors(const wsrep::const_buffer& err,
+                                 std::vector<wsrep::mutable_buffer>& errors,
+                                 size_t statements);
+    private:
+        toi_batch(const toi_batch&);
+        toi_batch& operator=(const toi_batch&);
+
+        void add_key(const wsrep::key& key);
+
+        wsrep::key_array keys_;
+        wsrep::key_filter key_filter_;
+        std::vector<char> data_;
+        size_t size_;
+    };
+}
+
+#endif // WSREP_TOI_BATCH_HPP
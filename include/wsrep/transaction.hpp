@@ -26,11 +26,13 @@
 #include "streaming_context.hpp"
 #include "lock.hpp"
 #include "sr_key_set.hpp"
+#include "key_filter.hpp"
 #include "buffer.hpp"
 #include "xid.hpp"
 
 #include <iosfwd>
 #include <vector>
+#include <utility>
 
 namespace wsrep
 {
@@ -122,6 +124,16 @@ namespace wsrep
             return sr_keys_.empty();
         }
 
+        /**
+         * Return key filter which is used to drop duplicate keys
+         * appended by the transaction. Hit counters of the filter
+         * accumulate over the lifetime of the client.
+         */
+        const wsrep::key_filter& key_filter() const
+        {
+            return key_filter_;
+        }
+
         bool is_xa() const
         {
             return !xid_.is_null();
@@ -173,6 +185,18 @@ namespace wsrep
 
         int append_data(const wsrep::const_buffer&);
 
+        /**
+         * Append key without copying key part data, see
+         * wsrep::client_state::append_key_nocopy().
+         */
+        int append_key_nocopy(const wsrep::key&);
+
+        /**
+         * Append data without copying it, see
+         * wsrep::client_state::append_data_nocopy().
+         */
+        int append_data_nocopy(const wsrep::const_buffer&);
+
         int after_row();
 
         int before_prepare(wsrep::unique_lock<wsrep::mutex>&,
@@ -262,6 +286,10 @@ namespace wsrep
         void xa_replay_common(wsrep::unique_lock<wsrep::mutex>&);
         int xa_replay_commit(wsrep::unique_lock<wsrep::mutex>&);
         void cleanup();
+        int do_append_key(const wsrep::key&, bool copy);
+        void borrow(const wsrep::const_buffer&);
+        void check_borrowed() const;
+        void release_borrowed();
         void debug_log_state(const char*) const;
         void debug_log_key_append(const wsrep::key& key) const;
 
@@ -284,6 +312,12 @@ namespace wsrep
         size_t fragments_certified_for_statement_;
         wsrep::streaming_context streaming_context_;
         wsrep::sr_key_set sr_keys_;
+        wsrep::key_filter key_filter_;
+        // Buffers appended without copying. Populated only in debug
+        // builds, where the copy of the contents is used to detect
+        // modifications before the write set is certified.
+        std::vector<std::pair<wsrep::const_buffer, std::vector<char> > >
+        borrowed_;
         wsrep::mutable_buffer apply_error_buf_;
         wsrep::xid xid_;
         bool streaming_rollback_in_progress_;
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** @file ws_capture.hpp
+ *
+ * Capture of delivered write sets into a binary file for offline
+ * apply benchmarking.
+ *
+ * The file starts with eight byte magic "WSREPCAP" followed by
+ * 32 bit format version. Each record consists of
+ *
+ * - 32 bit size of the rest of the record
+ * - 64 bit capture time in nanoseconds since the capture was opened
+ * - 64 bit transaction id from ws_handle
+ * - 16 byte group id and 64 bit seqno
+ * - 16 byte server id, 64 bit transaction id and 64 bit client id
+ * - 64 bit depends_on seqno
+ * - 32 bit flags
+ * - write set data
+ *
+ * Integers are stored in little endian byte order. The opaque
+ * pointer of ws_handle is not stored.
+ */
+
+#ifndef WSREP_WS_CAPTURE_HPP
+#define WSREP_WS_CAPTURE_HPP
+
+#include "buffer.hpp"
+#include "mutex.hpp"
+#include "provider.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace wsrep
+{
+    /**
+     * Write set capture file writer. Records are written from
+     * concurrent applier threads in the order of the calls to
+     * record(), which may differ from the seqno order.
+     */
+    class ws_capture
+    {
+    public:
+        /**
+         * Open capture file for writing. Existing file is truncated.
+         *
+         * @throw wsrep::runtime_error if the file cannot be opened.
+         */
+        ws_capture(const std::string& path);
+        ~ws_capture();
+
+        /**
+         * Record a write set.
+         *
+         * @return Zero on success, non-zero on write failure.
+         */
+        int record(const wsrep::ws_handle& ws_handle,
+                   const wsrep::ws_meta& ws_meta,
+                   const wsrep::const_buffer& data);
+
+        /**
+         * Flush buffered records into the file.
+         *
+         * @return Zero on success, non-zero on failure.
+         */
+        int flush();
+
+        /**
+         * Return the number of records written.
+         */
+        size_t records() const;
+    private:
+        ws_capture(const ws_capture&);
+        ws_capture& operator=(const ws_capture&);
+
+        mutable wsrep::default_mutex mutex_;
+        FILE* file_;
+        std::chrono::steady_clock::time_point start_;
+        size_t records_;
+    };
+
+    /**
+     * Reader for files written by ws_capture.
+     */
+    class ws_capture_reader
+    {
+    public:
+        struct record
+        {
+            record()
+                : timestamp()
+                , ws_handle()
+                , ws_meta()
+                , data()
+            { }
+            /** Capture time relative to the start of the capture. */
+            std::chrono::nanoseconds timestamp;
+            wsrep::ws_handle ws_handle;
+            wsrep::ws_meta ws_meta;
+            std::vector<char> data;
+        };
+
+        /**
+         * Open capture file for reading and verify the file header.
+         *
+         * @throw wsrep::runtime_error if the file cannot be opened
+         *        or it is not a capture file.
+         */
+        ws_capture_reader(const std::string& path);
+        ~ws_capture_reader();
+
+        /**
+         * Read the next record.
+         *
+         * @return One if a record was read, zero at the end of file,
+         *         negative on truncated or corrupted record.
+         */
+        int read(record&);
+    private:
+        ws_capture_reader(const ws_capture_reader&);
+        ws_capture_reader& operator=(const ws_capture_reader&);
+
+        FILE* file_;
+        std::vector<unsigned char> buf_;
+    };
+}
+
+#endif // WSREP_WS_CAPTURE_HPP
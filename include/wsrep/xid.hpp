@@ -21,14 +21,31 @@
 #define WSREP_XID_HPP
 
 #include <iosfwd>
-#include "buffer.hpp"
+#include <cstring> // std::memcpy()
+#include <functional> // std::hash
+#include <string>
+#include <sys/types.h> // ssize_t
 #include "exception.hpp"
 
+/**
+ * Minimum number of bytes guaranteed to store xid string
+ * representation, terminating '\0' not included.
+ */
+#define WSREP_LIB_XID_C_STR_LEN 128
+
 namespace wsrep
 {
+    /**
+     * XA transaction identifier. The gtrid and bqual data are stored
+     * inline, so constructing, copying and comparing xids does not
+     * allocate.
+     */
     class xid
     {
     public:
+        /** Maximum length of gtrid and bqual each. */
+        static const long max_part_len = 64;
+
         xid()
             : format_id_(-1)
             , gtrid_len_(0)
@@ -43,24 +60,17 @@ namespace wsrep
             , bqual_len_(bqual_len)
             , data_()
         {
-            if (gtrid_len_ > 64 || bqual_len_ > 64)
+            if (gtrid_len_ > max_part_len || bqual_len_ > max_part_len)
             {
                 throw wsrep::runtime_error("maximum wsrep::xid size exceeded");
             }
-            const long len = gtrid_len_ + bqual_len_;
-            if (len > 0)
+            const size_t len(data_size());
+            if (len > 0 && data != nullptr)
             {
-                data_.push_back(data, data + len);
+                std::memcpy(data_, data, len);
             }
         }
 
-        xid(const xid& xid)
-            : format_id_(xid.format_id_)
-            , gtrid_len_(xid.gtrid_len_)
-            , bqual_len_(xid.bqual_len_)
-            , data_(xid.data_)
-        { }
-
         bool is_null() const
         {
             return format_id_ == -1;
@@ -71,41 +81,66 @@ namespace wsrep
             format_id_ = -1;
             gtrid_len_ = 0;
             bqual_len_ = 0;
-            data_.clear();
         }
 
-        xid& operator= (const xid& other)
+        bool operator==(const xid& other) const
         {
-            format_id_ = other.format_id_;
-            gtrid_len_ = other.gtrid_len_;
-            bqual_len_ = other.bqual_len_;
-            data_ = other.data_;
-            return *this;
+            return (format_id_ == other.format_id_ &&
+                    gtrid_len_ == other.gtrid_len_ &&
+                    bqual_len_ == other.bqual_len_ &&
+                    std::memcmp(data_, other.data_, data_size()) == 0);
         }
 
-        bool operator==(const xid& other) const
+        bool operator!=(const xid& other) const
         {
-            if (format_id_ != other.format_id_ ||
-                gtrid_len_ != other.gtrid_len_ ||
-                bqual_len_ != other.bqual_len_ ||
-                data_.size() != other.data_.size())
-            {
-                return false;
-            }
-            return data_ == other.data_;
+            return !(*this == other);
         }
 
+        /**
+         * Return hash of the xid. Equal xids have equal hashes. The
+         * value depends on the platform and should not be stored.
+         */
+        size_t hash() const;
+
         friend std::string to_string(const wsrep::xid& xid);
+        friend ssize_t print_to_c_str(const wsrep::xid& xid, char* buf,
+                                      size_t buf_len);
         friend std::ostream& operator<<(std::ostream& os, const wsrep::xid& xid);
     protected:
+        // Length of gtrid and bqual data. Only this many bytes of
+        // data_ are meaningful.
+        size_t data_size() const
+        {
+            const long len(gtrid_len_ + bqual_len_);
+            return (len > 0 ? static_cast<size_t>(len) : 0);
+        }
+
         long format_id_;
         long gtrid_len_;
         long bqual_len_;
-        mutable_buffer data_;
+        char data_[2 * max_part_len];
     };
 
     std::string to_string(const wsrep::xid& xid);
+
+    /**
+     * Print xid data into character buffer, as to_string().
+     * Terminating '\0' is not printed.
+     *
+     * @return Number of characters printed or -ENOBUFS if the buffer
+     *         is too short.
+     */
+    ssize_t print_to_c_str(const wsrep::xid& xid, char* buf, size_t buf_len);
+
     std::ostream& operator<<(std::ostream& os, const wsrep::xid& xid);
 }
 
+namespace std
+{
+    template <> struct hash<wsrep::xid>
+    {
+        size_t operator()(const wsrep::xid& xid) const { return xid.hash(); }
+    };
+}
+
 #endif // WSREP_XID_HPP
@@ -0,0 +1,63 @@
+#!/bin/bash -eu
+#
+# Copyright (C) 2025 Codership Oy <info@codership.com>
+#
+# This program is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 2
+# of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301,
+# USA.
+#
+
+#
+# Compare write set data append with and without copying for
+# large write sets. Prints data size, append mode, transactions
+# per second and maximum resident set size for each run.
+#
+# The copy avoided by appending without copying happens in the
+# provider, so this needs a real provider library. The append_*
+# cases of wsrep-lib_bench show the difference without one.
+#
+
+WSREP_PROVIDER=${WSREP_PROVIDER:?"Provider library is required"}
+DBSIM=${DBSIM:-./dbsim/dbsim}
+
+total_transactions=$((1 << 14))
+servers=1
+clients=8
+
+function run_benchmark()
+{
+    data_size=$1
+    nocopy=$2
+    result_file=dbsim-nocopy-$data_size-$nocopy
+    rm -r dbsim_*_data/ || :
+    command time -v $DBSIM \
+            --servers=$servers \
+            --clients=$clients \
+            --transactions=$(($total_transactions/($servers*$clients))) \
+            --max-data-size=$data_size \
+            --append-nocopy=$nocopy \
+            --wsrep-provider="$WSREP_PROVIDER" \
+            --fast-exit=1 >& $result_file
+    trx_per_sec=$(grep -a "Transactions per second" "$result_file" | cut -d ':' -f 2)
+    max_rss=$(grep -a "Maximum resident set size" "$result_file" | cut -d ':' -f 2)
+    echo "$data_size $nocopy $trx_per_sec $max_rss"
+}
+
+for data_size in 1024 $((1 << 16)) $((1 << 20)) $((1 << 22))
+do
+    for nocopy in 0 1
+    do
+        run_benchmark $data_size $nocopy
+    done
+done
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/alloc_stats.hpp"
+
+thread_local enum wsrep::alloc_stats::phase
+wsrep::alloc_stats::current_(wsrep::alloc_stats::p_none);
+
+thread_local wsrep::alloc_stats::counters
+wsrep::alloc_stats::counters_[wsrep::alloc_stats::phases];
+
+bool wsrep::alloc_stats::enabled()
+{
+#ifdef WSREP_LIB_ALLOC_ACCOUNTING
+    return true;
+#else
+    return false;
+#endif // WSREP_LIB_ALLOC_ACCOUNTING
+}
+
+wsrep::alloc_stats::counters wsrep::alloc_stats::total()
+{
+    counters ret = { 0, 0 };
+    for (int i(p_none + 1); i < phases; ++i)
+    {
+        ret.allocations += counters_[i].allocations;
+        ret.bytes += counters_[i].bytes;
+    }
+    return ret;
+}
+
+void wsrep::alloc_stats::reset()
+{
+    for (int i(0); i < phases; ++i)
+    {
+        counters_[i].allocations = 0;
+        counters_[i].bytes = 0;
+    }
+}
@@ -23,6 +23,7 @@
 #include "wsrep/server_state.hpp"
 #include "wsrep/server_service.hpp"
 #include "wsrep/client_service.hpp"
+#include "wsrep/toi_batch.hpp"
 
 #include <unistd.h> // usleep()
 #include <cassert>
@@ -326,6 +327,20 @@ int wsrep::client_state::append_data(const wsrep::const_buffer& data)
     return transaction_.append_data(data);
 }
 
+int wsrep::client_state::append_key_nocopy(const wsrep::key& key)
+{
+    assert(mode_ == m_local);
+    assert(state_ == s_exec);
+    return transaction_.append_key_nocopy(key);
+}
+
+int wsrep::client_state::append_data_nocopy(const wsrep::const_buffer& data)
+{
+    assert(mode_ == m_local);
+    assert(state_ == s_exec);
+    return transaction_.append_data_nocopy(data);
+}
+
 int wsrep::client_state::after_row()
 {
     assert(mode_ == m_local);
@@ -663,6 +678,28 @@ int wsrep::client_state::enter_toi_local(const wsrep::key_array& keys,
     return ret;
 }
 
+int wsrep::client_state::enter_toi_local(
+    const wsrep::toi_batch& batch,
+    std::chrono::time_point<wsrep::clock> wait_until)
+{
+    WSREP_LOG_DEBUG(debug_log_level(),
+                    wsrep::log::debug_level_client_state,
+                    "enter_toi_local: batch of " << batch.size()
+                    << " statements, " << batch.keys().size() << " keys");
+    if (not server_state_.toi_batching())
+    {
+        wsrep::log_error()
+            << "TOI batch replication is not enabled";
+        return 1;
+    }
+    int const ret(enter_toi_local(batch.keys(), batch.data(), wait_until));
+    if (ret == 0)
+    {
+        toi_batch_size_ = batch.size();
+    }
+    return ret;
+}
+
 void wsrep::client_state::enter_toi_mode(const wsrep::ws_meta& ws_meta)
 {
     debug_log_state("enter_toi_mode: enter");
@@ -683,6 +720,7 @@ void wsrep::client_state::leave_toi_common()
         update_last_written_gtid(toi_meta_.gtid());
     }
     toi_meta_ = wsrep::ws_meta();
+    toi_batch_size_ = 0;
 }
 
 int wsrep::client_state::leave_toi_local(const wsrep::mutable_buffer& err)
@@ -697,6 +735,28 @@ int wsrep::client_state::leave_toi_local(const wsrep::mutable_buffer& err)
     return ret;
 }
 
+int wsrep::client_state::leave_toi_local(
+    const std::vector<wsrep::mutable_buffer>& errors)
+{
+    wsrep::mutable_buffer err;
+    if (errors.size() != toi_batch_size_)
+    {
+        // Leave the critical section anyway, otherwise all subsequent
+        // TOI operations in the cluster would block. The batch is voted
+        // as failed on this node.
+        std::ostringstream os;
+        os << "TOI batch error count " << errors.size()
+           << " does not match batch size " << toi_batch_size_;
+        wsrep::log_error() << os.str();
+        const std::string msg(os.str());
+        err.push_back(msg.data(), msg.data() + msg.size());
+        leave_toi_local(err);
+        return 1;
+    }
+    wsrep::toi_batch::encode_errors(errors, err);
+    return leave_toi_local(err);
+}
+
 void wsrep::client_state::leave_toi_mode()
 {
     debug_log_state("leave_toi_mode: enter");
@@ -19,15 +19,18 @@
 
 #include "wsrep/gtid.hpp"
 
+#include <cctype>
 #include <cerrno>
+#include <cstring>
 #include <iostream>
-#include <sstream>
 
 const wsrep::gtid wsrep::gtid::undefined_ = wsrep::gtid();
 
 std::ostream& wsrep::operator<<(std::ostream& os, const wsrep::gtid& gtid)
 {
-    return (os << gtid.id() << ":" << gtid.seqno());
+    char buf[WSREP_LIB_GTID_C_STR_LEN + 1];
+    buf[print_to_c_str(gtid, buf, sizeof(buf) - 1)] = '\0';
+    return (os << buf);
 }
 
 std::istream& wsrep::operator>>(std::istream& is, wsrep::gtid& gtid)
@@ -59,32 +62,47 @@ std::istream& wsrep::operator>>(std::istream& is, wsrep::gtid& gtid)
 ssize_t wsrep::scan_from_c_str(
     const char* buf, size_t buf_len, wsrep::gtid& gtid)
 {
-    std::istringstream is(std::string(buf, buf_len));
-    is >> gtid;
-    // Some failure occurred
-    if (!is)
+    const char* delim(static_cast<const char*>(std::memchr(buf, ':', buf_len)));
+    if (delim == 0)
+    {
+        return -EINVAL;
+    }
+    wsrep::id id;
+    if (scan_from_c_str(buf, static_cast<size_t>(delim - buf), id) < 0)
     {
         return -EINVAL;
     }
-    // Whole string was consumed without failures
-    if (is.eof())
+    // Skip whitespace before seqno as istream would.
+    size_t pos(static_cast<size_t>(delim - buf) + 1);
+    while (pos < buf_len && std::isspace(static_cast<unsigned char>(buf[pos])))
     {
-        return static_cast<ssize_t>(buf_len);
+        ++pos;
     }
-    // The string was not consumed completely, return current position
-    // of the istream.
-    return static_cast<ssize_t>(is.tellg());
+    wsrep::seqno seqno;
+    const ssize_t ret(scan_from_c_str(buf + pos, buf_len - pos, seqno));
+    if (ret < 0)
+    {
+        return ret;
+    }
+    gtid = wsrep::gtid(id, seqno);
+    return static_cast<ssize_t>(pos) + ret;
 }
 
 ssize_t wsrep::print_to_c_str(
     const wsrep::gtid& gtid, char* buf, size_t buf_len)
 {
-    std::ostringstream os;
-    os << gtid;
-    if (os.str().size() > buf_len)
+    const ssize_t id_len(print_to_c_str(gtid.id(), buf, buf_len));
+    if (id_len < 0 || static_cast<size_t>(id_len) == buf_len)
     {
         return -ENOBUFS;
     }
-    std::strncpy(buf, os.str().c_str(), os.str().size());
-    return static_cast<ssize_t>(os.str().size());
+    buf[id_len] = ':';
+    const size_t pos(static_cast<size_t>(id_len) + 1);
+    const ssize_t seqno_len(
+        print_to_c_str(gtid.seqno(), buf + pos, buf_len - pos));
+    if (seqno_len < 0)
+    {
+        return seqno_len;
+    }
+    return static_cast<ssize_t>(pos) + seqno_len;
 }
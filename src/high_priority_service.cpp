@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/high_priority_service.hpp"
+
+#include <cassert>
+
+int wsrep::high_priority_service::apply_toi_batch(
+    const wsrep::ws_meta& ws_meta,
+    const std::vector<wsrep::const_buffer>& statements,
+    std::vector<wsrep::mutable_buffer>& errors)
+{
+    assert(statements.size() == errors.size());
+    int ret(0);
+    for (size_t i(0); i < statements.size(); ++i)
+    {
+        if (apply_toi(ws_meta, statements[i], errors[i]))
+        {
+            ret = 1;
+        }
+    }
+    return ret;
+}
@@ -21,6 +21,7 @@
 #include "uuid.hpp"
 
 #include <cctype>
+#include <cerrno>
 #include <sstream>
 #include <algorithm>
 
@@ -29,19 +30,7 @@ const wsrep::id wsrep::id::undefined_ = wsrep::id();
 wsrep::id::id(const std::string& str)
     :  data_()
 {
-    wsrep::uuid_t wsrep_uuid;
-
-    if (str.size() == WSREP_LIB_UUID_STR_LEN &&
-        wsrep::uuid_scan(str.c_str(), str.size(), &wsrep_uuid) ==
-        WSREP_LIB_UUID_STR_LEN)
-    {
-        std::memcpy(data_.buf, wsrep_uuid.data, sizeof(data_.buf));
-    }
-    else if (str.size() <= 16)
-    {
-        std::memcpy(data_.buf, str.c_str(), str.size());
-    }
-    else
+    if (scan_from_c_str(str.c_str(), str.size(), *this) < 0)
     {
         std::ostringstream os;
         os << "String '" << str
@@ -52,9 +41,9 @@ wsrep::id::id(const std::string& str)
 
 std::string wsrep::id::to_string() const
 {
-  std::ostringstream os;
-  os << *this;
-  return os.str();
+    char buf[WSREP_LIB_ID_C_STR_LEN];
+    return std::string(buf, static_cast<size_t>(
+                           print_to_c_str(*this, buf, sizeof(buf))));
 }
 
 
@@ -78,30 +67,64 @@ static bool is_alphanumeric_string(const char* ptr, size_t size)
                        [](char c) { return (c == '\0'); });
 }
 
-std::ostream& wsrep::operator<<(std::ostream& os, const wsrep::id& id)
+ssize_t wsrep::scan_from_c_str(const char* buf, size_t buf_len,
+                               wsrep::id& id)
+{
+    wsrep::uuid_t wsrep_uuid;
+    if (buf_len == WSREP_LIB_UUID_STR_LEN &&
+        wsrep::uuid_scan(buf, buf_len, &wsrep_uuid) == WSREP_LIB_UUID_STR_LEN)
+    {
+        id = wsrep::id(wsrep_uuid.data, sizeof(wsrep_uuid.data));
+    }
+    else if (buf_len <= 16)
+    {
+        id = wsrep::id(buf, buf_len);
+    }
+    else
+    {
+        return -EINVAL;
+    }
+    return static_cast<ssize_t>(buf_len);
+}
+
+ssize_t wsrep::print_to_c_str(const wsrep::id& id, char* buf, size_t buf_len)
 {
     const char* ptr(static_cast<const char*>(id.data()));
     size_t size(id.size());
     /* If the buffer pointed by ptr contains only alphanumeric chars followed by
-     * one or more null terminators, return the string. */
+     * one or more null terminators, print the string. */
     if (is_alphanumeric_string(ptr, size))
     {
-        return (os << std::string(ptr, ::strnlen(ptr, size)));
+        size = ::strnlen(ptr, size);
+        if (size > buf_len)
+        {
+            return -ENOBUFS;
+        }
+        std::memcpy(buf, ptr, size);
+        return static_cast<ssize_t>(size);
     }
     else
     {
+        if (buf_len < WSREP_LIB_UUID_STR_LEN)
+        {
+            return -ENOBUFS;
+        }
         char uuid_str[WSREP_LIB_UUID_STR_LEN + 1];
         wsrep::uuid_t uuid;
         std::memcpy(uuid.data, ptr, sizeof(uuid.data));
-        if (wsrep::uuid_print(&uuid, uuid_str, sizeof(uuid_str)) < 0)
-        {
-            throw wsrep::runtime_error("Could not print uuid");
-        }
-        uuid_str[WSREP_LIB_UUID_STR_LEN] = '\0';
-        return (os << uuid_str);
+        wsrep::uuid_print(&uuid, uuid_str, sizeof(uuid_str));
+        std::memcpy(buf, uuid_str, WSREP_LIB_UUID_STR_LEN);
+        return WSREP_LIB_UUID_STR_LEN;
     }
 }
 
+std::ostream& wsrep::operator<<(std::ostream& os, const wsrep::id& id)
+{
+    char buf[WSREP_LIB_ID_C_STR_LEN + 1];
+    buf[print_to_c_str(id, buf, sizeof(buf) - 1)] = '\0';
+    return (os << buf);
+}
+
 std::istream& wsrep::operator>>(std::istream& is, wsrep::id& id)
 {
     std::string id_str;
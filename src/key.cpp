@@ -18,11 +18,27 @@
  */
 
 #include "wsrep/key.hpp"
+#include <cstring>
 #include <ostream>
 #include <iomanip>
 
 namespace
 {
+    // 64-bit FNV-1a
+    const uint64_t fnv64_offset = 14695981039346656037ULL;
+    const uint64_t fnv64_prime = 1099511628211ULL;
+
+    uint64_t fnv64_append(uint64_t hash, const void* ptr, size_t len)
+    {
+        const unsigned char* p(static_cast<const unsigned char*>(ptr));
+        for (size_t i(0); i < len; ++i)
+        {
+            hash ^= p[i];
+            hash *= fnv64_prime;
+        }
+        return hash;
+    }
+
     void print_key_part(std::ostream& os, const void* ptr, size_t len)
     {
         std::ios::fmtflags flags_save(os.flags());
@@ -39,6 +55,53 @@ namespace
     }
 }
 
+uint64_t wsrep::key::compute_hash() const
+{
+    uint64_t ret(fnv64_offset);
+    for (size_t i(0); i < key_parts_len_; ++i)
+    {
+        // Mix in part length so that part boundaries affect the hash.
+        const uint64_t len(key_parts_[i].size());
+        ret = fnv64_append(ret, &len, sizeof(len));
+        ret = fnv64_append(ret, key_parts_[i].ptr(), key_parts_[i].size());
+    }
+    return ret;
+}
+
+bool wsrep::operator==(const wsrep::key& lhs, const wsrep::key& rhs)
+{
+    if (lhs.type() != rhs.type() || lhs.size() != rhs.size())
+    {
+        return false;
+    }
+    for (size_t i(0); i < lhs.size(); ++i)
+    {
+        const wsrep::const_buffer& l(lhs.key_parts()[i]);
+        const wsrep::const_buffer& r(rhs.key_parts()[i]);
+        if (l.size() != r.size() ||
+            (l.size() && std::memcmp(l.ptr(), r.ptr(), l.size())))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const size_t wsrep::key_array::inline_capacity;
+
+void wsrep::key_array::grow(size_t capacity)
+{
+    wsrep::key* data(static_cast<wsrep::key*>(
+                         ::operator new(capacity * sizeof(wsrep::key))));
+    std::uninitialized_copy(data_, data_ + size_, data);
+    if (data_ != inline_data())
+    {
+        ::operator delete(data_);
+    }
+    data_ = data;
+    capacity_ = capacity;
+}
+
 std::ostream& wsrep::operator<<(std::ostream& os,
                                 enum wsrep::key::type key_type)
 {
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/key_filter.hpp"
+#include "wsrep/key.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Initial number of slots, must be power of two.
+    const size_t initial_slots = 16;
+    // Release memory on clear() if the filter has grown beyond these.
+    const size_t max_retained_slots = 1024;
+    const size_t max_retained_data = 64 * 1024;
+}
+
+bool wsrep::key_filter::equal(const slot& s, const wsrep::key& key) const
+{
+    const char* pos(data_.data() + s.offset - 1);
+    const char* const end(pos + s.len);
+    for (size_t i(0); i < key.size(); ++i)
+    {
+        size_t len;
+        if (static_cast<size_t>(end - pos) < sizeof(len)) return false;
+        std::memcpy(&len, pos, sizeof(len));
+        pos += sizeof(len);
+        if (len != key.key_parts()[i].size() ||
+            static_cast<size_t>(end - pos) < len ||
+            std::memcmp(pos, key.key_parts()[i].data(), len))
+        {
+            return false;
+        }
+        pos += len;
+    }
+    return (pos == end);
+}
+
+void wsrep::key_filter::grow()
+{
+    std::vector<slot> old;
+    old.swap(slots_);
+    slot const empty = { 0, 0, 0, 0 };
+    slots_.assign(old.empty() ? initial_slots : old.size() * 2, empty);
+    const size_t mask(slots_.size() - 1);
+    for (std::vector<slot>::const_iterator i(old.begin()); i != old.end(); ++i)
+    {
+        if (i->offset == 0) continue;
+        size_t pos(static_cast<size_t>(i->hash) & mask);
+        while (slots_[pos].offset) pos = (pos + 1) & mask;
+        slots_[pos] = *i;
+    }
+}
+
+enum wsrep::key_filter::result
+wsrep::key_filter::insert(const wsrep::key& key)
+{
+    // Keep load factor below one half.
+    if (2 * (size_ + 1) > slots_.size())
+    {
+        grow();
+    }
+
+    const uint64_t hash(key.hash());
+    const size_t mask(slots_.size() - 1);
+    size_t pos(static_cast<size_t>(hash) & mask);
+    while (slots_[pos].offset)
+    {
+        slot& s(slots_[pos]);
+        if (s.hash == hash && equal(s, key))
+        {
+            if (s.type == key.type())
+            {
+                ++duplicates_;
+                return duplicate;
+            }
+            else if (s.type > key.type())
+            {
+                ++subsumed_;
+                return subsumed;
+            }
+            s.type = key.type();
+            return upgraded;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    const size_t offset(data_.size());
+    for (size_t i(0); i < key.size(); ++i)
+    {
+        const size_t len(key.key_parts()[i].size());
+        const char* lenp(reinterpret_cast<const char*>(&len));
+        data_.insert(data_.end(), lenp, lenp + sizeof(len));
+        data_.insert(data_.end(), key.key_parts()[i].data(),
+                     key.key_parts()[i].data() + len);
+    }
+    slot const s = { hash, offset + 1, data_.size() - offset, key.type() };
+    slots_[pos] = s;
+    ++size_;
+    return inserted;
+}
+
+void wsrep::key_filter::clear()
+{
+    if (slots_.size() > max_retained_slots)
+    {
+        std::vector<slot>().swap(slots_);
+    }
+    else
+    {
+        slot const empty = { 0, 0, 0, 0 };
+        std::fill(slots_.begin(), slots_.end(), empty);
+    }
+    if (data_.capacity() > max_retained_data)
+    {
+        std::vector<char>().swap(data_);
+    }
+    else
+    {
+        data_.clear();
+    }
+    size_ = 0;
+}
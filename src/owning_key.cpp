@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/owning_key.hpp"
+
+#include <cstring>
+
+namespace
+{
+    // Make room for one more chunk pointer. This is done before
+    // allocating the chunk, so that storing it cannot throw and
+    // leak the chunk.
+    void reserve_chunk(std::vector<char*>& chunks)
+    {
+        if (chunks.size() == chunks.capacity())
+        {
+            chunks.reserve(chunks.empty() ? 4 : 2 * chunks.size());
+        }
+    }
+}
+
+wsrep::key_arena::~key_arena()
+{
+    for (std::vector<char*>::iterator i(chunks_.begin());
+         i != chunks_.end(); ++i)
+    {
+        delete[] *i;
+    }
+}
+
+char* wsrep::key_arena::allocate(size_t size)
+{
+    if (chunks_.empty())
+    {
+        reserve_chunk(chunks_);
+        chunks_.push_back(new char[chunk_size_]);
+        pos_ = 0;
+    }
+    if (size > chunk_size_)
+    {
+        // Oversized allocation gets a chunk of its own. It is
+        // inserted before the current chunk so that allocations
+        // may continue from the current chunk.
+        reserve_chunk(chunks_);
+        char* ret(new char[size]);
+        chunks_.insert(chunks_.end() - 1, ret);
+        return ret;
+    }
+    if (chunk_size_ - pos_ < size)
+    {
+        reserve_chunk(chunks_);
+        chunks_.push_back(new char[chunk_size_]);
+        pos_ = 0;
+    }
+    char* ret(chunks_.back() + pos_);
+    pos_ += size;
+    return ret;
+}
+
+void wsrep::key_arena::clear()
+{
+    // Oversized chunks may precede the last chunk, retain the
+    // last one which is always of chunk_size_.
+    if (chunks_.size() > 1)
+    {
+        char* last(chunks_.back());
+        for (size_t i(0); i < chunks_.size() - 1; ++i)
+        {
+            delete[] chunks_[i];
+        }
+        chunks_.clear();
+        chunks_.push_back(last);
+    }
+    pos_ = 0;
+}
+
+void wsrep::owning_key::append_key_part(const void* ptr, size_t len)
+{
+    if (parts_len_ == 3)
+    {
+        throw wsrep::runtime_error("key parts exceed maximum of 3");
+    }
+    part& p(parts_[parts_len_]);
+    if (heap_.empty() && data_size_ + len <= inline_capacity)
+    {
+        p.ptr = 0;
+        p.offset = data_size_;
+        std::memcpy(inline_ + data_size_, ptr, len);
+        data_size_ += len;
+    }
+    else if (arena_)
+    {
+        char* buf(arena_->allocate(len));
+        std::memcpy(buf, ptr, len);
+        p.ptr = buf;
+        p.offset = 0;
+    }
+    else
+    {
+        if (heap_.empty())
+        {
+            heap_.reserve(data_size_ + len);
+            heap_.assign(inline_, inline_ + data_size_);
+        }
+        const char* cptr(static_cast<const char*>(ptr));
+        p.ptr = 0;
+        p.offset = data_size_;
+        heap_.insert(heap_.end(), cptr, cptr + len);
+        data_size_ += len;
+    }
+    p.len = len;
+    ++parts_len_;
+}
+
+wsrep::key wsrep::owning_key::key() const
+{
+    wsrep::key ret(type_);
+    for (size_t i(0); i < parts_len_; ++i)
+    {
+        const part& p(parts_[i]);
+        ret.append_key_part(p.ptr ? p.ptr : storage() + p.offset, p.len);
+    }
+    if (has_hash_)
+    {
+        ret.hash(hash_);
+    }
+    return ret;
+}
@@ -24,6 +24,8 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cerrno>
+#include <cstdlib>
 #include <cstring>
 
 /**
@@ -48,6 +50,66 @@ static void sanitize_name(std::string& name)
                    });
 }
 
+// Convert option value to typed value. Values of string type are
+// parsed, return false if parsing fails.
+static bool to_typed_value(const wsrep::provider_options::option_value& value,
+                           bool& ret)
+{
+    if (value.type() == wsrep::provider_options::flag::type_bool)
+    {
+        ret = *static_cast<const bool*>(value.get_ptr());
+        return true;
+    }
+    std::string str(value.as_string());
+    std::transform(str.begin(), str.end(), str.begin(),
+                   [](unsigned char c) { return char(std::tolower(c)); });
+    if (str == "1" || str == "yes" || str == "true" || str == "on")
+    {
+        ret = true;
+        return true;
+    }
+    if (str == "0" || str == "no" || str == "false" || str == "off")
+    {
+        ret = false;
+        return true;
+    }
+    return false;
+}
+
+static bool to_typed_value(const wsrep::provider_options::option_value& value,
+                           int64_t& ret)
+{
+    if (value.type() == wsrep::provider_options::flag::type_integer)
+    {
+        ret = *static_cast<const int64_t*>(value.get_ptr());
+        return true;
+    }
+    const char* str(value.as_string());
+    char* end;
+    errno = 0;
+    const long long val(std::strtoll(str, &end, 10));
+    if (errno || end == str || *end != '\0') return false;
+    ret = val;
+    return true;
+}
+
+static bool to_typed_value(const wsrep::provider_options::option_value& value,
+                           double& ret)
+{
+    if (value.type() == wsrep::provider_options::flag::type_double)
+    {
+        ret = *static_cast<const double*>(value.get_ptr());
+        return true;
+    }
+    const char* str(value.as_string());
+    char* end;
+    errno = 0;
+    const double val(std::strtod(str, &end));
+    if (errno || end == str || *end != '\0') return false;
+    ret = val;
+    return true;
+}
+
 bool wsrep::operator==(const wsrep::provider_options::option& left,
                        const wsrep::provider_options::option& right)
 {
@@ -67,6 +129,7 @@ wsrep::provider_options::option::option()
     , value_{}
     , default_value_{}
     , flags_{ 0 }
+    , typed_value_{ std::make_shared<typed_value>() }
 {
 }
 
@@ -80,14 +143,47 @@ wsrep::provider_options::option::option(
     , value_{ std::move(value) }
     , default_value_{ std::move(default_value) }
     , flags_{ flags }
+    , typed_value_{ std::make_shared<typed_value>() }
 {
     sanitize_name(name_);
+    update_typed_value();
 }
 
 void wsrep::provider_options::option::update_value(
     std::unique_ptr<wsrep::provider_options::option_value> value)
 {
     value_ = std::move(value);
+    update_typed_value();
+}
+
+// If the value cannot be converted, the previous typed value is kept.
+void wsrep::provider_options::option::update_typed_value()
+{
+    if (not value_) return;
+    switch (flags_ & flag_type_mask)
+    {
+    case flag::type_bool:
+    {
+        bool val;
+        if (to_typed_value(*value_, val))
+            typed_value_->as_bool.store(val, std::memory_order_relaxed);
+        break;
+    }
+    case flag::type_integer:
+    {
+        int64_t val;
+        if (to_typed_value(*value_, val))
+            typed_value_->as_integer.store(val, std::memory_order_relaxed);
+        break;
+    }
+    case flag::type_double:
+    {
+        double val;
+        if (to_typed_value(*value_, val))
+            typed_value_->as_double.store(val, std::memory_order_relaxed);
+        break;
+    }
+    }
 }
 
 wsrep::provider_options::option::~option() {}
@@ -142,6 +238,100 @@ enum wsrep::provider::status wsrep::provider_options::set(
     return ret;
 }
 
+enum wsrep::provider::status wsrep::provider_options::set(
+    option_values values)
+{
+    std::vector<option*> options;
+    options.reserve(values.size());
+    provider_options_sep sep;
+    std::string options_str;
+    for (const auto& value : values)
+    {
+        auto option(options_.find(value.first));
+        if (option == options_.end())
+        {
+            return not_found_error;
+        }
+        options.push_back(option->second.get());
+        options_str += std::string(option->second->real_name())
+            + sep.key_value + value.second->as_string() + sep.param;
+    }
+    if (options.empty())
+    {
+        return provider::success;
+    }
+    auto ret(provider_.options(options_str));
+    if (ret == provider::success)
+    {
+        for (size_t i(0); i < options.size(); ++i)
+        {
+            options[i]->update_value(std::move(values[i].second));
+        }
+    }
+    return ret;
+}
+
+// Find option for handle, the option type must match type_flag.
+static enum wsrep::provider::status
+find_typed_option(const wsrep::provider_options& options,
+                  const std::string& name, int type_flag,
+                  const wsrep::provider_options::option*& option)
+{
+    option = options.get_option(name);
+    if (option == nullptr)
+    {
+        return not_found_error;
+    }
+    if ((option->flags() & wsrep::provider_options::flag_type_mask)
+        != type_flag)
+    {
+        return wsrep::provider::error_not_allowed;
+    }
+    return wsrep::provider::success;
+}
+
+enum wsrep::provider::status wsrep::provider_options::get_handle(
+    const std::string& name, option_handle<bool>& handle) const
+{
+    const option* opt;
+    auto ret(find_typed_option(*this, name, flag::type_bool, opt));
+    if (ret == provider::success)
+    {
+        handle = option_handle<bool>(
+            std::shared_ptr<const std::atomic<bool>>(
+                opt->typed_value_, &opt->typed_value_->as_bool));
+    }
+    return ret;
+}
+
+enum wsrep::provider::status wsrep::provider_options::get_handle(
+    const std::string& name, option_handle<int64_t>& handle) const
+{
+    const option* opt;
+    auto ret(find_typed_option(*this, name, flag::type_integer, opt));
+    if (ret == provider::success)
+    {
+        handle = option_handle<int64_t>(
+            std::shared_ptr<const std::atomic<int64_t>>(
+                opt->typed_value_, &opt->typed_value_->as_integer));
+    }
+    return ret;
+}
+
+enum wsrep::provider::status wsrep::provider_options::get_handle(
+    const std::string& name, option_handle<double>& handle) const
+{
+    const option* opt;
+    auto ret(find_typed_option(*this, name, flag::type_double, opt));
+    if (ret == provider::success)
+    {
+        handle = option_handle<double>(
+            std::shared_ptr<const std::atomic<double>>(
+                opt->typed_value_, &opt->typed_value_->as_double));
+    }
+    return ret;
+}
+
 enum wsrep::provider::status wsrep::provider_options::set_default(
     const std::string& name,
     std::unique_ptr<wsrep::provider_options::option_value> value,
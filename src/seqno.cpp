@@ -18,9 +18,67 @@
  */
 
 #include "wsrep/seqno.hpp"
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
 #include <ostream>
 
 std::ostream& wsrep::operator<<(std::ostream& os, wsrep::seqno seqno)
 {
     return (os << seqno.get());
 }
+
+ssize_t wsrep::scan_from_c_str(const char* buf, size_t buf_len,
+                               wsrep::seqno& seqno)
+{
+    size_t pos(0);
+    const bool negative(buf_len > 0 && buf[0] == '-');
+    if (buf_len > 0 && (buf[0] == '-' || buf[0] == '+')) ++pos;
+    const unsigned long long limit(
+        negative ? static_cast<unsigned long long>(LLONG_MAX) + 1 : LLONG_MAX);
+    const size_t digits_begin(pos);
+    unsigned long long value(0);
+    for (; pos < buf_len && buf[pos] >= '0' && buf[pos] <= '9'; ++pos)
+    {
+        const unsigned int digit(static_cast<unsigned int>(buf[pos] - '0'));
+        if (value > (limit - digit) / 10)
+        {
+            return -EINVAL;
+        }
+        value = value * 10 + digit;
+    }
+    if (pos == digits_begin)
+    {
+        return -EINVAL;
+    }
+    seqno = wsrep::seqno(negative ?
+                         static_cast<long long>(0 - value) :
+                         static_cast<long long>(value));
+    return static_cast<ssize_t>(pos);
+}
+
+ssize_t wsrep::print_to_c_str(wsrep::seqno seqno, char* buf, size_t buf_len)
+{
+    // Digits are generated backwards from the end of tmp.
+    char tmp[WSREP_LIB_SEQNO_C_STR_LEN];
+    char* const end(tmp + sizeof(tmp));
+    char* begin(end);
+    const long long val(seqno.get());
+    unsigned long long abs(val < 0 ? 0 - static_cast<unsigned long long>(val)
+                           : static_cast<unsigned long long>(val));
+    do
+    {
+        *--begin = static_cast<char>('0' + abs % 10);
+        abs /= 10;
+    }
+    while (abs);
+    if (val < 0) *--begin = '-';
+    const size_t len(static_cast<size_t>(end - begin));
+    if (len > buf_len)
+    {
+        return -ENOBUFS;
+    }
+    std::memcpy(buf, begin, len);
+    return static_cast<ssize_t>(len);
+}
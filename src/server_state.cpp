@@ -18,19 +18,23 @@
  */
 
 #include "wsrep/server_state.hpp"
+#include "wsrep/alloc_stats.hpp"
 #include "wsrep/client_state.hpp"
 #include "wsrep/server_service.hpp"
 #include "wsrep/client_service.hpp"
 #include "wsrep/high_priority_service.hpp"
 #include "wsrep/transaction.hpp"
 #include "wsrep/view.hpp"
+#include "wsrep/ws_capture.hpp"
 #include "wsrep/logger.hpp"
 #include "wsrep/compiler.hpp"
 #include "wsrep/id.hpp"
+#include "wsrep/toi_batch.hpp"
 
 #include <cassert>
 #include <sstream>
 #include <algorithm>
+#include <thread> // std::this_thread::yield()
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -452,11 +456,32 @@ static int apply_write_set(wsrep::server_state& server_state,
     return ret;
 }
 
+static int apply_toi_batch(wsrep::high_priority_service& high_priority_service,
+                           const wsrep::ws_meta& ws_meta,
+                           const wsrep::const_buffer& data,
+                           wsrep::mutable_buffer& err)
+{
+    std::vector<wsrep::const_buffer> statements;
+    if (wsrep::toi_batch::parse(data, statements))
+    {
+        wsrep::log_error() << "Malformed TOI batch: " << ws_meta;
+        const std::string msg("Malformed TOI batch");
+        err.push_back(msg);
+        return 1;
+    }
+    std::vector<wsrep::mutable_buffer> errors(statements.size());
+    int const ret(high_priority_service.apply_toi_batch(ws_meta, statements,
+                                                         errors));
+    wsrep::toi_batch::encode_errors(errors, err);
+    return ret;
+}
+
 static int apply_toi(wsrep::provider& provider,
                      wsrep::high_priority_service& high_priority_service,
                      const wsrep::ws_handle& ws_handle,
                      const wsrep::ws_meta& ws_meta,
-                     const wsrep::const_buffer& data)
+                     const wsrep::const_buffer& data,
+                     bool toi_batching)
 {
     if (wsrep::starts_transaction(ws_meta.flags()) &&
         wsrep::commits_transaction(ws_meta.flags()))
@@ -466,7 +491,11 @@ static int apply_toi(wsrep::provider& provider,
         //
         provider.commit_order_enter(ws_handle, ws_meta);
         wsrep::mutable_buffer err;
-        int const apply_err(high_priority_service.apply_toi(ws_meta,data,err));
+        bool const batch(toi_batching && wsrep::toi_batch::is_batch(data));
+        int const apply_err(batch ?
+                            apply_toi_batch(high_priority_service,
+                                            ws_meta, data, err) :
+                            high_priority_service.apply_toi(ws_meta,data,err));
         int const vote_err(provider.commit_order_leave(ws_handle, ws_meta,err));
         return resolve_return_error(err.size() > 0, vote_err, apply_err);
     }
@@ -776,11 +805,7 @@ try
                 throw wsrep::runtime_error(msg.str());
             }
 
-            if (current_view_.status() == wsrep::view::primary)
-            {
-                previous_primary_view_ = current_view_;
-            }
-            current_view_ = v;
+            set_current_view(v);
             server_service_.log_view(NULL /* this view is stored already */, v);
         }
         else
@@ -1028,11 +1053,7 @@ void wsrep::server_state::on_view(const wsrep::view& view,
         << "================================================\nView:\n"
         << view
         << "=================================================";
-    if (current_view_.status() == wsrep::view::primary)
-    {
-        previous_primary_view_ = current_view_;
-    }
-    current_view_ = view;
+    set_current_view(view);
     switch (view.status())
     {
     case wsrep::view::primary:
@@ -1115,10 +1136,18 @@ int wsrep::server_state::on_apply(
     const wsrep::ws_meta& ws_meta,
     const wsrep::const_buffer& data)
 {
+    WSREP_ALLOC_PHASE(p_apply);
+    wsrep::ws_capture* capture(ws_capture_);
+    if (capture && capture->record(ws_handle, ws_meta, data))
+    {
+        wsrep::log_warning() << "Failed to capture write set " << ws_meta
+                             << ", capturing disabled";
+        ws_capture_ = nullptr;
+    }
     if (is_toi(ws_meta.flags()))
     {
         return apply_toi(provider(), high_priority_service,
-                         ws_handle, ws_meta, data);
+                         ws_handle, ws_meta, data, toi_batching());
     }
     else if (is_commutative(ws_meta.flags()) || is_native(ws_meta.flags()))
     {
@@ -1133,6 +1162,32 @@ int wsrep::server_state::on_apply(
     }
 }
 
+// The view snapshot lock is held only for a shared_ptr copy or swap.
+// Yield while waiting so that a preempted holder gets to run.
+static void lock_view_snapshot(std::atomic<bool>& lock)
+{
+    while (lock.exchange(true, std::memory_order_acquire))
+    {
+        while (lock.load(std::memory_order_relaxed))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+static void unlock_view_snapshot(std::atomic<bool>& lock)
+{
+    lock.store(false, std::memory_order_release);
+}
+
+std::shared_ptr<const wsrep::view> wsrep::server_state::view_snapshot() const
+{
+    lock_view_snapshot(view_snapshot_lock_);
+    std::shared_ptr<const wsrep::view> ret(view_snapshot_);
+    unlock_view_snapshot(view_snapshot_lock_);
+    return ret;
+}
+
 enum wsrep::server_state::state wsrep::server_state::state(
     wsrep::unique_lock<wsrep::mutex>& lock WSREP_UNUSED) const
 {
@@ -1383,6 +1438,7 @@ void wsrep::server_state::state(
     state_hist_.push_back(state_);
     server_service_.log_state_change(state_, state);
     state_ = state;
+    atomic_state_.store(state, std::memory_order_release);
     cond_.notify_all();
     while (state_waiters_[state_])
     {
@@ -1649,6 +1705,21 @@ wsrep::server_state::send_pending_rollback_events()
     return send_pending_rollback_events(lock);
 }
 
+void wsrep::server_state::set_current_view(const wsrep::view& view)
+{
+    if (current_view_.status() == wsrep::view::primary)
+    {
+        previous_primary_view_ = current_view_;
+    }
+    current_view_ = view;
+    // Swap under the lock and release the old snapshot after it.
+    std::shared_ptr<const wsrep::view> snapshot(
+        std::make_shared<const wsrep::view>(view));
+    lock_view_snapshot(view_snapshot_lock_);
+    view_snapshot_.swap(snapshot);
+    unlock_view_snapshot(view_snapshot_lock_);
+}
+
 void wsrep::server_state::return_from_donor_state(
     wsrep::unique_lock<wsrep::mutex>& lock)
 {
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/tls_service.hpp"
+
+wsrep::tls_service::op_result
+wsrep::tls_service::readv(wsrep::tls_stream* stream,
+                          const struct iovec* iov, int iovcnt) WSREP_NOEXCEPT
+{
+    for (int i(0); i < iovcnt; ++i)
+    {
+        if (iov[i].iov_len > 0)
+        {
+            return read(stream, iov[i].iov_base, iov[i].iov_len);
+        }
+    }
+    return read(stream, 0, 0);
+}
+
+wsrep::tls_service::op_result
+wsrep::tls_service::writev(wsrep::tls_stream* stream,
+                           const struct iovec* iov, int iovcnt) WSREP_NOEXCEPT
+{
+    op_result ret = { success, 0 };
+    for (int i(0); i < iovcnt; ++i)
+    {
+        if (iov[i].iov_len == 0) continue;
+        op_result result(write(stream, iov[i].iov_base, iov[i].iov_len));
+        ret.status = result.status;
+        ret.bytes_transferred += result.bytes_transferred;
+        if (result.status != success ||
+            result.bytes_transferred < iov[i].iov_len)
+        {
+            break;
+        }
+    }
+    return ret;
+}
@@ -166,6 +166,9 @@ namespace wsrep_tls_service_v1
                 reinterpret_cast<wsrep::tls_stream*>(stream->opaque)));
     }
 
+    // The v1 service interface has single buffer callbacks only,
+    // wsrep::tls_service::readv() and writev() are not exposed to
+    // the provider through it.
     static wsrep_tls_service_v1_t tls_service_callbacks =
     {
         tls_stream_init_cb,
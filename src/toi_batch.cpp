@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/toi_batch.hpp"
+#include "wsrep/exception.hpp"
+
+#include <cstring>
+#include <stdint.h>
+
+namespace
+{
+    // Batch buffer starts with magic which is unlikely to appear
+    // at the start of application TOI buffer, followed by
+    // the number of statements. The last byte of magic is the
+    // format version.
+    const char batch_magic[8] = { '\0', 'W', 'S', 'R', 'T', 'O', 'I', '\1' };
+    const size_t header_size = sizeof(batch_magic) + 4;
+
+    // Integers are encoded in little endian byte order to make
+    // the buffer identical on all nodes.
+    void put_u32(char* buf, uint32_t val)
+    {
+        for (size_t i(0); i < 4; ++i)
+        {
+            buf[i] = static_cast<char>((val >> (8 * i)) & 0xff);
+        }
+    }
+
+    void append_u32(std::vector<char>& buf, uint32_t val)
+    {
+        char tmp[4];
+        put_u32(tmp, val);
+        buf.insert(buf.end(), tmp, tmp + 4);
+    }
+
+    bool get_u32(const char*& pos, const char* end, uint32_t& val)
+    {
+        if (end - pos < 4) return false;
+        val = 0;
+        for (size_t i(0); i < 4; ++i)
+        {
+            val |= static_cast<uint32_t>(
+                static_cast<unsigned char>(pos[i])) << (8 * i);
+        }
+        pos += 4;
+        return true;
+    }
+
+    uint32_t checked_u32(size_t val)
+    {
+        if (val > UINT32_MAX)
+        {
+            throw wsrep::runtime_error("TOI batch size exceeds maximum");
+        }
+        return static_cast<uint32_t>(val);
+    }
+
+    bool key_parts_equal(const wsrep::key& a, const wsrep::key& b)
+    {
+        if (a.size() != b.size()) return false;
+        for (size_t i(0); i < a.size(); ++i)
+        {
+            if (a.key_parts()[i].size() != b.key_parts()[i].size() ||
+                std::memcmp(a.key_parts()[i].data(), b.key_parts()[i].data(),
+                            a.key_parts()[i].size()))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void wsrep::toi_batch::add_key(const wsrep::key& key)
+{
+    switch (key_filter_.insert(key))
+    {
+    case wsrep::key_filter::inserted:
+        keys_.push_back(key);
+        break;
+    case wsrep::key_filter::upgraded:
+        for (auto i(keys_.begin()); i != keys_.end(); ++i)
+        {
+            if (key_parts_equal(*i, key))
+            {
+                *i = key;
+                break;
+            }
+        }
+        break;
+    case wsrep::key_filter::duplicate:
+    case wsrep::key_filter::subsumed:
+        break;
+    }
+}
+
+void wsrep::toi_batch::add(const wsrep::key_array& keys,
+                           const wsrep::const_buffer& statement)
+{
+    const uint32_t len(checked_u32(statement.size()));
+    const uint32_t size(checked_u32(size_ + 1));
+    for (auto i(keys.begin()); i != keys.end(); ++i)
+    {
+        add_key(*i);
+    }
+    append_u32(data_, len);
+    data_.insert(data_.end(), statement.data(),
+                 statement.data() + statement.size());
+    put_u32(data_.data() + sizeof(batch_magic), size);
+    ++size_;
+}
+
+void wsrep::toi_batch::clear()
+{
+    keys_.clear();
+    key_filter_.clear();
+    data_.assign(batch_magic, batch_magic + sizeof(batch_magic));
+    append_u32(data_, 0);
+    size_ = 0;
+}
+
+bool wsrep::toi_batch::is_batch(const wsrep::const_buffer& data)
+{
+    return (data.size() >= header_size &&
+            std::memcmp(data.data(), batch_magic, sizeof(batch_magic)) == 0);
+}
+
+int wsrep::toi_batch::parse(const wsrep::const_buffer& data,
+                            std::vector<wsrep::const_buffer>& statements)
+{
+    statements.clear();
+    if (not is_batch(data)) return 1;
+    const char* pos(data.data() + sizeof(batch_magic));
+    const char* const end(data.data() + data.size());
+    uint32_t count;
+    if (not get_u32(pos, end, count)) return 1;
+    for (uint32_t i(0); i < count; ++i)
+    {
+        uint32_t len;
+        if (not get_u32(pos, end, len) ||
+            static_cast<size_t>(end - pos) < len)
+        {
+            statements.clear();
+            return 1;
+        }
+        statements.push_back(wsrep::const_buffer(pos, len));
+        pos += len;
+    }
+    return (pos == end ? 0 : 1);
+}
+
+void wsrep::toi_batch::encode_errors(
+    const std::vector<wsrep::mutable_buffer>& errors,
+    wsrep::mutable_buffer& err)
+{
+    std::vector<char> buf;
+    uint32_t failed(0);
+    append_u32(buf, failed);
+    for (size_t i(0); i < errors.size(); ++i)
+    {
+        if (errors[i].size())
+        {
+            append_u32(buf, checked_u32(i));
+            append_u32(buf, checked_u32(errors[i].size()));
+            buf.insert(buf.end(), errors[i].data(),
+                       errors[i].data() + errors[i].size());
+            ++failed;
+        }
+    }
+    err.clear();
+    if (failed)
+    {
+        put_u32(buf.data(), failed);
+        err.push_back(buf.data(), buf.data() + buf.size());
+    }
+}
+
+int wsrep::toi_batch::decode_errors(const wsrep::const_buffer& err,
+                                    std::vector<wsrep::mutable_buffer>& errors,
+                                    size_t statements)
+{
+    errors.assign(statements, wsrep::mutable_buffer());
+    if (err.size() == 0) return 0;
+    const char* pos(err.data());
+    const char* const end(err.data() + err.size());
+    uint32_t failed;
+    if (not get_u32(pos, end, failed)) return 1;
+    for (uint32_t i(0); i < failed; ++i)
+    {
+        uint32_t index, len;
+        if (not get_u32(pos, end, index) || index >= statements ||
+            not get_u32(pos, end, len) ||
+            static_cast<size_t>(end - pos) < len)
+        {
+            return 1;
+        }
+        errors[index].push_back(pos, pos + len);
+        pos += len;
+    }
+    return (pos == end ? 0 : 1);
+}
@@ -18,6 +18,7 @@
  */
 
 #include "wsrep/transaction.hpp"
+#include "wsrep/alloc_stats.hpp"
 #include "wsrep/client_state.hpp"
 #include "wsrep/server_state.hpp"
 #include "wsrep/storage_service.hpp"
@@ -29,6 +30,7 @@
 #include "wsrep/client_service.hpp"
 
 #include <cassert>
+#include <cstring>
 #include <sstream>
 #include <memory>
 
@@ -114,6 +116,8 @@ wsrep::transaction::transaction(
     , fragments_certified_for_statement_()
     , streaming_context_()
     , sr_keys_()
+    , key_filter_()
+    , borrowed_()
     , apply_error_buf_()
     , xid_()
     , streaming_rollback_in_progress_(false)
@@ -128,6 +132,7 @@ wsrep::transaction::~transaction()
 int wsrep::transaction::start_transaction(
     const wsrep::transaction_id& id)
 {
+    WSREP_ALLOC_PHASE(p_start);
     debug_log_state("start_transaction enter");
     assert(active() == false);
     assert(is_xa() == false);
@@ -158,6 +163,7 @@ int wsrep::transaction::start_transaction(
     const wsrep::ws_handle& ws_handle,
     const wsrep::ws_meta& ws_meta)
 {
+    WSREP_ALLOC_PHASE(p_start);
     debug_log_state("start_transaction enter");
     if (state() != s_replaying)
     {
@@ -246,26 +252,33 @@ int wsrep::transaction::assign_read_view(const wsrep::gtid* const gtid)
 
 int wsrep::transaction::append_key(const wsrep::key& key)
 {
-    assert(active());
-    try
-    {
-        debug_log_key_append(key);
-        sr_keys_.insert(key);
-        return provider().append_key(ws_handle_, key);
-    }
-    catch (...)
-    {
-        wsrep::log_error() << "Failed to append key";
-        return 1;
-    }
+    return do_append_key(key, true);
+}
+
+int wsrep::transaction::append_key_nocopy(const wsrep::key& key)
+{
+    return do_append_key(key, false);
 }
 
 int wsrep::transaction::append_data(const wsrep::const_buffer& data)
 {
+    WSREP_ALLOC_PHASE(p_append);
     assert(active());
     return provider().append_data(ws_handle_, data);
 }
 
+int wsrep::transaction::append_data_nocopy(const wsrep::const_buffer& data)
+{
+    WSREP_ALLOC_PHASE(p_append);
+    assert(active());
+    const int ret(provider().append_data_nocopy(ws_handle_, data));
+    if (ret == 0)
+    {
+        borrow(data);
+    }
+    return ret;
+}
+
 int wsrep::transaction::after_row()
 {
     wsrep::unique_lock<wsrep::mutex> lock(client_state_.mutex());
@@ -283,6 +296,7 @@ int wsrep::transaction::after_row()
 int wsrep::transaction::before_prepare(wsrep::unique_lock<wsrep::mutex>& lock,
                                        const wsrep::provider::seq_cb_t* seq_cb)
 {
+    WSREP_ALLOC_PHASE(p_commit);
     assert(lock.owns_lock());
     int ret(0);
     debug_log_state("before_prepare_enter");
@@ -405,6 +419,7 @@ int wsrep::transaction::before_prepare(wsrep::unique_lock<wsrep::mutex>& lock,
 int wsrep::transaction::after_prepare(
     wsrep::unique_lock<wsrep::mutex>& lock)
 {
+    WSREP_ALLOC_PHASE(p_commit);
     assert(lock.owns_lock());
 
     int ret = 0;
@@ -454,6 +469,7 @@ int wsrep::transaction::after_prepare(
 
 int wsrep::transaction::before_commit(const wsrep::provider::seq_cb* seq_cb)
 {
+    WSREP_ALLOC_PHASE(p_commit);
     int ret(1);
 
     wsrep::unique_lock<wsrep::mutex> lock(client_state_.mutex());
@@ -581,6 +597,7 @@ int wsrep::transaction::before_commit(const wsrep::provider::seq_cb* seq_cb)
 
 int wsrep::transaction::ordered_commit()
 {
+    WSREP_ALLOC_PHASE(p_commit);
     wsrep::unique_lock<wsrep::mutex> lock(client_state_.mutex());
     debug_log_state("ordered_commit_enter");
     assert(state() == s_committing);
@@ -620,6 +637,7 @@ int wsrep::transaction::ordered_commit()
 
 int wsrep::transaction::after_commit()
 {
+    WSREP_ALLOC_PHASE(p_commit);
     int ret(0);
 
     wsrep::unique_lock<wsrep::mutex> lock(client_state_.mutex());
@@ -667,6 +685,7 @@ int wsrep::transaction::after_commit()
 
 int wsrep::transaction::before_rollback()
 {
+    WSREP_ALLOC_PHASE(p_commit);
     wsrep::unique_lock<wsrep::mutex> lock(client_state_.mutex());
     debug_log_state("before_rollback_enter");
     assert(state() == s_executing ||
@@ -754,6 +773,7 @@ int wsrep::transaction::before_rollback()
 
 int wsrep::transaction::after_rollback()
 {
+    WSREP_ALLOC_PHASE(p_commit);
     wsrep::unique_lock<wsrep::mutex> lock(client_state_.mutex());
     debug_log_state("after_rollback_enter");
     assert(state() == s_aborting || state() == s_must_replay);
@@ -836,6 +856,7 @@ int wsrep::transaction::after_statement()
 
 int wsrep::transaction::after_statement(wsrep::unique_lock<wsrep::mutex>& lock)
 {
+    WSREP_ALLOC_PHASE(p_cleanup);
     int ret(0);
     debug_log_state("after_statement_enter");
     assert(lock.owns_lock());
@@ -1496,6 +1517,7 @@ int wsrep::transaction::streaming_step(wsrep::unique_lock<wsrep::mutex>& lock,
 int wsrep::transaction::certify_fragment(
     wsrep::unique_lock<wsrep::mutex>& lock)
 {
+    WSREP_ALLOC_PHASE(p_certify);
     assert(lock.owns_lock());
 
     assert(client_state_.mode() == wsrep::client_state::m_local);
@@ -1630,6 +1652,7 @@ int wsrep::transaction::certify_fragment(
                 "crash_replicate_fragment_before_certify");
 
             wsrep::ws_meta sr_ws_meta;
+            check_borrowed();
             cert_ret = provider().certify(client_state_.id(),
                                           ws_handle_,
                                           flags(),
@@ -1714,6 +1737,10 @@ int wsrep::transaction::certify_fragment(
         {
             error = wsrep::e_deadlock_error;
         }
+        // Next fragment starts a new write set, keys appended
+        // for this fragment must be appended again.
+        key_filter_.clear();
+        release_borrowed();
     }
     lock.lock();
     if (ret)
@@ -1757,6 +1784,7 @@ int wsrep::transaction::certify_fragment(
 int wsrep::transaction::certify_commit(
     wsrep::unique_lock<wsrep::mutex>& lock, const provider::seq_cb_t* seq_cb)
 {
+    WSREP_ALLOC_PHASE(p_certify);
     assert(lock.owns_lock());
     assert(active());
     client_service_.wait_for_replayers(lock);
@@ -1835,6 +1863,7 @@ int wsrep::transaction::certify_commit(
     }
 
     client_service_.debug_sync("wsrep_before_certification");
+    check_borrowed();
     enum wsrep::provider::status
         cert_ret(provider().certify(client_state_.id(),
                                    ws_handle_,
@@ -2117,8 +2146,86 @@ int wsrep::transaction::replay(wsrep::unique_lock<wsrep::mutex>& lock)
     return ret;
 }
 
+int wsrep::transaction::do_append_key(const wsrep::key& key, bool copy)
+{
+    WSREP_ALLOC_PHASE(p_append);
+    assert(active());
+    try
+    {
+        debug_log_key_append(key);
+        switch (key_filter_.insert(key))
+        {
+        case wsrep::key_filter::duplicate:
+        case wsrep::key_filter::subsumed:
+            WSREP_LOG_DEBUG(client_state_.debug_log_level(),
+                            wsrep::log::debug_level_transaction,
+                            "key_append: filtered out duplicate key");
+            return 0;
+        case wsrep::key_filter::inserted:
+        case wsrep::key_filter::upgraded:
+            break;
+        }
+        sr_keys_.insert(key);
+        const int ret(copy ?
+                      provider().append_key(ws_handle_, key) :
+                      provider().append_key_nocopy(ws_handle_, key));
+        if (ret)
+        {
+            // The key did not make it into write set, forget
+            // recorded keys to not to filter out retries.
+            key_filter_.clear();
+        }
+        else if (not copy)
+        {
+            for (size_t i(0); i < key.size(); ++i)
+            {
+                borrow(key.key_parts()[i]);
+            }
+        }
+        return ret;
+    }
+    catch (...)
+    {
+        key_filter_.clear();
+        wsrep::log_error() << "Failed to append key";
+        return 1;
+    }
+}
+
+void wsrep::transaction::borrow(const wsrep::const_buffer& buf WSREP_UNUSED)
+{
+#ifndef NDEBUG
+    borrowed_.push_back(
+        std::make_pair(buf, std::vector<char>(buf.data(),
+                                              buf.data() + buf.size())));
+#endif // NDEBUG
+}
+
+void wsrep::transaction::check_borrowed() const
+{
+#ifndef NDEBUG
+    for (auto i(borrowed_.begin()); i != borrowed_.end(); ++i)
+    {
+        if (i->first.size() &&
+            std::memcmp(i->first.data(), i->second.data(), i->first.size()))
+        {
+            wsrep::log_error() << "Buffer " << i->first.ptr()
+                               << " appended without copying "
+                               << "was modified before certification";
+            assert(0);
+        }
+    }
+#endif // NDEBUG
+}
+
+void wsrep::transaction::release_borrowed()
+{
+    borrowed_.clear();
+}
+
 void wsrep::transaction::cleanup()
 {
+    WSREP_ALLOC_PHASE(p_cleanup);
     debug_log_state("cleanup_enter");
     assert(state() == s_committed || state() == s_aborted);
     id_ = wsrep::transaction_id::undefined();
@@ -2139,6 +2246,8 @@ void wsrep::transaction::cleanup()
     certified_ = false;
     implicit_deps_ = false;
     sr_keys_.clear();
+    key_filter_.clear();
+    release_borrowed();
     streaming_context_.cleanup();
     client_service_.cleanup_transaction();
     apply_error_buf_.clear();
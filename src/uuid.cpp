@@ -21,11 +21,118 @@
 
 #include <cstring>
 #include <cerrno>
-#include <cstdio>
-#include <cctype>
+#include <cstdint>
+
+//
+// Hex conversion processes eight bytes at a time in a 64 bit word.
+// The words are loaded and stored with shifts, which the compiler
+// merges into single memory accesses, so the result does not depend
+// on byte order.
+//
+
+static inline uint64_t load_word(const char* str)
+{
+    uint64_t ret(0);
+    for (int i(0); i < 8; ++i)
+    {
+        ret |= uint64_t(static_cast<unsigned char>(str[i])) << (8 * i);
+    }
+    return ret;
+}
+
+static inline void store_word(uint64_t word, char* str)
+{
+    for (int i(0); i < 8; ++i)
+    {
+        str[i] = static_cast<char>(word >> (8 * i));
+    }
+}
+
+static const uint64_t ones(0x0101010101010101ULL);
+
+// Encode four bytes of data into eight lowercase hex digits.
+static inline void hex_encode4(const unsigned char* data, char* str)
+{
+    uint64_t x(uint64_t(data[0]) | uint64_t(data[1]) << 8 |
+               uint64_t(data[2]) << 16 | uint64_t(data[3]) << 24);
+    // Spread each byte into 16 bits and split into nibbles, the high
+    // nibble goes first.
+    x = (x | x << 16) & 0x0000ffff0000ffffULL;
+    x = (x | x << 8) & 0x00ff00ff00ff00ffULL;
+    const uint64_t n(((x >> 4) & 0x000f000f000f000fULL) |
+                     ((x & 0x000f000f000f000fULL) << 8));
+    // Nibbles from 10 to 15 get bit 4 set when added with 6, those
+    // are shifted from '0' + n to 'a' + n - 10.
+    const uint64_t alpha(((n + 6 * ones) >> 4) & ones);
+    store_word(n + '0' * ones + alpha * ('a' - '0' - 10), str);
+}
+
+// Return 0x80 in each byte of word which is within [lo, hi]. All bytes
+// of word must be less than 0x80.
+static inline uint64_t in_range(uint64_t word, unsigned char lo,
+                                unsigned char hi)
+{
+    const uint64_t ge_lo(word + (0x80 - lo) * ones);
+    const uint64_t gt_hi(word + (0x7f - hi) * ones);
+    return (ge_lo & ~gt_hi & 0x80 * ones);
+}
+
+// Decode eight hex digits into four bytes of data. Return false if
+// str contains non-hex characters.
+static inline bool hex_decode8(const char* str, unsigned char* data)
+{
+    const uint64_t c(load_word(str));
+    if (c & 0x80 * ones) return false;
+    const uint64_t digit(in_range(c, '0', '9'));
+    const uint64_t alpha(in_range(c | 0x20 * ones, 'a', 'f'));
+    if ((digit | alpha) != 0x80 * ones) return false;
+    // Low nibble of 'a' and 'A' is 1.
+    uint64_t v((c & 0x0f * ones) + (alpha >> 7) * 9);
+    // Combine pairs of nibbles into bytes and pack the bytes.
+    v = ((v & 0x00ff00ff00ff00ffULL) << 4) | ((v >> 8) & 0x00ff00ff00ff00ffULL);
+    v = (v | v >> 8) & 0x0000ffff0000ffffULL;
+    v = (v | v >> 16);
+    for (int i(0); i < 4; ++i)
+    {
+        data[i] = static_cast<unsigned char>(v >> (8 * i));
+    }
+    return true;
+}
+
+static inline int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Scan UUID in canonical 8-4-4-4-12 format.
+static bool uuid_scan_canonical(const char* str, wsrep::uuid_t* uuid)
+{
+    if (str[8] != '-' || str[13] != '-' || str[18] != '-' || str[23] != '-')
+    {
+        return false;
+    }
+    char hex[32];
+    std::memcpy(hex, str, 8);
+    std::memcpy(hex + 8, str + 9, 4);
+    std::memcpy(hex + 12, str + 14, 4);
+    std::memcpy(hex + 16, str + 19, 4);
+    std::memcpy(hex + 20, str + 24, 12);
+    return (hex_decode8(hex, uuid->data) &&
+            hex_decode8(hex + 8, uuid->data + 4) &&
+            hex_decode8(hex + 16, uuid->data + 8) &&
+            hex_decode8(hex + 24, uuid->data + 12));
+}
 
 int wsrep::uuid_scan (const char* str, size_t str_len, wsrep::uuid_t* uuid)
 {
+    if (str_len >= WSREP_LIB_UUID_STR_LEN && uuid_scan_canonical(str, uuid))
+    {
+        return WSREP_LIB_UUID_STR_LEN;
+    }
+
     unsigned int uuid_len  = 0;
     unsigned int uuid_offt = 0;
 
@@ -42,9 +149,11 @@ int wsrep::uuid_scan (const char* str, size_t str_len, wsrep::uuid_t* uuid)
             continue;
         }
 
-        if (isxdigit(str[uuid_len]) && isxdigit(str[uuid_len + 1])) {
+        const int hi(hex_value(str[uuid_len]));
+        const int lo(hex_value(str[uuid_len + 1]));
+        if (hi >= 0 && lo >= 0) {
             // got hex digit, scan another byte to uuid, increment uuid_offt
-            sscanf (str + uuid_len, "%2hhx", uuid->data + uuid_offt);
+            uuid->data[uuid_offt] = static_cast<unsigned char>(hi << 4 | lo);
             uuid_len  += 2;
             uuid_offt += 1;
             if (sizeof (uuid->data) == uuid_offt)
@@ -62,11 +171,22 @@ int wsrep::uuid_scan (const char* str, size_t str_len, wsrep::uuid_t* uuid)
 int wsrep::uuid_print (const wsrep::uuid_t* uuid, char* str, size_t str_len)
 {
     if (str_len > WSREP_LIB_UUID_STR_LEN) {
-        const unsigned char* u = uuid->data;
-        return snprintf(str, str_len, "%02x%02x%02x%02x-%02x%02x-%02x%02x-"
-                        "%02x%02x-%02x%02x%02x%02x%02x%02x",
-                        u[ 0], u[ 1], u[ 2], u[ 3], u[ 4], u[ 5], u[ 6], u[ 7],
-                        u[ 8], u[ 9], u[10], u[11], u[12], u[13], u[14], u[15]);
+        char hex[32];
+        for (size_t i(0); i < 4; ++i)
+        {
+            hex_encode4(uuid->data + 4 * i, hex + 8 * i);
+        }
+        std::memcpy(str, hex, 8);
+        str[8] = '-';
+        std::memcpy(str + 9, hex + 8, 4);
+        str[13] = '-';
+        std::memcpy(str + 14, hex + 12, 4);
+        str[18] = '-';
+        std::memcpy(str + 19, hex + 16, 4);
+        str[23] = '-';
+        std::memcpy(str + 24, hex + 20, 12);
+        str[WSREP_LIB_UUID_STR_LEN] = '\0';
+        return WSREP_LIB_UUID_STR_LEN;
     }
     else {
         return -EMSGSIZE;
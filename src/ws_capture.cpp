@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/ws_capture.hpp"
+#include "wsrep/exception.hpp"
+#include "wsrep/lock.hpp"
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+namespace
+{
+    const char magic[8] = { 'W', 'S', 'R', 'E', 'P', 'C', 'A', 'P' };
+    const uint32_t version = 1;
+    // Record header following the size field.
+    const size_t header_size = 8 + 8 + 16 + 8 + 16 + 8 + 8 + 8 + 4;
+    // Sanity limit for a record read from file.
+    const uint32_t max_record_size = 1U << 30;
+
+    unsigned char* put(unsigned char* pos, uint64_t val, size_t len)
+    {
+        for (size_t i(0); i < len; ++i)
+        {
+            pos[i] = static_cast<unsigned char>(val >> (8 * i));
+        }
+        return pos + len;
+    }
+
+    unsigned char* put(unsigned char* pos, const wsrep::id& id)
+    {
+        std::memcpy(pos, id.data(), id.size());
+        return pos + id.size();
+    }
+
+    const unsigned char* get(const unsigned char* pos, uint64_t& val,
+                             size_t len)
+    {
+        val = 0;
+        for (size_t i(0); i < len; ++i)
+        {
+            val |= static_cast<uint64_t>(pos[i]) << (8 * i);
+        }
+        return pos + len;
+    }
+
+    const unsigned char* get(const unsigned char* pos, wsrep::id& id)
+    {
+        id = wsrep::id(pos, id.size());
+        return pos + id.size();
+    }
+
+    std::string error_message(const std::string& what,
+                              const std::string& path)
+    {
+        return what + " '" + path + "': " + ::strerror(errno);
+    }
+}
+
+wsrep::ws_capture::ws_capture(const std::string& path)
+    : mutex_()
+    , file_(::fopen(path.c_str(), "wb"))
+    , start_(std::chrono::steady_clock::now())
+    , records_()
+{
+    if (file_ == 0)
+    {
+        throw wsrep::runtime_error(
+            error_message("Failed to open capture file", path));
+    }
+    unsigned char header[sizeof(magic) + 4];
+    std::memcpy(header, magic, sizeof(magic));
+    put(header + sizeof(magic), version, 4);
+    if (::fwrite(header, sizeof(header), 1, file_) != 1)
+    {
+        ::fclose(file_);
+        throw wsrep::runtime_error(
+            error_message("Failed to write capture file", path));
+    }
+}
+
+wsrep::ws_capture::~ws_capture()
+{
+    ::fclose(file_);
+}
+
+int wsrep::ws_capture::record(const wsrep::ws_handle& ws_handle,
+                              const wsrep::ws_meta& ws_meta,
+                              const wsrep::const_buffer& data)
+{
+    if (data.size() > max_record_size - header_size)
+    {
+        return 1;
+    }
+    const std::chrono::steady_clock::time_point now(
+        std::chrono::steady_clock::now());
+    unsigned char header[4 + header_size];
+    unsigned char* pos(header);
+    pos = put(pos, header_size + data.size(), 4);
+    pos = put(pos, static_cast<uint64_t>(
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      now - start_).count()), 8);
+    pos = put(pos, ws_handle.transaction_id().get(), 8);
+    pos = put(pos, ws_meta.group_id());
+    pos = put(pos, static_cast<uint64_t>(ws_meta.seqno().get()), 8);
+    pos = put(pos, ws_meta.server_id());
+    pos = put(pos, ws_meta.transaction_id().get(), 8);
+    pos = put(pos, ws_meta.client_id().get(), 8);
+    pos = put(pos, static_cast<uint64_t>(ws_meta.depends_on().get()), 8);
+    pos = put(pos, static_cast<uint32_t>(ws_meta.flags()), 4);
+    assert(pos == header + sizeof(header));
+
+    wsrep::unique_lock<wsrep::mutex> lock(mutex_);
+    if (::fwrite(header, sizeof(header), 1, file_) != 1 ||
+        (data.size() && ::fwrite(data.data(), data.size(), 1, file_) != 1))
+    {
+        return 1;
+    }
+    ++records_;
+    return 0;
+}
+
+int wsrep::ws_capture::flush()
+{
+    wsrep::unique_lock<wsrep::mutex> lock(mutex_);
+    return (::fflush(file_) == 0 ? 0 : 1);
+}
+
+size_t wsrep::ws_capture::records() const
+{
+    wsrep::unique_lock<wsrep::mutex> lock(mutex_);
+    return records_;
+}
+
+wsrep::ws_capture_reader::ws_capture_reader(const std::string& path)
+    : file_(::fopen(path.c_str(), "rb"))
+    , buf_()
+{
+    if (file_ == 0)
+    {
+        throw wsrep::runtime_error(
+            error_message("Failed to open capture file", path));
+    }
+    unsigned char header[sizeof(magic) + 4] = { 0 };
+    uint64_t file_version(0);
+    if (::fread(header, sizeof(header), 1, file_) == 1)
+    {
+        get(header + sizeof(magic), file_version, 4);
+    }
+    if (std::memcmp(header, magic, sizeof(magic)) || file_version != version)
+    {
+        ::fclose(file_);
+        throw wsrep::runtime_error("Invalid capture file '" + path + "'");
+    }
+}
+
+wsrep::ws_capture_reader::~ws_capture_reader()
+{
+    ::fclose(file_);
+}
+
+int wsrep::ws_capture_reader::read(record& rec)
+{
+    unsigned char size_buf[4];
+    const size_t n(::fread(size_buf, 1, sizeof(size_buf), file_));
+    if (n == 0 && ::feof(file_))
+    {
+        return 0;
+    }
+    uint64_t size;
+    get(size_buf, size, 4);
+    if (n != sizeof(size_buf) || size < header_size ||
+        size > max_record_size)
+    {
+        return -1;
+    }
+    buf_.resize(size);
+    if (::fread(buf_.data(), size, 1, file_) != 1)
+    {
+        return -1;
+    }
+
+    const unsigned char* pos(buf_.data());
+    uint64_t timestamp, handle_trx_id, seqno, trx_id, client_id, depends_on,
+        flags;
+    wsrep::id group_id, server_id;
+    pos = get(pos, timestamp, 8);
+    pos = get(pos, handle_trx_id, 8);
+    pos = get(pos, group_id);
+    pos = get(pos, seqno, 8);
+    pos = get(pos, server_id);
+    pos = get(pos, trx_id, 8);
+    pos = get(pos, client_id, 8);
+    pos = get(pos, depends_on, 8);
+    pos = get(pos, flags, 4);
+    assert(pos == buf_.data() + header_size);
+
+    rec.timestamp = std::chrono::nanoseconds(
+        static_cast<std::chrono::nanoseconds::rep>(timestamp));
+    rec.ws_handle = wsrep::ws_handle(wsrep::transaction_id(handle_trx_id));
+    rec.ws_meta = wsrep::ws_meta(
+        wsrep::gtid(group_id,
+                    wsrep::seqno(static_cast<long long>(seqno))),
+        wsrep::stid(server_id,
+                    wsrep::transaction_id(trx_id),
+                    wsrep::client_id(client_id)),
+        wsrep::seqno(static_cast<long long>(depends_on)),
+        static_cast<int>(flags));
+    rec.data.assign(reinterpret_cast<const char*>(pos),
+                    reinterpret_cast<const char*>(buf_.data() + size));
+    return 1;
+}
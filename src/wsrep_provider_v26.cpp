@@ -42,6 +42,7 @@
 #include <dlfcn.h>
 #include <cassert>
 #include <climits>
+#include <memory>
 
 #include <iostream>
 #include <sstream>
@@ -693,6 +694,89 @@ namespace
     {
         wsrep::connection_monitor_service_v1_deinit(dlh);
     }
+
+    /*
+     * Key array marshalled into native wsrep_key_t array. Keys and
+     * key parts of arrays up to key_array::inline_capacity keys
+     * are stored inline, larger arrays are stored into a single heap
+     * allocated buffer.
+     */
+    class native_key_array
+    {
+    public:
+        native_key_array(const wsrep::key_array& keys)
+            : heap_()
+            , keys_(inline_keys_)
+            , size_(keys.size())
+        {
+            wsrep_buf_t* parts(inline_parts_);
+            if (size_ > wsrep::key_array::inline_capacity)
+            {
+                heap_.reset(new char[size_ * (sizeof(wsrep_key_t) +
+                                              3 * sizeof(wsrep_buf_t))]);
+                keys_ = reinterpret_cast<wsrep_key_t*>(heap_.get());
+                parts = reinterpret_cast<wsrep_buf_t*>(keys_ + size_);
+            }
+            for (size_t i(0); i < size_; ++i)
+            {
+                const wsrep::key& key(keys[i]);
+                assert(key.size() <= 3);
+                for (size_t kp(0); kp < key.size(); ++kp)
+                {
+                    parts[kp].ptr = key.key_parts()[kp].data();
+                    parts[kp].len = key.key_parts()[kp].size();
+                }
+                keys_[i].key_parts = parts;
+                keys_[i].key_parts_num = key.size();
+                parts += key.size();
+            }
+        }
+
+        const wsrep_key_t* data() const { return keys_; }
+        size_t size() const { return size_; }
+    private:
+        native_key_array(const native_key_array&);
+        native_key_array& operator=(const native_key_array&);
+
+        std::unique_ptr<char[]> heap_;
+        wsrep_key_t* keys_;
+        size_t size_;
+        wsrep_key_t inline_keys_[wsrep::key_array::inline_capacity];
+        wsrep_buf_t inline_parts_[3 * wsrep::key_array::inline_capacity];
+    };
+
+    int append_key(struct wsrep_st* wsrep, wsrep::ws_handle& ws_handle,
+                   const wsrep::key& key, bool copy)
+    {
+        if (key.size() > 3)
+        {
+            assert(0);
+            return 1;
+        }
+        wsrep_buf_t key_parts[3];
+        for (size_t i(0); i < key.size(); ++i)
+        {
+            key_parts[i].ptr = key.key_parts()[i].ptr();
+            key_parts[i].len = key.key_parts()[i].size();
+        }
+        wsrep_key_t wsrep_key = {key_parts, key.size()};
+        mutable_ws_handle mwsh(ws_handle);
+        return (wsrep->append_key(
+                    wsrep, mwsh.native(),
+                    &wsrep_key, 1, map_key_type(key.type()), copy)
+                != WSREP_OK);
+    }
+
+    enum wsrep::provider::status append_data(
+        struct wsrep_st* wsrep, wsrep::ws_handle& ws_handle,
+        const wsrep::const_buffer& data, bool copy)
+    {
+        const wsrep_buf_t wsrep_buf = {data.data(), data.size()};
+        mutable_ws_handle mwsh(ws_handle);
+        return map_return_value(
+            wsrep->append_data(wsrep, mwsh.native(), &wsrep_buf,
+                               1, WSREP_DATA_ORDERED, copy));
+    }
 }
 
 
@@ -925,34 +1009,27 @@ wsrep::wsrep_provider_v26::assign_read_view(wsrep::ws_handle& ws_handle,
 int wsrep::wsrep_provider_v26::append_key(wsrep::ws_handle& ws_handle,
                                           const wsrep::key& key)
 {
-    if (key.size() > 3)
-    {
-        assert(0);
-        return 1;
-    }
-    wsrep_buf_t key_parts[3];
-    for (size_t i(0); i < key.size(); ++i)
-    {
-        key_parts[i].ptr = key.key_parts()[i].ptr();
-        key_parts[i].len = key.key_parts()[i].size();
-    }
-    wsrep_key_t wsrep_key = {key_parts, key.size()};
-    mutable_ws_handle mwsh(ws_handle);
-    return (wsrep_->append_key(
-                wsrep_, mwsh.native(),
-                &wsrep_key, 1, map_key_type(key.type()), true)
-            != WSREP_OK);
+    return ::append_key(wsrep_, ws_handle, key, true);
+}
+
+int wsrep::wsrep_provider_v26::append_key_nocopy(wsrep::ws_handle& ws_handle,
+                                                 const wsrep::key& key)
+{
+    return ::append_key(wsrep_, ws_handle, key, false);
 }
 
 enum wsrep::provider::status
 wsrep::wsrep_provider_v26::append_data(wsrep::ws_handle& ws_handle,
                                        const wsrep::const_buffer& data)
 {
-    const wsrep_buf_t wsrep_buf = {data.data(), data.size()};
-    mutable_ws_handle mwsh(ws_handle);
-    return map_return_value(
-        wsrep_->append_data(wsrep_, mwsh.native(), &wsrep_buf,
-                            1, WSREP_DATA_ORDERED, true));
+    return ::append_data(wsrep_, ws_handle, data, true);
+}
+
+enum wsrep::provider::status
+wsrep::wsrep_provider_v26::append_data_nocopy(wsrep::ws_handle& ws_handle,
+                                              const wsrep::const_buffer& data)
+{
+    return ::append_data(wsrep_, ws_handle, data, false);
 }
 
 enum wsrep::provider::status
@@ -1050,24 +1127,8 @@ wsrep::wsrep_provider_v26::enter_toi(
     int flags)
 {
     mutable_ws_meta mmeta(ws_meta, flags);
-    std::vector<std::vector<wsrep_buf_t> > key_parts;
-    std::vector<wsrep_key_t> wsrep_keys;
+    native_key_array wsrep_keys(keys);
     wsrep_buf_t wsrep_buf = {buffer.data(), buffer.size()};
-    for (size_t i(0); i < keys.size(); ++i)
-    {
-        key_parts.push_back(std::vector<wsrep_buf_t>());
-        for (size_t kp(0); kp < keys[i].size(); ++kp)
-        {
-            wsrep_buf_t buf = {keys[i].key_parts()[kp].data(),
-                               keys[i].key_parts()[kp].size()};
-            key_parts[i].push_back(buf);
-        }
-    }
-    for (size_t i(0); i < key_parts.size(); ++i)
-    {
-        wsrep_key_t key = {key_parts[i].data(), key_parts[i].size()};
-        wsrep_keys.push_back(key);
-    }
     return map_return_value(wsrep_->to_execute_start(
                                 wsrep_,
                                 client_id.get(),
@@ -56,6 +56,11 @@ namespace wsrep
         enum wsrep::provider::status
         append_data(wsrep::ws_handle&, const wsrep::const_buffer&)
             WSREP_OVERRIDE;
+        int append_key_nocopy(wsrep::ws_handle&, const wsrep::key&)
+            WSREP_OVERRIDE;
+        enum wsrep::provider::status
+        append_data_nocopy(wsrep::ws_handle&, const wsrep::const_buffer&)
+            WSREP_OVERRIDE;
         enum wsrep::provider::status
         certify(wsrep::client_id, wsrep::ws_handle&,
                 int,
@@ -18,14 +18,67 @@
  */
 
 #include "wsrep/xid.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
 #include <ostream>
 
+const long wsrep::xid::max_part_len;
+
+namespace
+{
+    const uint64_t fnv64_offset = 14695981039346656037ULL;
+    const uint64_t fnv64_prime = 1099511628211ULL;
+}
+
+size_t wsrep::xid::hash() const
+{
+    // FNV-1a applied to 64 bit words instead of bytes, followed by
+    // a final mix so that all input bits affect the low bits of the
+    // result. Only the meaningful part of data_ is hashed, as in
+    // operator==().
+    uint64_t ret(fnv64_offset);
+    ret = (ret ^ static_cast<uint64_t>(format_id_)) * fnv64_prime;
+    ret = (ret ^ static_cast<uint64_t>(gtrid_len_)) * fnv64_prime;
+    ret = (ret ^ static_cast<uint64_t>(bqual_len_)) * fnv64_prime;
+    const size_t len(data_size());
+    size_t i(0);
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, data_ + i, sizeof(word));
+        ret = (ret ^ word) * fnv64_prime;
+    }
+    for (; i < len; ++i)
+    {
+        ret = (ret ^ static_cast<unsigned char>(data_[i])) * fnv64_prime;
+    }
+    ret ^= ret >> 32;
+    ret *= 0xd6e8feb86659fd93ULL;
+    ret ^= ret >> 32;
+    return static_cast<size_t>(ret);
+}
+
 std::string wsrep::to_string(const wsrep::xid& xid)
 {
-    return std::string(xid.data_.data(), xid.data_.size());
+    return std::string(xid.data_, xid.data_size());
+}
+
+ssize_t wsrep::print_to_c_str(const wsrep::xid& xid, char* buf,
+                              size_t buf_len)
+{
+    const size_t size(xid.data_size());
+    if (size > buf_len)
+    {
+        return -ENOBUFS;
+    }
+    std::memcpy(buf, xid.data_, size);
+    return static_cast<ssize_t>(size);
 }
 
 std::ostream& wsrep::operator<<(std::ostream& os, const wsrep::xid& xid)
 {
-    return os << to_string(xid);
+    return os.write(xid.data_,
+                    static_cast<std::streamsize>(xid.data_size()));
 }
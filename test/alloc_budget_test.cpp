@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Allocation budget tests. These are compiled only with
+ * WSREP_LIB_WITH_ALLOC_ACCOUNTING, allocations are recorded by
+ * the operator new replacement in alloc_hooks.cpp. The budgets are upper limits
+ * for the number of allocations done in each transaction phase
+ * with the mock provider and services. If a change makes the test
+ * fail, either fix the regression or, if the new allocation is
+ * justified, raise the budget.
+ */
+
+#include "wsrep/alloc_stats.hpp"
+
+#include "client_state_fixture.hpp"
+#include "mock_high_priority_service.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+    void require_budget(enum wsrep::alloc_stats::phase phase,
+                        unsigned long long budget)
+    {
+        const unsigned long long allocations(
+            wsrep::alloc_stats::get(phase).allocations);
+        BOOST_CHECK_MESSAGE(allocations <= budget,
+                            "Phase " << wsrep::to_string(phase)
+                            << " allocations " << allocations
+                            << " exceed budget " << budget);
+    }
+
+    void require_total_budget(unsigned long long budget)
+    {
+        const unsigned long long allocations(
+            wsrep::alloc_stats::total().allocations);
+        BOOST_CHECK_MESSAGE(allocations <= budget,
+                            "Total allocations " << allocations
+                            << " exceed budget " << budget);
+    }
+
+    // Run autocommit transaction with one key and data buffer.
+    void run_autocommit(wsrep::mock_client& cc, wsrep::transaction_id id,
+                        bool two_phase)
+    {
+        const char row[] = "row";
+        wsrep::key key(wsrep::key::exclusive);
+        key.append_key_part("db", 2);
+        key.append_key_part("table", 5);
+        key.append_key_part(row, sizeof(row));
+        BOOST_REQUIRE(cc.start_transaction(id) == 0);
+        BOOST_REQUIRE(cc.append_key(key) == 0);
+        BOOST_REQUIRE(cc.append_data(wsrep::const_buffer(row, sizeof(row)))
+                      == 0);
+        if (two_phase)
+        {
+            BOOST_REQUIRE(cc.before_prepare() == 0);
+            BOOST_REQUIRE(cc.after_prepare() == 0);
+        }
+        BOOST_REQUIRE(cc.before_commit() == 0);
+        BOOST_REQUIRE(cc.ordered_commit() == 0);
+        BOOST_REQUIRE(cc.after_commit() == 0);
+        BOOST_REQUIRE(cc.after_statement() == 0);
+        BOOST_REQUIRE(cc.transaction().state() ==
+                      wsrep::transaction::s_committed);
+        BOOST_REQUIRE(cc.before_statement() == 0);
+    }
+
+    struct applying_fixture
+    {
+        applying_fixture()
+            : server_service(&ss)
+            , ss("s1", wsrep::server_state::rm_sync, server_service)
+            , cc(ss, wsrep::client_id(1),
+                 wsrep::client_state::m_high_priority)
+            , hps(ss, &cc, false)
+        {
+            ss.mock_connect();
+            cc.open(cc.id());
+            BOOST_REQUIRE(cc.before_command() == 0);
+        }
+
+        void apply(long long seqno)
+        {
+            const char data[] = "data";
+            const wsrep::transaction_id id(
+                static_cast<unsigned long long>(seqno));
+            const wsrep::ws_handle ws_handle(id, (void*)1);
+            const wsrep::ws_meta ws_meta(
+                wsrep::gtid(wsrep::id("1"), wsrep::seqno(seqno)),
+                wsrep::stid(wsrep::id("2"), id, wsrep::client_id(1)),
+                wsrep::seqno(seqno - 1),
+                wsrep::provider::flag::start_transaction |
+                wsrep::provider::flag::commit);
+            BOOST_REQUIRE(ss.on_apply(hps, ws_handle, ws_meta,
+                                      wsrep::const_buffer(data, sizeof(data)))
+                          == 0);
+            BOOST_REQUIRE(cc.transaction().state() ==
+                          wsrep::transaction::s_committed);
+        }
+
+        wsrep::mock_server_service server_service;
+        wsrep::mock_server_state ss;
+        wsrep::mock_client cc;
+        wsrep::mock_high_priority_service hps;
+    };
+}
+
+BOOST_AUTO_TEST_CASE(alloc_stats_enabled)
+{
+    BOOST_REQUIRE(wsrep::alloc_stats::enabled());
+    BOOST_REQUIRE(wsrep::alloc_stats::current() == wsrep::alloc_stats::p_none);
+    wsrep::alloc_stats::reset();
+    {
+        wsrep::alloc_stats::scope outer(wsrep::alloc_stats::p_commit);
+        {
+            wsrep::alloc_stats::scope inner(wsrep::alloc_stats::p_certify);
+            delete new int(1);
+        }
+        delete new int(2);
+        delete new int(3);
+    }
+    BOOST_REQUIRE(wsrep::alloc_stats::current() == wsrep::alloc_stats::p_none);
+    BOOST_REQUIRE(
+        wsrep::alloc_stats::get(wsrep::alloc_stats::p_certify).allocations
+        == 1);
+    BOOST_REQUIRE(
+        wsrep::alloc_stats::get(wsrep::alloc_stats::p_commit).allocations
+        == 2);
+    BOOST_REQUIRE(wsrep::alloc_stats::total().allocations == 3);
+    BOOST_REQUIRE(wsrep::alloc_stats::total().bytes == 3 * sizeof(int));
+}
+
+//
+// Non-streaming autocommit transaction with one key. The first
+// transaction is run to warm up the client and the mock services,
+// the budgets are checked for the second one.
+//
+BOOST_FIXTURE_TEST_CASE(alloc_budget_1pc_autocommit,
+                        replicating_client_fixture_sync_rm)
+{
+    run_autocommit(cc, wsrep::transaction_id(1), false);
+    wsrep::alloc_stats::reset();
+    run_autocommit(cc, wsrep::transaction_id(2), false);
+    require_budget(wsrep::alloc_stats::p_start, 0);
+    // Key is recorded into sr_key_set also for non-streaming
+    // transactions.
+    require_budget(wsrep::alloc_stats::p_append, 2);
+    // Debug log formatting in mock_provider::certify().
+    require_budget(wsrep::alloc_stats::p_certify, 2);
+    require_budget(wsrep::alloc_stats::p_commit, 0);
+    require_budget(wsrep::alloc_stats::p_cleanup, 0);
+    require_total_budget(4);
+}
+
+BOOST_FIXTURE_TEST_CASE(alloc_budget_2pc_autocommit,
+                        replicating_client_fixture_2pc)
+{
+    run_autocommit(cc, wsrep::transaction_id(1), true);
+    wsrep::alloc_stats::reset();
+    run_autocommit(cc, wsrep::transaction_id(2), true);
+    require_budget(wsrep::alloc_stats::p_start, 0);
+    require_budget(wsrep::alloc_stats::p_append, 2);
+    require_budget(wsrep::alloc_stats::p_certify, 2);
+    require_budget(wsrep::alloc_stats::p_commit, 0);
+    require_budget(wsrep::alloc_stats::p_cleanup, 0);
+    require_total_budget(4);
+}
+
+//
+// Applying a non-streaming write set.
+//
+BOOST_FIXTURE_TEST_CASE(alloc_budget_apply, applying_fixture)
+{
+    apply(1);
+    wsrep::alloc_stats::reset();
+    apply(2);
+    require_budget(wsrep::alloc_stats::p_apply, 0);
+    require_budget(wsrep::alloc_stats::p_start, 0);
+    require_budget(wsrep::alloc_stats::p_commit, 0);
+    require_budget(wsrep::alloc_stats::p_cleanup, 0);
+    require_total_budget(0);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Global operator new replacement which records allocations into
+ * wsrep::alloc_stats. Compiled only with WSREP_LIB_WITH_ALLOC_ACCOUNTING.
+ * Kept in a separate translation unit so that the replacements are
+ * not inlined into the tests, where the compiler would see memory
+ * from operator new released with free().
+ */
+
+#include "wsrep/alloc_stats.hpp"
+
+#include <cstdlib>
+#include <new>
+
+void* operator new(std::size_t size)
+{
+    wsrep::alloc_stats::record(size);
+    void* ret(std::malloc(size ? size : 1));
+    if (ret == 0) throw std::bad_alloc();
+    return ret;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) throw()
+{
+    wsrep::alloc_stats::record(size);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) throw()
+{
+    std::free(ptr);
+}
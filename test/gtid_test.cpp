@@ -20,6 +20,9 @@
 #include "wsrep/gtid.hpp"
 #include <boost/test/unit_test.hpp>
 
+#include <cerrno>
+#include <sstream>
+
 BOOST_AUTO_TEST_CASE(gtid_test_scan_from_string_uuid)
 {
     std::string gtid_str("6a20d44a-6e17-11e8-b1e2-9061aec0cdad:123456");
@@ -60,3 +63,43 @@ BOOST_AUTO_TEST_CASE(gtid_test_scan_from_string_seqno_out_of_range)
     BOOST_REQUIRE_MESSAGE(ret == -EINVAL,
                           "Expected " << -EINVAL << " got " << ret);
 }
+
+BOOST_AUTO_TEST_CASE(gtid_test_print_to_c_str)
+{
+    const wsrep::gtid gtid(wsrep::id("6a20d44a-6e17-11e8-b1e2-9061aec0cdad"),
+                           wsrep::seqno(-9223372036854775807LL - 1));
+    char buf[WSREP_LIB_GTID_C_STR_LEN];
+    BOOST_REQUIRE(wsrep::print_to_c_str(gtid, buf, sizeof(buf)) ==
+                  WSREP_LIB_GTID_C_STR_LEN);
+    BOOST_REQUIRE_EQUAL(std::string(buf, sizeof(buf)),
+                        "6a20d44a-6e17-11e8-b1e2-9061aec0cdad:"
+                        "-9223372036854775808");
+    BOOST_REQUIRE(wsrep::print_to_c_str(gtid, buf, sizeof(buf) - 1) ==
+                  -ENOBUFS);
+    BOOST_REQUIRE(wsrep::print_to_c_str(gtid, buf, 36) == -ENOBUFS);
+    wsrep::gtid scanned;
+    BOOST_REQUIRE(wsrep::scan_from_c_str(buf, sizeof(buf), scanned) ==
+                  WSREP_LIB_GTID_C_STR_LEN);
+    BOOST_REQUIRE(scanned == gtid);
+
+    std::ostringstream os;
+    os << wsrep::gtid(wsrep::id("node1"), wsrep::seqno(0));
+    BOOST_REQUIRE_EQUAL(os.str(), "node1:0");
+}
+
+BOOST_AUTO_TEST_CASE(gtid_test_scan_from_c_str_partial)
+{
+    // Scanning stops after seqno and returns the position.
+    std::string gtid_str("6a20d44a-6e17-11e8-b1e2-9061aec0cdad: +42,rest");
+    wsrep::gtid gtid;
+    BOOST_REQUIRE(wsrep::scan_from_c_str(
+                      gtid_str.c_str(), gtid_str.size(), gtid) == 41);
+    BOOST_REQUIRE(gtid.seqno().get() == 42);
+
+    gtid_str = "6a20d44a-6e17-11e8-b1e2-9061aec0cdad:";
+    BOOST_REQUIRE(wsrep::scan_from_c_str(
+                      gtid_str.c_str(), gtid_str.size(), gtid) == -EINVAL);
+    gtid_str = "6a20d44a-6e17-11e8-b1e2-9061aec0cdad";
+    BOOST_REQUIRE(wsrep::scan_from_c_str(
+                      gtid_str.c_str(), gtid_str.size(), gtid) == -EINVAL);
+}
@@ -20,6 +20,7 @@
 #include "wsrep/id.hpp"
 #include <boost/test/unit_test.hpp>
 
+#include <cerrno>
 #include <sstream>
 
 namespace
@@ -113,3 +114,47 @@ BOOST_AUTO_TEST_CASE(id_test_null)
     os << id;
     BOOST_REQUIRE_EQUAL(os.str(), "00000000-0000-0000-0000-000000000000");
 }
+
+BOOST_AUTO_TEST_CASE(id_test_print_scan_c_str)
+{
+    // Hex digits of all byte values round trip.
+    for (int i(0); i < 256; i += 16)
+    {
+        unsigned char data[16];
+        for (int j(0); j < 16; ++j) data[j] = static_cast<unsigned char>(i + j);
+        wsrep::id id(data, sizeof(data));
+        std::ostringstream os;
+        os << id;
+        char buf[WSREP_LIB_ID_C_STR_LEN];
+        BOOST_REQUIRE(wsrep::print_to_c_str(id, buf, sizeof(buf)) ==
+                      WSREP_LIB_ID_C_STR_LEN);
+        BOOST_REQUIRE_EQUAL(std::string(buf, sizeof(buf)), os.str());
+        BOOST_REQUIRE(wsrep::print_to_c_str(id, buf, sizeof(buf) - 1) ==
+                      -ENOBUFS);
+        wsrep::id scanned;
+        BOOST_REQUIRE(wsrep::scan_from_c_str(buf, sizeof(buf), scanned) ==
+                      WSREP_LIB_ID_C_STR_LEN);
+        BOOST_REQUIRE(scanned == id);
+    }
+
+    // Uppercase hex digits are accepted.
+    const std::string upper("6A20D44A-6E17-11E8-B1E2-9061AEC0CDAD");
+    wsrep::id id;
+    BOOST_REQUIRE(wsrep::scan_from_c_str(upper.c_str(), upper.size(), id) ==
+                  ssize_t(upper.size()));
+    BOOST_REQUIRE(id == wsrep::id("6a20d44a-6e17-11e8-b1e2-9061aec0cdad"));
+    BOOST_REQUIRE_EQUAL(id.to_string(), "6a20d44a-6e17-11e8-b1e2-9061aec0cdad");
+
+    // Non-hex character in UUID makes the string longer than 16 bytes.
+    const std::string invalid("6a20d44a-6e17-11e8-b1e2-9061aec0cdag");
+    BOOST_REQUIRE(wsrep::scan_from_c_str(invalid.c_str(), invalid.size(), id)
+                  == -EINVAL);
+
+    const std::string str("node1");
+    BOOST_REQUIRE(wsrep::scan_from_c_str(str.c_str(), str.size(), id) == 5);
+    char buf[5];
+    BOOST_REQUIRE(wsrep::print_to_c_str(id, buf, sizeof(buf)) == 5);
+    BOOST_REQUIRE_EQUAL(std::string(buf, sizeof(buf)), str);
+    BOOST_REQUIRE(wsrep::print_to_c_str(id, buf, 4) == -ENOBUFS);
+    BOOST_REQUIRE_EQUAL(id.to_string(), str);
+}
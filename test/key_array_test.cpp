@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/key.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+    wsrep::key make_key(const size_t& part)
+    {
+        wsrep::key key(wsrep::key::exclusive);
+        key.append_key_part(&part, sizeof(part));
+        return key;
+    }
+
+    size_t key_part(const wsrep::key& key)
+    {
+        return *static_cast<const size_t*>(key.key_parts()[0].ptr());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(key_array_inline)
+{
+    const size_t parts[] = { 0, 1, 2, 3 };
+    wsrep::key_array keys{make_key(parts[0]), make_key(parts[1])};
+    BOOST_REQUIRE(keys.size() == 2);
+    keys.push_back(make_key(parts[2]));
+    keys.push_back(make_key(parts[3]));
+    BOOST_REQUIRE(keys.size() == wsrep::key_array::inline_capacity);
+    BOOST_REQUIRE(keys.capacity() == wsrep::key_array::inline_capacity);
+    size_t expected(0);
+    for (auto i(keys.begin()); i != keys.end(); ++i, ++expected)
+    {
+        BOOST_REQUIRE(key_part(*i) == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(key_array_heap)
+{
+    size_t parts[32];
+    wsrep::key_array keys;
+    for (size_t i(0); i < 32; ++i)
+    {
+        parts[i] = i;
+        keys.push_back(make_key(parts[i]));
+    }
+    BOOST_REQUIRE(keys.size() == 32);
+    BOOST_REQUIRE(keys.capacity() >= 32);
+    // Push back an element of the array itself while growing.
+    keys.push_back(keys[0]);
+    BOOST_REQUIRE(key_part(keys.back()) == 0);
+
+    wsrep::key_array copy(keys);
+    BOOST_REQUIRE(copy.size() == keys.size());
+    for (size_t i(0); i < 32; ++i)
+    {
+        BOOST_REQUIRE(key_part(copy[i]) == i);
+    }
+    wsrep::key_array small{make_key(parts[5])};
+    copy = small;
+    BOOST_REQUIRE(copy.size() == 1);
+    BOOST_REQUIRE(key_part(copy.front()) == 5);
+    keys.clear();
+    BOOST_REQUIRE(keys.empty());
+}
+
+BOOST_AUTO_TEST_CASE(key_array_move)
+{
+    size_t parts[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    wsrep::key_array heap;
+    for (size_t i(0); i < 8; ++i) heap.push_back(make_key(parts[i]));
+    const wsrep::key* data(heap.data());
+    // Heap storage is taken over without copying.
+    wsrep::key_array moved(std::move(heap));
+    BOOST_REQUIRE(moved.data() == data);
+    BOOST_REQUIRE(moved.size() == 8);
+    BOOST_REQUIRE(heap.empty());
+    BOOST_REQUIRE(heap.capacity() == wsrep::key_array::inline_capacity);
+
+    wsrep::key_array small{make_key(parts[1]), make_key(parts[2])};
+    moved = std::move(small);
+    BOOST_REQUIRE(moved.size() == 2);
+    BOOST_REQUIRE(key_part(moved[1]) == 2);
+    BOOST_REQUIRE(small.empty());
+
+    wsrep::key_array other{make_key(parts[7])};
+    swap(moved, other);
+    BOOST_REQUIRE(moved.size() == 1 && key_part(moved[0]) == 7);
+    BOOST_REQUIRE(other.size() == 2 && key_part(other[0]) == 1);
+}
+
+BOOST_AUTO_TEST_CASE(key_array_insert_erase)
+{
+    size_t parts[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    wsrep::key_array keys{make_key(parts[0]), make_key(parts[3])};
+    keys.insert(keys.begin() + 1, make_key(parts[2]));
+    keys.insert(keys.begin() + 1, make_key(parts[1]));
+    keys.insert(keys.end(), {make_key(parts[4]), make_key(parts[5])});
+    keys.emplace_back(make_key(parts[6]));
+    // Insert range from the array itself while growing.
+    keys.insert(keys.begin(), keys.begin(), keys.begin() + 2);
+    BOOST_REQUIRE(keys.size() == 9);
+    const size_t expected[] = { 0, 1, 0, 1, 2, 3, 4, 5, 6 };
+    for (size_t i(0); i < keys.size(); ++i)
+    {
+        BOOST_REQUIRE(key_part(keys.at(i)) == expected[i]);
+    }
+    BOOST_REQUIRE_THROW(keys.at(9), std::out_of_range);
+
+    auto i(keys.erase(keys.begin(), keys.begin() + 2));
+    BOOST_REQUIRE(i == keys.begin());
+    i = keys.erase(keys.begin() + 3);
+    BOOST_REQUIRE(key_part(*i) == 4);
+    BOOST_REQUIRE(keys.size() == 6);
+    keys.resize(8, make_key(parts[7]));
+    BOOST_REQUIRE(keys.size() == 8 && key_part(keys.back()) == 7);
+    keys.resize(3, make_key(parts[7]));
+    BOOST_REQUIRE(keys.size() == 3 && key_part(keys.back()) == 2);
+    keys.shrink_to_fit();
+    BOOST_REQUIRE(keys.capacity() == wsrep::key_array::inline_capacity);
+    BOOST_REQUIRE(key_part(*keys.rbegin()) == 2);
+}
+
+BOOST_AUTO_TEST_CASE(key_array_compare)
+{
+    size_t parts[2] = { 0, 1 };
+    const size_t same(1);
+    wsrep::key_array a{make_key(parts[0]), make_key(parts[1])};
+    wsrep::key_array b{make_key(parts[0]), make_key(same)};
+    BOOST_REQUIRE(a == b);
+    b.assign(2, make_key(parts[0]));
+    BOOST_REQUIRE(a != b);
+    b = a;
+    b[1] = wsrep::key(wsrep::key::shared);
+    BOOST_REQUIRE(a != b);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/key_filter.hpp"
+#include "wsrep/key.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+
+namespace
+{
+    wsrep::key make_key(enum wsrep::key::type type,
+                        const char* p1, const char* p2)
+    {
+        wsrep::key key(type);
+        key.append_key_part(p1, strlen(p1));
+        key.append_key_part(p2, strlen(p2));
+        return key;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(key_hash)
+{
+    wsrep::key k1(make_key(wsrep::key::shared, "a", "bc"));
+    wsrep::key k2(make_key(wsrep::key::exclusive, "a", "bc"));
+    wsrep::key k3(make_key(wsrep::key::shared, "ab", "c"));
+    BOOST_REQUIRE(k1.has_hash() == false);
+    BOOST_REQUIRE(k1.hash() == k2.hash());
+    BOOST_REQUIRE(k1.hash() != k3.hash());
+    k3.hash(1);
+    BOOST_REQUIRE(k3.has_hash());
+    BOOST_REQUIRE(k3.hash() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(key_filter_duplicate)
+{
+    wsrep::key_filter filter;
+    BOOST_REQUIRE(filter.empty());
+    BOOST_REQUIRE(filter.insert(make_key(wsrep::key::exclusive, "a", "b")) ==
+                  wsrep::key_filter::inserted);
+    BOOST_REQUIRE(filter.insert(make_key(wsrep::key::exclusive, "a", "b")) ==
+                  wsrep::key_filter::duplicate);
+    BOOST_REQUIRE(filter.insert(make_key(wsrep::key::exclusive, "a", "c")) ==
+                  wsrep::key_filter::inserted);
+    BOOST_REQUIRE(filter.size() == 2);
+    BOOST_REQUIRE(filter.duplicate_hits() == 1);
+    BOOST_REQUIRE(filter.hits() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(key_filter_subsume)
+{
+    wsrep::key_filter filter;
+    BOOST_REQUIRE(filter.insert(make_key(wsrep::key::shared, "a", "b")) ==
+                  wsrep::key_filter::inserted);
+    BOOST_REQUIRE(filter.insert(make_key(wsrep::key::exclusive, "a", "b")) ==
+                  wsrep::key_filter::upgraded);
+    BOOST_REQUIRE(filter.insert(make_key(wsrep::key::shared, "a", "b")) ==
+                  wsrep::key_filter::subsumed);
+    BOOST_REQUIRE(filter.insert(make_key(wsrep::key::update, "a", "b")) ==
+                  wsrep::key_filter::subsumed);
+    BOOST_REQUIRE(filter.size() == 1);
+    BOOST_REQUIRE(filter.subsumed_hits() == 2);
+}
+
+BOOST_AUTO_TEST_CASE(key_filter_hash_collision)
+{
+    wsrep::key_filter filter;
+    wsrep::key k1(make_key(wsrep::key::shared, "a", "b"));
+    wsrep::key k2(make_key(wsrep::key::shared, "a", "c"));
+    k1.hash(1);
+    k2.hash(1);
+    BOOST_REQUIRE(filter.insert(k1) == wsrep::key_filter::inserted);
+    BOOST_REQUIRE(filter.insert(k2) == wsrep::key_filter::inserted);
+    BOOST_REQUIRE(filter.insert(k1) == wsrep::key_filter::duplicate);
+    BOOST_REQUIRE(filter.insert(k2) == wsrep::key_filter::duplicate);
+}
+
+BOOST_AUTO_TEST_CASE(key_filter_grow_and_clear)
+{
+    wsrep::key_filter filter;
+    for (int i(0); i < 5000; ++i)
+    {
+        wsrep::key key(wsrep::key::exclusive);
+        key.append_key_part("t", 1);
+        key.append_key_part(&i, sizeof(i));
+        BOOST_REQUIRE(filter.insert(key) == wsrep::key_filter::inserted);
+    }
+    for (int i(0); i < 5000; ++i)
+    {
+        wsrep::key key(wsrep::key::exclusive);
+        key.append_key_part("t", 1);
+        key.append_key_part(&i, sizeof(i));
+        BOOST_REQUIRE(filter.insert(key) == wsrep::key_filter::duplicate);
+    }
+    BOOST_REQUIRE(filter.size() == 5000);
+    filter.clear();
+    BOOST_REQUIRE(filter.empty());
+    BOOST_REQUIRE(filter.hits() == 5000);
+    BOOST_REQUIRE(filter.insert(make_key(wsrep::key::exclusive, "a", "b")) ==
+                  wsrep::key_filter::inserted);
+}
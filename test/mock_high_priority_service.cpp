@@ -119,6 +119,7 @@ int wsrep::mock_high_priority_service::apply_toi(const wsrep::ws_meta&,
 {
     assert(client_state_->transaction().active() == false);
     assert(client_state_->toi_meta().seqno().is_undefined() == false);
+    ++toi_applied_;
     return (fail_next_toi_ ? 1 : 0);
 }
 
@@ -38,6 +38,7 @@ namespace wsrep
             , do_2pc_()
             , fail_next_applying_()
             , fail_next_toi_()
+            , toi_applied_()
             , client_state_(client_state)
             , replaying_(replaying)
             , nbo_cs_()
@@ -92,6 +93,7 @@ namespace wsrep
         bool do_2pc_;
         bool fail_next_applying_;
         bool fail_next_toi_;
+        size_t toi_applied_;
 
         wsrep::mock_client* nbo_cs() const { return nbo_cs_.get(); }
 
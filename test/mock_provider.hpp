@@ -27,6 +27,8 @@
 
 #include <cstring>
 #include <map>
+#include <string>
+#include <vector>
 #include <iostream> // todo: proper logging
 
 #include <boost/test/unit_test.hpp>
@@ -45,6 +47,8 @@ namespace wsrep
             , commit_order_leave_result_()
             , release_result_()
             , replay_result_()
+            , options_result_()
+            , options_calls_()
             , group_id_("1")
             , server_id_("1")
             , group_seqno_(0)
@@ -56,6 +60,11 @@ namespace wsrep
             , toi_write_sets_()
             , toi_start_transaction_()
             , toi_commit_()
+            , toi_leaves_()
+            , toi_leave_error_()
+            , keys_()
+            , nocopy_keys_()
+            , nocopy_data_()
         { }
 
         enum wsrep::provider::status
@@ -149,11 +158,28 @@ namespace wsrep
         { return wsrep::provider::success; }
         int append_key(wsrep::ws_handle&, const wsrep::key&)
             WSREP_OVERRIDE
-        { return 0; }
+        {
+            ++keys_;
+            return 0;
+        }
         enum wsrep::provider::status
         append_data(wsrep::ws_handle&, const wsrep::const_buffer&)
             WSREP_OVERRIDE
         { return wsrep::provider::success; }
+        int append_key_nocopy(wsrep::ws_handle&, const wsrep::key&)
+            WSREP_OVERRIDE
+        {
+            ++keys_;
+            ++nocopy_keys_;
+            return 0;
+        }
+        enum wsrep::provider::status
+        append_data_nocopy(wsrep::ws_handle&, const wsrep::const_buffer&)
+            WSREP_OVERRIDE
+        {
+            ++nocopy_data_;
+            return wsrep::provider::success;
+        }
         enum wsrep::provider::status rollback(const wsrep::transaction_id)
         WSREP_OVERRIDE
         {
@@ -257,9 +283,13 @@ namespace wsrep
 
         enum wsrep::provider::status leave_toi(wsrep::client_id,
                                                const wsrep::ws_meta&,
-                                               const wsrep::mutable_buffer&)
+                                               const wsrep::mutable_buffer& err)
             WSREP_OVERRIDE
-        { return wsrep::provider::success; }
+        {
+            ++toi_leaves_;
+            toi_leave_error_ = (err.size() > 0);
+            return wsrep::provider::success;
+        }
 
         std::pair<wsrep::gtid, enum wsrep::provider::status>
         causal_read(int) const WSREP_OVERRIDE
@@ -289,9 +319,12 @@ namespace wsrep
         }
         void reset_status() WSREP_OVERRIDE { }
         std::string options() const WSREP_OVERRIDE { return ""; }
-        enum wsrep::provider::status options(const std::string&)
+        enum wsrep::provider::status options(const std::string& opts)
             WSREP_OVERRIDE
-        { return wsrep::provider::success; }
+        {
+            options_calls_.push_back(opts);
+            return options_result_;
+        }
         enum status set_node_isolation(enum node_isolation) WSREP_OVERRIDE {
           return error_not_implemented;
         }
@@ -331,6 +364,9 @@ namespace wsrep
         enum wsrep::provider::status commit_order_leave_result_;
         enum wsrep::provider::status release_result_;
         enum wsrep::provider::status replay_result_;
+        enum wsrep::provider::status options_result_;
+        /** Option strings passed to options(). */
+        std::vector<std::string> options_calls_;
 
         size_t start_fragments() const { return start_fragments_; }
         size_t fragments() const { return fragments_; }
@@ -339,6 +375,11 @@ namespace wsrep
         size_t toi_write_sets() const { return toi_write_sets_; }
         size_t toi_start_transaction() const { return toi_start_transaction_; }
         size_t toi_commit() const { return toi_commit_; }
+        size_t toi_leaves() const { return toi_leaves_; }
+        bool toi_leave_error() const { return toi_leave_error_; }
+        size_t keys() const { return keys_; }
+        size_t nocopy_keys() const { return nocopy_keys_; }
+        size_t nocopy_data() const { return nocopy_data_; }
     private:
         wsrep::id group_id_;
         wsrep::id server_id_;
@@ -351,6 +392,11 @@ namespace wsrep
         size_t toi_write_sets_;
         size_t toi_start_transaction_;
         size_t toi_commit_;
+        size_t toi_leaves_;
+        bool toi_leave_error_;
+        size_t keys_;
+        size_t nocopy_keys_;
+        size_t nocopy_data_;
     };
 }
 
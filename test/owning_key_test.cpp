@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/owning_key.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <string>
+
+namespace
+{
+    bool part_equal(const wsrep::key& key, size_t i, const std::string& str)
+    {
+        return (key.key_parts()[i].size() == str.size() &&
+                std::memcmp(key.key_parts()[i].data(), str.data(),
+                            str.size()) == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(owning_key_inline)
+{
+    wsrep::owning_key okey(wsrep::key::exclusive);
+    {
+        std::string p1("db"), p2("table"), p3("row");
+        okey.append_key_part(p1.data(), p1.size());
+        okey.append_key_part(p2.data(), p2.size());
+        okey.append_key_part(p3.data(), p3.size());
+        // Overwrite source data to verify that it was copied
+        p1.assign(p1.size(), 'x');
+        p2.assign(p2.size(), 'x');
+        p3.assign(p3.size(), 'x');
+    }
+    wsrep::key key(okey.key());
+    BOOST_REQUIRE(key.type() == wsrep::key::exclusive);
+    BOOST_REQUIRE(key.size() == 3);
+    BOOST_REQUIRE(part_equal(key, 0, "db"));
+    BOOST_REQUIRE(part_equal(key, 1, "table"));
+    BOOST_REQUIRE(part_equal(key, 2, "row"));
+}
+
+BOOST_AUTO_TEST_CASE(owning_key_heap)
+{
+    const std::string p1("db");
+    const std::string p2(wsrep::owning_key::inline_capacity, 't');
+    const std::string p3(100, 'r');
+    wsrep::owning_key okey(wsrep::key::shared);
+    okey.append_key_part(p1.data(), p1.size());
+    okey.append_key_part(p2.data(), p2.size());
+    okey.append_key_part(p3.data(), p3.size());
+    wsrep::owning_key copy(okey);
+    wsrep::key key(copy.key());
+    BOOST_REQUIRE(key.size() == 3);
+    BOOST_REQUIRE(part_equal(key, 0, p1));
+    BOOST_REQUIRE(part_equal(key, 1, p2));
+    BOOST_REQUIRE(part_equal(key, 2, p3));
+    BOOST_REQUIRE(key.hash() == okey.key().hash());
+}
+
+BOOST_AUTO_TEST_CASE(owning_key_arena)
+{
+    wsrep::key_arena arena(128);
+    const std::string p1("db");
+    const std::string p2(100, 't');
+    const std::string p3(1000, 'r');
+    wsrep::owning_key okey(wsrep::key::update, &arena);
+    okey.append_key_part(p1.data(), p1.size());
+    okey.append_key_part(p2.data(), p2.size());
+    okey.append_key_part(p3.data(), p3.size());
+    okey.hash(1);
+    wsrep::key key(okey.key());
+    BOOST_REQUIRE(part_equal(key, 0, p1));
+    BOOST_REQUIRE(part_equal(key, 1, p2));
+    BOOST_REQUIRE(part_equal(key, 2, p3));
+    BOOST_REQUIRE(key.hash() == 1);
+    arena.clear();
+    BOOST_REQUIRE(arena.allocate(16) != 0);
+}
+
+BOOST_AUTO_TEST_CASE(owning_key_too_many_parts)
+{
+    wsrep::owning_key okey(wsrep::key::shared);
+    okey.append_key_part("a", 1);
+    okey.append_key_part("b", 1);
+    okey.append_key_part("c", 1);
+    BOOST_REQUIRE_THROW(okey.append_key_part("d", 1), wsrep::runtime_error);
+}
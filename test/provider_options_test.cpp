@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/provider_options.hpp"
+
+#include "mock_server_state.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+    typedef wsrep::provider_options po;
+
+    std::unique_ptr<po::option_value> string_value(const std::string& val)
+    {
+        return std::unique_ptr<po::option_value>(
+            new po::option_value_string(val));
+    }
+
+    std::unique_ptr<po::option_value> int_value(int64_t val)
+    {
+        return std::unique_ptr<po::option_value>(new po::option_value_int(val));
+    }
+
+    std::unique_ptr<po::option_value> bool_value(bool val)
+    {
+        return std::unique_ptr<po::option_value>(new po::option_value_bool(val));
+    }
+
+    std::unique_ptr<po::option_value> double_value(double val)
+    {
+        return std::unique_ptr<po::option_value>(
+            new po::option_value_double(val));
+    }
+
+    struct provider_options_fixture
+    {
+        provider_options_fixture()
+            : server_service(&server_state)
+            , server_state("s1", wsrep::server_state::rm_sync, server_service)
+            , provider(server_state.provider())
+            , options(provider)
+        {
+            options.set_default("gcs.fc_limit", int_value(16), int_value(16),
+                                po::flag::type_integer);
+            options.set_default("gcs.fc_master_slave", bool_value(false),
+                                bool_value(false), po::flag::type_bool);
+            options.set_default("gcs.fc_factor", double_value(1.0),
+                                double_value(1.0), po::flag::type_double);
+            options.set_default("base_dir", string_value("/tmp"),
+                                string_value("/tmp"), 0);
+        }
+        wsrep::mock_server_service server_service;
+        wsrep::mock_server_state server_state;
+        wsrep::mock_provider& provider;
+        wsrep::provider_options options;
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE(provider_options_handle_resolve,
+                        provider_options_fixture)
+{
+    po::option_handle<int64_t> fc_limit;
+    BOOST_REQUIRE(not fc_limit.valid());
+    BOOST_REQUIRE(options.get_handle("gcs_fc_limit", fc_limit) ==
+                  wsrep::provider::success);
+    BOOST_REQUIRE(fc_limit.valid());
+    BOOST_REQUIRE(fc_limit.get() == 16);
+
+    po::option_handle<bool> master_slave;
+    BOOST_REQUIRE(options.get_handle("gcs_fc_master_slave", master_slave) ==
+                  wsrep::provider::success);
+    BOOST_REQUIRE(master_slave.get() == false);
+
+    po::option_handle<double> factor;
+    BOOST_REQUIRE(options.get_handle("gcs_fc_factor", factor) ==
+                  wsrep::provider::success);
+    BOOST_REQUIRE(factor.get() == 1.0);
+
+    // Type mismatch and unknown option
+    po::option_handle<bool> wrong_type;
+    BOOST_REQUIRE(options.get_handle("gcs_fc_limit", wrong_type) ==
+                  wsrep::provider::error_not_allowed);
+    BOOST_REQUIRE(not wrong_type.valid());
+    BOOST_REQUIRE(options.get_handle("base_dir", fc_limit) ==
+                  wsrep::provider::error_not_allowed);
+    BOOST_REQUIRE(options.get_handle("no_such_option", fc_limit) ==
+                  wsrep::provider::error_warning);
+}
+
+BOOST_FIXTURE_TEST_CASE(provider_options_handle_update,
+                        provider_options_fixture)
+{
+    po::option_handle<int64_t> fc_limit;
+    po::option_handle<bool> master_slave;
+    po::option_handle<double> factor;
+    options.get_handle("gcs_fc_limit", fc_limit);
+    options.get_handle("gcs_fc_master_slave", master_slave);
+    options.get_handle("gcs_fc_factor", factor);
+
+    BOOST_REQUIRE(options.set("gcs_fc_limit", int_value(64)) ==
+                  wsrep::provider::success);
+    BOOST_REQUIRE(fc_limit.get() == 64);
+    BOOST_REQUIRE(provider.options_calls_.back() == "gcs.fc_limit=64;");
+
+    // String values are parsed according to option type.
+    options.set("gcs_fc_limit", string_value("128"));
+    BOOST_REQUIRE(fc_limit.get() == 128);
+    options.set("gcs_fc_master_slave", string_value("ON"));
+    BOOST_REQUIRE(master_slave.get() == true);
+    options.set("gcs_fc_factor", double_value(0.000001));
+    BOOST_REQUIRE(factor.get() == 0.000001);
+
+    // Unparseable value keeps the previous value.
+    options.set("gcs_fc_limit", string_value("many"));
+    BOOST_REQUIRE(fc_limit.get() == 128);
+
+    // Failed set does not change the value.
+    provider.options_result_ = wsrep::provider::error_warning;
+    BOOST_REQUIRE(options.set("gcs_fc_limit", int_value(1)) ==
+                  wsrep::provider::error_warning);
+    BOOST_REQUIRE(fc_limit.get() == 128);
+}
+
+BOOST_FIXTURE_TEST_CASE(provider_options_batched_set,
+                        provider_options_fixture)
+{
+    po::option_handle<int64_t> fc_limit;
+    po::option_handle<double> factor;
+    options.get_handle("gcs_fc_limit", fc_limit);
+    options.get_handle("gcs_fc_factor", factor);
+
+    po::option_values values;
+    values.push_back(std::make_pair("gcs_fc_limit", int_value(32)));
+    values.push_back(std::make_pair("gcs_fc_factor", double_value(0.5)));
+    values.push_back(std::make_pair("base_dir", string_value("/var")));
+    BOOST_REQUIRE(options.set(std::move(values)) == wsrep::provider::success);
+    BOOST_REQUIRE(provider.options_calls_.size() == 1);
+    BOOST_REQUIRE(provider.options_calls_[0] ==
+                  "gcs.fc_limit=32;gcs.fc_factor=0.500000;base_dir=/var;");
+    BOOST_REQUIRE(fc_limit.get() == 32);
+    BOOST_REQUIRE(factor.get() == 0.5);
+    BOOST_REQUIRE(std::string(
+                      options.get_option("base_dir")->value()->as_string())
+                  == "/var");
+
+    // Unknown option fails the whole batch without calling provider.
+    values.clear();
+    values.push_back(std::make_pair("gcs_fc_limit", int_value(48)));
+    values.push_back(std::make_pair("no_such_option", int_value(1)));
+    BOOST_REQUIRE(options.set(std::move(values)) ==
+                  wsrep::provider::error_warning);
+    BOOST_REQUIRE(provider.options_calls_.size() == 1);
+    BOOST_REQUIRE(fc_limit.get() == 32);
+
+    // Provider failure does not update values.
+    provider.options_result_ = wsrep::provider::error_warning;
+    values.clear();
+    values.push_back(std::make_pair("gcs_fc_limit", int_value(48)));
+    BOOST_REQUIRE(options.set(std::move(values)) ==
+                  wsrep::provider::error_warning);
+    BOOST_REQUIRE(provider.options_calls_.size() == 2);
+    BOOST_REQUIRE(fc_limit.get() == 32);
+}
+
+BOOST_FIXTURE_TEST_CASE(provider_options_handle_outlives_options,
+                        provider_options_fixture)
+{
+    po::option_handle<int64_t> fc_limit;
+    {
+        wsrep::provider_options tmp(provider);
+        tmp.set_default("gcs.fc_limit", int_value(5), int_value(5),
+                        po::flag::type_integer);
+        tmp.get_handle("gcs_fc_limit", fc_limit);
+    }
+    BOOST_REQUIRE(fc_limit.get() == 5);
+}
@@ -18,9 +18,12 @@
  */
 
 #include "mock_server_state.hpp"
+#include "wsrep/ws_capture.hpp"
 
 #include <boost/test/unit_test.hpp>
 
+#include <cstdio> // std::remove()
+
 namespace
 {
     struct server_fixture_base
@@ -240,6 +243,28 @@ BOOST_FIXTURE_TEST_CASE(server_state_applying_1pc,
         "Transaction state " << txc.state() << " not committed");
 }
 
+// Test that on_apply() records write set into capture
+BOOST_FIXTURE_TEST_CASE(server_state_applying_capture,
+                        applying_server_fixture)
+{
+    const char* const path("server_state_applying_capture.bin");
+    char buf[1] = { 1 };
+    {
+        wsrep::ws_capture capture(path);
+        ss.set_ws_capture(&capture);
+        BOOST_REQUIRE(ss.on_apply(hps, ws_handle, ws_meta,
+                                  wsrep::const_buffer(buf, 1)) == 0);
+        ss.set_ws_capture(0);
+    }
+    wsrep::ws_capture_reader reader(path);
+    wsrep::ws_capture_reader::record rec;
+    BOOST_REQUIRE(reader.read(rec) == 1);
+    BOOST_REQUIRE(rec.ws_meta == ws_meta);
+    BOOST_REQUIRE(rec.data.size() == 1 && rec.data[0] == 1);
+    BOOST_REQUIRE(reader.read(rec) == 0);
+    std::remove(path);
+}
+
 // Test on_apply() method for 2pc
 BOOST_FIXTURE_TEST_CASE(server_state_applying_2pc,
                         applying_server_fixture)
@@ -386,6 +411,30 @@ BOOST_FIXTURE_TEST_CASE(server_state_sst_first_join_with_ist,
     BOOST_REQUIRE(ss.state() == wsrep::server_state::s_synced);
 }
 
+// View snapshot follows view changes. Snapshots taken earlier remain
+// unchanged.
+BOOST_FIXTURE_TEST_CASE(server_state_view_snapshot,
+                        sst_first_server_fixture)
+{
+    std::shared_ptr<const wsrep::view> initial(ss.view_snapshot());
+    BOOST_REQUIRE(initial->status() == wsrep::view::disconnected);
+    connect_in_view(second_view);
+    server_service.logged_view(second_view);
+    sst_received_action();
+    ss.on_view(second_view, &hps);
+    clear_sync_point_action();
+    std::shared_ptr<const wsrep::view> second(ss.view_snapshot());
+    BOOST_REQUIRE(second->view_seqno() == second_view.view_seqno());
+    BOOST_REQUIRE(second->members().size() == 2);
+    ss.on_view(third_view, &hps);
+    std::shared_ptr<const wsrep::view> third(ss.view_snapshot());
+    BOOST_REQUIRE(third->view_seqno() == third_view.view_seqno());
+    BOOST_REQUIRE(third->members().size() == 3);
+    BOOST_REQUIRE(second->members().size() == 2);
+    BOOST_REQUIRE(initial->status() == wsrep::view::disconnected);
+    BOOST_REQUIRE(ss.state() == wsrep::server_state::s_joined);
+}
+
 
 // Cycle from synced state to disconnected and back to synced. Server
 // storage engines remain initialized.
@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/tls_service.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    struct socket_stream : wsrep::tls_stream
+    {
+        explicit socket_stream(int fd_arg) : fd(fd_arg) { }
+        int fd;
+    };
+
+    // Plain socket transport implementing only the single buffer
+    // operations. Transfers are limited to max_transfer bytes per
+    // call to simulate short reads and writes.
+    class socket_tls_service : public wsrep::tls_service
+    {
+    public:
+        socket_tls_service()
+            : max_transfer(0)
+            , reads(0)
+            , writes(0)
+        { }
+        wsrep::tls_stream* create_tls_stream(int fd)
+            WSREP_NOEXCEPT WSREP_OVERRIDE
+        {
+            return new socket_stream(fd);
+        }
+        void destroy(wsrep::tls_stream* stream) WSREP_NOEXCEPT WSREP_OVERRIDE
+        {
+            delete static_cast<socket_stream*>(stream);
+        }
+        int get_error_number(const wsrep::tls_stream*)
+            const WSREP_NOEXCEPT WSREP_OVERRIDE
+        {
+            return 0;
+        }
+        const void* get_error_category(const wsrep::tls_stream*)
+            const WSREP_NOEXCEPT WSREP_OVERRIDE
+        {
+            return 0;
+        }
+        const char* get_error_message(const wsrep::tls_stream*,
+                                      int, const void*)
+            const WSREP_NOEXCEPT WSREP_OVERRIDE
+        {
+            return "";
+        }
+        status client_handshake(wsrep::tls_stream*)
+            WSREP_NOEXCEPT WSREP_OVERRIDE
+        {
+            return success;
+        }
+        status server_handshake(wsrep::tls_stream*)
+            WSREP_NOEXCEPT WSREP_OVERRIDE
+        {
+            return success;
+        }
+        op_result read(wsrep::tls_stream* stream, void* buf, size_t max_count)
+            WSREP_NOEXCEPT WSREP_OVERRIDE
+        {
+            ++reads;
+            if (max_transfer) max_count = std::min(max_count, max_transfer);
+            return map_result(
+                ::read(static_cast<socket_stream*>(stream)->fd,
+                       buf, max_count));
+        }
+        op_result write(wsrep::tls_stream* stream,
+                        const void* buf, size_t count)
+            WSREP_NOEXCEPT WSREP_OVERRIDE
+        {
+            ++writes;
+            if (max_transfer) count = std::min(count, max_transfer);
+            return map_result(
+                ::send(static_cast<socket_stream*>(stream)->fd,
+                       buf, count, MSG_NOSIGNAL));
+        }
+        status shutdown(wsrep::tls_stream*) WSREP_NOEXCEPT WSREP_OVERRIDE
+        {
+            return success;
+        }
+
+        size_t max_transfer;
+        size_t reads;
+        size_t writes;
+    protected:
+        static op_result map_result(ssize_t result)
+        {
+            if (result > 0)
+            {
+                op_result ret = { success, size_t(result) };
+                return ret;
+            }
+            op_result ret = { result == 0 ? eof : error, 0 };
+            return ret;
+        }
+    };
+
+    // Socket transport which scatters and gathers with the system calls.
+    class vector_socket_tls_service : public socket_tls_service
+    {
+    public:
+        op_result readv(wsrep::tls_stream* stream,
+                        const struct iovec* iov, int iovcnt)
+            WSREP_NOEXCEPT WSREP_OVERRIDE
+        {
+            ++reads;
+            return map_result(
+                ::readv(static_cast<socket_stream*>(stream)->fd, iov, iovcnt));
+        }
+        op_result writev(wsrep::tls_stream* stream,
+                         const struct iovec* iov, int iovcnt)
+            WSREP_NOEXCEPT WSREP_OVERRIDE
+        {
+            ++writes;
+            struct msghdr msg;
+            std::memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = const_cast<struct iovec*>(iov);
+            msg.msg_iovlen = size_t(iovcnt);
+            return map_result(
+                ::sendmsg(static_cast<socket_stream*>(stream)->fd,
+                          &msg, MSG_NOSIGNAL));
+        }
+    };
+
+    struct socketpair_fixture
+    {
+        socketpair_fixture()
+            : service()
+            , fds()
+            , writer()
+            , reader()
+        {
+            BOOST_REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+            writer = service.create_tls_stream(fds[0]);
+            reader = service.create_tls_stream(fds[1]);
+        }
+        ~socketpair_fixture()
+        {
+            service.destroy(writer);
+            service.destroy(reader);
+            ::close(fds[0]);
+            ::close(fds[1]);
+        }
+        socket_tls_service service;
+        int fds[2];
+        wsrep::tls_stream* writer;
+        wsrep::tls_stream* reader;
+    };
+
+    struct iovec make_iovec(const void* buf, size_t len)
+    {
+        struct iovec ret;
+        ret.iov_base = const_cast<void*>(buf);
+        ret.iov_len = len;
+        return ret;
+    }
+
+    // Write header and payload n times through service and read them
+    // on a separate thread. Returns throughput in MB/s.
+    double transfer(wsrep::tls_service& service, size_t header_size,
+                    size_t payload_size, size_t n)
+    {
+        int fds[2];
+        BOOST_REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        wsrep::tls_stream* writer(service.create_tls_stream(fds[0]));
+        wsrep::tls_stream* reader(service.create_tls_stream(fds[1]));
+        const size_t total((header_size + payload_size) * n);
+        size_t received(0);
+        std::thread reader_thread(
+            [&service, reader, total, &received]()
+            {
+                std::vector<char> buf(1 << 16);
+                struct iovec iov[2] = {
+                    make_iovec(buf.data(), buf.size() / 2),
+                    make_iovec(buf.data() + buf.size() / 2, buf.size() / 2)
+                };
+                while (received < total)
+                {
+                    auto result(service.readv(reader, iov, 2));
+                    if (result.status != wsrep::tls_service::success) break;
+                    received += result.bytes_transferred;
+                }
+            });
+        std::vector<char> header(header_size, 'h');
+        std::vector<char> payload(payload_size, 'p');
+        auto start(std::chrono::steady_clock::now());
+        for (size_t i(0); i < n; ++i)
+        {
+            struct iovec iov[2] = {
+                make_iovec(header.data(), header.size()),
+                make_iovec(payload.data(), payload.size())
+            };
+            struct iovec* pos(iov);
+            int cnt(2);
+            while (cnt > 0)
+            {
+                auto result(service.writev(writer, pos, cnt));
+                BOOST_REQUIRE(result.status == wsrep::tls_service::success);
+                size_t written(result.bytes_transferred);
+                while (cnt > 0 && written >= pos->iov_len)
+                {
+                    written -= pos->iov_len;
+                    ++pos;
+                    --cnt;
+                }
+                if (cnt > 0)
+                {
+                    pos->iov_base = static_cast<char*>(pos->iov_base) + written;
+                    pos->iov_len -= written;
+                }
+            }
+        }
+        reader_thread.join();
+        auto stop(std::chrono::steady_clock::now());
+        BOOST_REQUIRE(received == total);
+        service.destroy(writer);
+        service.destroy(reader);
+        ::close(fds[0]);
+        ::close(fds[1]);
+        const double secs(std::chrono::duration<double>(stop - start).count());
+        return double(total) / (1 << 20) / secs;
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(tls_service_writev_readv_fallback, socketpair_fixture)
+{
+    const std::string header("header:");
+    const std::string payload("payload");
+    struct iovec out[3] = {
+        make_iovec(header.data(), header.size()),
+        make_iovec(0, 0),
+        make_iovec(payload.data(), payload.size())
+    };
+    auto result(service.writev(writer, out, 3));
+    BOOST_REQUIRE(result.status == wsrep::tls_service::success);
+    BOOST_REQUIRE(result.bytes_transferred == header.size() + payload.size());
+    BOOST_REQUIRE(service.writes == 2);
+
+    // The fallback reads into the first non-empty buffer only.
+    char buf1[4];
+    char buf2[32];
+    struct iovec in[3] = {
+        make_iovec(0, 0),
+        make_iovec(buf1, sizeof(buf1)),
+        make_iovec(buf2, sizeof(buf2))
+    };
+    result = service.readv(reader, in, 3);
+    BOOST_REQUIRE(result.status == wsrep::tls_service::success);
+    BOOST_REQUIRE(result.bytes_transferred == sizeof(buf1));
+    BOOST_REQUIRE(std::string(buf1, sizeof(buf1)) == "head");
+    result = service.readv(reader, in + 2, 1);
+    BOOST_REQUIRE(result.status == wsrep::tls_service::success);
+    BOOST_REQUIRE(std::string(buf2, result.bytes_transferred) == "er:payload");
+}
+
+BOOST_FIXTURE_TEST_CASE(tls_service_writev_fallback_short_write,
+                        socketpair_fixture)
+{
+    service.max_transfer = 3;
+    const std::string header("abcde");
+    const std::string payload("fgh");
+    struct iovec out[2] = {
+        make_iovec(header.data(), header.size()),
+        make_iovec(payload.data(), payload.size())
+    };
+    auto result(service.writev(writer, out, 2));
+    BOOST_REQUIRE(result.status == wsrep::tls_service::success);
+    BOOST_REQUIRE(result.bytes_transferred == 3);
+    BOOST_REQUIRE(service.writes == 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(tls_service_writev_fallback_eof, socketpair_fixture)
+{
+    const std::string header("abc");
+    const std::string payload("def");
+    struct iovec out[2] = {
+        make_iovec(header.data(), header.size()),
+        make_iovec(payload.data(), payload.size())
+    };
+    ::shutdown(fds[0], SHUT_WR);
+    auto result(service.writev(writer, out, 2));
+    BOOST_REQUIRE(result.status == wsrep::tls_service::error);
+    BOOST_REQUIRE(result.bytes_transferred == 0);
+    BOOST_REQUIRE(service.writes == 1);
+}
+
+BOOST_AUTO_TEST_CASE(tls_service_vectored_throughput)
+{
+    const size_t header_size(64);
+    const size_t payload_size(4096);
+    const size_t n(4096);
+    socket_tls_service fallback;
+    vector_socket_tls_service vectored;
+    const double fallback_rate(
+        transfer(fallback, header_size, payload_size, n));
+    const double vectored_rate(
+        transfer(vectored, header_size, payload_size, n));
+    BOOST_TEST_MESSAGE("Throughput with " << header_size << " byte header and "
+                       << payload_size << " byte payload: fallback "
+                       << fallback_rate << " MB/s, " << fallback.writes
+                       << " writes, vectored " << vectored_rate << " MB/s, "
+                       << vectored.writes << " writes");
+    BOOST_REQUIRE(vectored.writes < fallback.writes);
+}
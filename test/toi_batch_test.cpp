@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/toi_batch.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+namespace
+{
+    std::string str(const wsrep::const_buffer& buf)
+    {
+        return std::string(buf.data(), buf.size());
+    }
+
+    wsrep::mutable_buffer error(const std::string& msg)
+    {
+        wsrep::mutable_buffer ret;
+        ret.push_back(msg);
+        return ret;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(toi_batch_parse)
+{
+    wsrep::key shared(wsrep::key::shared);
+    shared.append_key_part("db", 2);
+    wsrep::key exclusive(wsrep::key::exclusive);
+    exclusive.append_key_part("db", 2);
+
+    wsrep::toi_batch batch;
+    BOOST_REQUIRE(batch.empty());
+    batch.add(wsrep::key_array{shared}, wsrep::const_buffer("create t1", 9));
+    batch.add(wsrep::key_array{exclusive}, wsrep::const_buffer("", 0));
+    batch.add(wsrep::key_array{shared}, wsrep::const_buffer("create t3", 9));
+    BOOST_REQUIRE(batch.size() == 3);
+    // Shared key was upgraded to exclusive, later shared key was subsumed.
+    BOOST_REQUIRE(batch.keys().size() == 1);
+    BOOST_REQUIRE(batch.keys()[0].type() == wsrep::key::exclusive);
+
+    BOOST_REQUIRE(wsrep::toi_batch::is_batch(batch.data()));
+    BOOST_REQUIRE(not wsrep::toi_batch::is_batch(
+                      wsrep::const_buffer("create t1", 9)));
+    std::vector<wsrep::const_buffer> statements;
+    BOOST_REQUIRE(wsrep::toi_batch::parse(batch.data(), statements) == 0);
+    BOOST_REQUIRE(statements.size() == 3);
+    BOOST_REQUIRE(str(statements[0]) == "create t1");
+    BOOST_REQUIRE(str(statements[1]) == "");
+    BOOST_REQUIRE(str(statements[2]) == "create t3");
+
+    // Truncated buffer
+    wsrep::const_buffer truncated(batch.data().data(),
+                                  batch.data().size() - 1);
+    BOOST_REQUIRE(wsrep::toi_batch::parse(truncated, statements));
+    BOOST_REQUIRE(statements.empty());
+
+    batch.clear();
+    BOOST_REQUIRE(batch.empty());
+    BOOST_REQUIRE(batch.keys().empty());
+    BOOST_REQUIRE(wsrep::toi_batch::parse(batch.data(), statements) == 0);
+    BOOST_REQUIRE(statements.empty());
+}
+
+BOOST_AUTO_TEST_CASE(toi_batch_errors)
+{
+    std::vector<wsrep::mutable_buffer> errors(3);
+    wsrep::mutable_buffer err;
+    wsrep::toi_batch::encode_errors(errors, err);
+    BOOST_REQUIRE(err.size() == 0);
+
+    errors[1] = error("table exists");
+    wsrep::toi_batch::encode_errors(errors, err);
+    BOOST_REQUIRE(err.size() > 0);
+
+    std::vector<wsrep::mutable_buffer> decoded;
+    BOOST_REQUIRE(wsrep::toi_batch::decode_errors(
+                      wsrep::const_buffer(err.data(), err.size()),
+                      decoded, 3) == 0);
+    BOOST_REQUIRE(decoded.size() == 3);
+    BOOST_REQUIRE(decoded[0].size() == 0);
+    BOOST_REQUIRE(decoded[1] == errors[1]);
+    BOOST_REQUIRE(decoded[2].size() == 0);
+
+    // Statement index out of range
+    BOOST_REQUIRE(wsrep::toi_batch::decode_errors(
+                      wsrep::const_buffer(err.data(), err.size()),
+                      decoded, 1));
+}
@@ -18,8 +18,10 @@
  */
 
 #include "wsrep/client_state.hpp"
+#include "wsrep/toi_batch.hpp"
 
 #include "client_state_fixture.hpp"
+#include "mock_high_priority_service.hpp"
 
 #include <boost/test/unit_test.hpp>
 
@@ -64,3 +66,111 @@ BOOST_FIXTURE_TEST_CASE(test_toi_applying,
     BOOST_REQUIRE(cc.toi_mode() == wsrep::client_state::m_undefined);
     cc.after_applying();
 }
+
+BOOST_FIXTURE_TEST_CASE(test_toi_batch,
+                        replicating_client_fixture_sync_rm)
+{
+    wsrep::key key1(wsrep::key::exclusive);
+    key1.append_key_part("k1", 2);
+    key1.append_key_part("k2", 2);
+    wsrep::key key2(wsrep::key::exclusive);
+    key2.append_key_part("k1", 2);
+    key2.append_key_part("k3", 2);
+    wsrep::toi_batch batch;
+    batch.add(wsrep::key_array{key1}, wsrep::const_buffer("toi1", 4));
+    batch.add(wsrep::key_array{key1, key2}, wsrep::const_buffer("toi2", 4));
+    BOOST_REQUIRE(batch.size() == 2);
+    BOOST_REQUIRE(batch.keys().size() == 2);
+    sc.enable_toi_batching(true);
+    BOOST_REQUIRE(cc.enter_toi_local(batch) == 0);
+    BOOST_REQUIRE(cc.mode() == wsrep::client_state::m_toi);
+    std::vector<wsrep::mutable_buffer> errors(batch.size());
+    BOOST_REQUIRE(cc.leave_toi_local(errors) == 0);
+    BOOST_REQUIRE(cc.mode() == wsrep::client_state::m_local);
+    BOOST_REQUIRE(sc.provider().toi_write_sets() == 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_toi_batch_applying,
+                        applying_client_fixture)
+{
+    wsrep::mock_high_priority_service hps(sc, &cc, false);
+    wsrep::ws_handle ws_handle(wsrep::transaction_id::undefined(), (void*)(1));
+    wsrep::ws_meta ws_meta(wsrep::gtid(wsrep::id("1"), wsrep::seqno(2)),
+                           wsrep::stid(sc.id(),
+                                       wsrep::transaction_id::undefined(),
+                                       cc.id()),
+                           wsrep::seqno(1),
+                           wsrep::provider::flag::start_transaction |
+                           wsrep::provider::flag::commit |
+                           wsrep::provider::flag::isolation);
+    wsrep::key key(wsrep::key::exclusive);
+    key.append_key_part("k1", 2);
+    key.append_key_part("k2", 2);
+    wsrep::toi_batch batch;
+    batch.add(wsrep::key_array{key}, wsrep::const_buffer("toi1", 4));
+    batch.add(wsrep::key_array{key}, wsrep::const_buffer("toi2", 4));
+    batch.add(wsrep::key_array{key}, wsrep::const_buffer("toi3", 4));
+    sc.enable_toi_batching(true);
+    cc.enter_toi_mode(ws_meta);
+    BOOST_REQUIRE(sc.on_apply(hps, ws_handle, ws_meta, batch.data()) == 0);
+    cc.leave_toi_mode();
+    BOOST_REQUIRE(hps.toi_applied_ == 3);
+    cc.after_applying();
+}
+
+BOOST_FIXTURE_TEST_CASE(test_toi_batch_disabled,
+                        replicating_client_fixture_sync_rm)
+{
+    wsrep::key key(wsrep::key::exclusive);
+    key.append_key_part("k1", 2);
+    wsrep::toi_batch batch;
+    batch.add(wsrep::key_array{key}, wsrep::const_buffer("toi1", 4));
+    BOOST_REQUIRE(sc.toi_batching() == false);
+    BOOST_REQUIRE(cc.enter_toi_local(batch) != 0);
+    BOOST_REQUIRE(cc.mode() == wsrep::client_state::m_local);
+    BOOST_REQUIRE(sc.provider().toi_write_sets() == 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_toi_batch_error_count_mismatch,
+                        replicating_client_fixture_sync_rm)
+{
+    wsrep::key key(wsrep::key::exclusive);
+    key.append_key_part("k1", 2);
+    wsrep::toi_batch batch;
+    batch.add(wsrep::key_array{key}, wsrep::const_buffer("toi1", 4));
+    batch.add(wsrep::key_array{key}, wsrep::const_buffer("toi2", 4));
+    sc.enable_toi_batching(true);
+    BOOST_REQUIRE(cc.enter_toi_local(batch) == 0);
+    std::vector<wsrep::mutable_buffer> errors(batch.size() - 1);
+    BOOST_REQUIRE(cc.leave_toi_local(errors) != 0);
+    BOOST_REQUIRE(cc.mode() == wsrep::client_state::m_local);
+    BOOST_REQUIRE(cc.toi_mode() == wsrep::client_state::m_undefined);
+    BOOST_REQUIRE(sc.provider().toi_leaves() == 1);
+    BOOST_REQUIRE(sc.provider().toi_leave_error());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_toi_batch_applying_disabled,
+                        applying_client_fixture)
+{
+    wsrep::mock_high_priority_service hps(sc, &cc, false);
+    wsrep::ws_handle ws_handle(wsrep::transaction_id::undefined(), (void*)(1));
+    wsrep::ws_meta ws_meta(wsrep::gtid(wsrep::id("1"), wsrep::seqno(2)),
+                           wsrep::stid(sc.id(),
+                                       wsrep::transaction_id::undefined(),
+                                       cc.id()),
+                           wsrep::seqno(1),
+                           wsrep::provider::flag::start_transaction |
+                           wsrep::provider::flag::commit |
+                           wsrep::provider::flag::isolation);
+    wsrep::key key(wsrep::key::exclusive);
+    key.append_key_part("k1", 2);
+    wsrep::toi_batch batch;
+    batch.add(wsrep::key_array{key}, wsrep::const_buffer("toi1", 4));
+    batch.add(wsrep::key_array{key}, wsrep::const_buffer("toi2", 4));
+    cc.enter_toi_mode(ws_meta);
+    BOOST_REQUIRE(sc.on_apply(hps, ws_handle, ws_meta, batch.data()) == 0);
+    cc.leave_toi_mode();
+    // Without batching the buffer is passed to apply_toi() as is.
+    BOOST_REQUIRE(hps.toi_applied_ == 1);
+    cc.after_applying();
+}
@@ -54,6 +54,54 @@ BOOST_FIXTURE_TEST_CASE(transaction_append_key_data,
     BOOST_REQUIRE(cc.after_commit() == 0);
     cc.after_statement();
 }
+BOOST_FIXTURE_TEST_CASE(transaction_append_key_duplicate,
+                        replicating_client_fixture_sync_rm)
+{
+    cc.start_transaction(wsrep::transaction_id(1));
+    wsrep::key shared(wsrep::key::shared);
+    shared.append_key_part("a", 1);
+    shared.append_key_part("b", 1);
+    wsrep::key exclusive(wsrep::key::exclusive);
+    exclusive.append_key_part("a", 1);
+    exclusive.append_key_part("b", 1);
+    BOOST_REQUIRE(cc.append_key(shared) == 0);
+    BOOST_REQUIRE(cc.append_key(shared) == 0);
+    BOOST_REQUIRE(sc.provider().keys() == 1);
+    BOOST_REQUIRE(cc.append_key(exclusive) == 0);
+    BOOST_REQUIRE(sc.provider().keys() == 2);
+    BOOST_REQUIRE(cc.append_key(shared) == 0);
+    BOOST_REQUIRE(cc.append_key(exclusive) == 0);
+    BOOST_REQUIRE(sc.provider().keys() == 2);
+    BOOST_REQUIRE(tc.key_filter().duplicate_hits() == 2);
+    BOOST_REQUIRE(tc.key_filter().subsumed_hits() == 1);
+    BOOST_REQUIRE(cc.before_commit() == 0);
+    BOOST_REQUIRE(cc.ordered_commit() == 0);
+    BOOST_REQUIRE(cc.after_commit() == 0);
+    cc.after_statement();
+    BOOST_REQUIRE(tc.key_filter().empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(transaction_append_nocopy,
+                        replicating_client_fixture_sync_rm)
+{
+    cc.start_transaction(wsrep::transaction_id(1));
+    const char parts[] = "ab";
+    const char data[] = "data";
+    wsrep::key key(wsrep::key::exclusive);
+    key.append_key_part(parts, 1);
+    key.append_key_part(parts + 1, 1);
+    BOOST_REQUIRE(cc.append_key_nocopy(key) == 0);
+    BOOST_REQUIRE(cc.append_key_nocopy(key) == 0);
+    BOOST_REQUIRE(sc.provider().nocopy_keys() == 1);
+    BOOST_REQUIRE(cc.append_data_nocopy(
+                      wsrep::const_buffer(data, sizeof(data))) == 0);
+    BOOST_REQUIRE(sc.provider().nocopy_data() == 1);
+    BOOST_REQUIRE(cc.before_commit() == 0);
+    BOOST_REQUIRE(cc.ordered_commit() == 0);
+    BOOST_REQUIRE(cc.after_commit() == 0);
+    cc.after_statement();
+}
+
 //
 // Test a succesful 1PC transaction lifecycle
 //
@@ -1320,6 +1368,29 @@ BOOST_FIXTURE_TEST_CASE(transaction_row_streaming_1pc_commit,
     BOOST_REQUIRE(sc.provider().commit_fragments() == 1);
 }
 
+//
+// Test that keys are appended again for each fragment
+//
+BOOST_FIXTURE_TEST_CASE(transaction_row_streaming_append_key_duplicate,
+                        streaming_client_fixture_row)
+{
+    BOOST_REQUIRE(cc.start_transaction(wsrep::transaction_id(1)) == 0);
+    wsrep::key key(wsrep::key::exclusive);
+    key.append_key_part("a", 1);
+    key.append_key_part("b", 1);
+    BOOST_REQUIRE(cc.append_key(key) == 0);
+    BOOST_REQUIRE(cc.append_key(key) == 0);
+    BOOST_REQUIRE(sc.provider().keys() == 1);
+    BOOST_REQUIRE(cc.after_row() == 0);
+    BOOST_REQUIRE(tc.streaming_context().fragments_certified() == 1);
+    BOOST_REQUIRE(cc.append_key(key) == 0);
+    BOOST_REQUIRE(sc.provider().keys() == 2);
+    BOOST_REQUIRE(cc.before_commit() == 0);
+    BOOST_REQUIRE(cc.ordered_commit() == 0);
+    BOOST_REQUIRE(cc.after_commit() == 0);
+    BOOST_REQUIRE(cc.after_statement() == 0);
+}
+
 //
 // Test 1PC with row streaming with one row
 //
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2025 Codership Oy <info@codership.com>
+ *
+ * This file is part of wsrep-lib.
+ *
+ * Wsrep-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Wsrep-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wsrep-lib.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wsrep/ws_capture.hpp"
+#include "wsrep/exception.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h> // truncate()
+
+namespace
+{
+    const char* const capture_path = "ws_capture_test.bin";
+
+    wsrep::ws_meta make_meta(long long seqno, long long depends_on,
+                             int flags)
+    {
+        return wsrep::ws_meta(
+            wsrep::gtid(wsrep::id("1"), wsrep::seqno(seqno)),
+            wsrep::stid(wsrep::id("s2"),
+                        wsrep::transaction_id(100 + seqno),
+                        wsrep::client_id(7)),
+            wsrep::seqno(depends_on), flags);
+    }
+
+    struct capture_file_fixture
+    {
+        capture_file_fixture() { std::remove(capture_path); }
+        ~capture_file_fixture() { std::remove(capture_path); }
+    };
+
+    bool exception_check(const wsrep::runtime_error&) { return true; }
+}
+
+BOOST_FIXTURE_TEST_CASE(ws_capture_round_trip, capture_file_fixture)
+{
+    const char data[] = "row data";
+    {
+        wsrep::ws_capture capture(capture_path);
+        BOOST_REQUIRE(capture.record(
+                          wsrep::ws_handle(wsrep::transaction_id(1)),
+                          make_meta(5, 3,
+                                    wsrep::provider::flag::start_transaction |
+                                    wsrep::provider::flag::commit),
+                          wsrep::const_buffer(data, sizeof(data))) == 0);
+        BOOST_REQUIRE(capture.record(
+                          wsrep::ws_handle(wsrep::transaction_id(2)),
+                          make_meta(6, 5, wsrep::provider::flag::rollback),
+                          wsrep::const_buffer()) == 0);
+        BOOST_REQUIRE(capture.records() == 2);
+    }
+
+    wsrep::ws_capture_reader reader(capture_path);
+    wsrep::ws_capture_reader::record rec;
+    BOOST_REQUIRE(reader.read(rec) == 1);
+    BOOST_REQUIRE(rec.ws_handle.transaction_id() == wsrep::transaction_id(1));
+    BOOST_REQUIRE(rec.ws_meta ==
+                  make_meta(5, 3, wsrep::provider::flag::start_transaction |
+                            wsrep::provider::flag::commit));
+    BOOST_REQUIRE(rec.data.size() == sizeof(data));
+    BOOST_REQUIRE(std::memcmp(rec.data.data(), data, sizeof(data)) == 0);
+    const std::chrono::nanoseconds first(rec.timestamp);
+
+    BOOST_REQUIRE(reader.read(rec) == 1);
+    BOOST_REQUIRE(rec.ws_handle.transaction_id() == wsrep::transaction_id(2));
+    BOOST_REQUIRE(rec.ws_meta ==
+                  make_meta(6, 5, wsrep::provider::flag::rollback));
+    BOOST_REQUIRE(rec.data.empty());
+    BOOST_REQUIRE(rec.timestamp >= first);
+
+    BOOST_REQUIRE(reader.read(rec) == 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(ws_capture_truncated, capture_file_fixture)
+{
+    const char data[16] = { 0 };
+    {
+        wsrep::ws_capture capture(capture_path);
+        BOOST_REQUIRE(capture.record(
+                          wsrep::ws_handle(wsrep::transaction_id(1)),
+                          make_meta(1, 0, wsrep::provider::flag::commit),
+                          wsrep::const_buffer(data, sizeof(data))) == 0);
+    }
+    FILE* file(std::fopen(capture_path, "r+b"));
+    BOOST_REQUIRE(file);
+    BOOST_REQUIRE(std::fseek(file, 0, SEEK_END) == 0);
+    const long size(std::ftell(file));
+    std::fclose(file);
+    BOOST_REQUIRE(::truncate(capture_path, size - 1) == 0);
+
+    wsrep::ws_capture_reader reader(capture_path);
+    wsrep::ws_capture_reader::record rec;
+    BOOST_REQUIRE(reader.read(rec) < 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(ws_capture_invalid_file, capture_file_fixture)
+{
+    FILE* file(std::fopen(capture_path, "wb"));
+    BOOST_REQUIRE(file);
+    std::fputs("not a capture", file);
+    std::fclose(file);
+    BOOST_REQUIRE_EXCEPTION(wsrep::ws_capture_reader reader(capture_path),
+                            wsrep::runtime_error, exception_check);
+}
@@ -20,6 +20,10 @@
 #include "wsrep/xid.hpp"
 #include <boost/test/unit_test.hpp>
 
+#include <cerrno>
+#include <sstream>
+#include <unordered_set>
+
 BOOST_AUTO_TEST_CASE(xid_test_is_null)
 {
     wsrep::xid null_xid;
@@ -75,6 +79,16 @@ BOOST_AUTO_TEST_CASE(xid_to_string)
     BOOST_REQUIRE(xid_str == "test");
 }
 
+BOOST_AUTO_TEST_CASE(xid_print_to_c_str)
+{
+    char buf[WSREP_LIB_XID_C_STR_LEN];
+    BOOST_REQUIRE(wsrep::print_to_c_str(wsrep::xid(), buf, 0) == 0);
+    wsrep::xid test_xid(1,4,2,"testab");
+    BOOST_REQUIRE(wsrep::print_to_c_str(test_xid, buf, sizeof(buf)) == 6);
+    BOOST_REQUIRE(std::string(buf, 6) == "testab");
+    BOOST_REQUIRE(wsrep::print_to_c_str(test_xid, buf, 5) == -ENOBUFS);
+}
+
 static bool exception_check(const wsrep::runtime_error&)
 {
     return true;
@@ -88,3 +102,38 @@ BOOST_AUTO_TEST_CASE(xid_too_big)
     BOOST_REQUIRE_EXCEPTION(wsrep::xid b(1, 0, 65, s.c_str()),
                             wsrep::runtime_error, exception_check);
 }
+
+BOOST_AUTO_TEST_CASE(xid_copy)
+{
+    std::string s(128, 'a');
+    s[127] = 'b';
+    wsrep::xid a(1, 64, 64, s.c_str());
+    wsrep::xid b(a);
+    BOOST_REQUIRE(a == b);
+    BOOST_REQUIRE(to_string(b) == s);
+    wsrep::xid c;
+    c = a;
+    BOOST_REQUIRE(c == a);
+    // Data beyond gtrid and bqual lengths does not affect comparison.
+    c = wsrep::xid(1, 1, 0, "a");
+    BOOST_REQUIRE(c == wsrep::xid(1, 1, 0, "a"));
+    BOOST_REQUIRE(c.hash() == wsrep::xid(1, 1, 0, "a").hash());
+    c.clear();
+    BOOST_REQUIRE(c == wsrep::xid());
+    BOOST_REQUIRE(c.hash() == wsrep::xid().hash());
+}
+
+BOOST_AUTO_TEST_CASE(xid_hash)
+{
+    std::unordered_set<wsrep::xid> xids;
+    xids.insert(wsrep::xid(1, 1, 1, "ab"));
+    xids.insert(wsrep::xid(1, 2, 0, "ab"));
+    xids.insert(wsrep::xid(2, 1, 1, "ab"));
+    xids.insert(wsrep::xid(1, 1, 1, "ac"));
+    xids.insert(wsrep::xid(1, 1, 1, "ab"));
+    BOOST_REQUIRE(xids.size() == 4);
+    BOOST_REQUIRE(xids.count(wsrep::xid(1, 2, 0, "ab")) == 1);
+    BOOST_REQUIRE(xids.count(wsrep::xid(1, 0, 2, "ab")) == 0);
+    BOOST_REQUIRE(wsrep::xid(1, 1, 1, "ab").hash() !=
+                  wsrep::xid(1, 1, 1, "ac").hash());
+}